@@ -0,0 +1,57 @@
+#include "AllocationCounter.h"
+#include <new>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+// Plain thread_local integers: no constructor, so safe to touch from
+// operator new at any point in a thread's life
+thread_local uint64_t allocations = 0;
+thread_local uint64_t bytes = 0;
+
+void* countedAllocate(size_t size) {
+    allocations++;
+    bytes += size;
+    void* block = malloc(size ? size : 1);
+    if (!block) throw bad_alloc();
+    return block;
+}
+
+void* countedAllocateAligned(size_t size, size_t alignment) {
+    allocations++;
+    bytes += size;
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+    void* block = aligned_alloc(alignment, rounded ? rounded : alignment);
+    if (!block) throw bad_alloc();
+    return block;
+}
+
+}
+
+uint64_t AllocationCounter::getCount() {
+    return allocations;
+}
+
+uint64_t AllocationCounter::getBytes() {
+    return bytes;
+}
+
+// The nothrow forms route through these
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void* operator new(size_t size, align_val_t alignment) {
+    return countedAllocateAligned(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, align_val_t alignment) {
+    return countedAllocateAligned(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+void operator delete(void* block, align_val_t) noexcept { free(block); }
+void operator delete[](void* block, align_val_t) noexcept { free(block); }
+void operator delete(void* block, size_t, align_val_t) noexcept { free(block); }
+void operator delete[](void* block, size_t, align_val_t) noexcept { free(block); }
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+// Counts heap allocations by replacing the global operator new. Only
+// dispatch_bench and dispatch_checks link it; the game keeps the library's.
+// Counts are per thread, so a check around one thread's work isn't disturbed
+// by the others.
+class AllocationCounter {
+public:
+    // This thread, since it started
+    static uint64_t getCount();
+    static uint64_t getBytes();
+
+    // Allocations made by this thread since construction
+    class Scope {
+    public:
+        Scope() : startCount(AllocationCounter::getCount()), startBytes(AllocationCounter::getBytes()) {}
+
+        uint64_t getCount() const { return AllocationCounter::getCount() - startCount; }
+        uint64_t getBytes() const { return AllocationCounter::getBytes() - startBytes; }
+
+    private:
+        uint64_t startCount;
+        uint64_t startBytes;
+    };
+};
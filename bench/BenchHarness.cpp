@@ -0,0 +1,169 @@
+#include "BenchHarness.h"
+#include "AllocationCounter.h"
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+using namespace chrono;
+
+namespace {
+
+double percentile(const vector<double>& sorted, double percent) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(percent / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(rank, sorted.size() - 1)];
+}
+
+// Pulls "key":number out of one of writeJson's lines
+bool jsonNumber(const string& line, const string& key, double& value) {
+    size_t at = line.find("\"" + key + "\":");
+    if (at == string::npos) return false;
+    value = strtod(line.c_str() + at + key.size() + 3, nullptr);
+    return true;
+}
+
+bool jsonString(const string& line, const string& key, string& value) {
+    size_t at = line.find("\"" + key + "\":\"");
+    if (at == string::npos) return false;
+    size_t start = at + key.size() + 4;
+    size_t end = line.find('"', start);
+    if (end == string::npos) return false;
+    value = line.substr(start, end - start);
+    return true;
+}
+
+}
+
+BenchHarness::BenchHarness(const Options& options) : options(options) {}
+
+void BenchHarness::add(const string& name, Op op, Op setup) {
+    if (!options.filter.empty() && name.find(options.filter) == string::npos) return;
+    benchmarks.push_back({name, move(op), move(setup)});
+}
+
+void BenchHarness::list(ostream& out) const {
+    for (const Benchmark& benchmark : benchmarks) out << benchmark.name << "\n";
+}
+
+BenchHarness::Result BenchHarness::measure(const Benchmark& benchmark) const {
+    auto timeBatch = [&](uint64_t batch) {
+        auto start = steady_clock::now();
+        for (uint64_t i = 0; i < batch; i++) benchmark.op();
+        return duration<double>(steady_clock::now() - start).count();
+    };
+
+    // Warmup, which also finds roughly how long one call takes
+    uint64_t warmupCalls = 0;
+    double warmupTime = 0;
+    for (uint64_t batch = 1; warmupTime < options.warmupSeconds; batch *= 2) {
+        if (benchmark.setup) benchmark.setup();
+        warmupTime += timeBatch(batch);
+        warmupCalls += batch;
+    }
+
+    int samples = max(options.samples, 1);
+    double perCall = warmupTime / warmupCalls;
+    double sampleSeconds = options.minSeconds / samples;
+    uint64_t batch = max<uint64_t>(1, static_cast<uint64_t>(sampleSeconds / max(perCall, 1e-9)));
+
+    vector<double> perOpNs;
+    uint64_t allocationsDuring = 0;
+    uint64_t bytesDuring = 0;
+    for (int s = 0; s < samples; s++) {
+        if (benchmark.setup) benchmark.setup();
+        AllocationCounter::Scope counted;
+        double elapsed = timeBatch(batch);
+        allocationsDuring += counted.getCount();
+        bytesDuring += counted.getBytes();
+        perOpNs.push_back(elapsed * 1e9 / batch);
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = batch * samples;
+    double total = 0;
+    for (double ns : perOpNs) total += ns;
+    result.meanNs = total / perOpNs.size();
+    sort(perOpNs.begin(), perOpNs.end());
+    result.p50Ns = percentile(perOpNs, 50);
+    result.p90Ns = percentile(perOpNs, 90);
+    result.p99Ns = percentile(perOpNs, 99);
+    result.minNs = perOpNs.front();
+    result.allocsPerOp = static_cast<double>(allocationsDuring) / result.iterations;
+    result.bytesPerOp = static_cast<double>(bytesDuring) / result.iterations;
+    return result;
+}
+
+void BenchHarness::run(ostream& out) {
+    out << left << setw(44) << "benchmark" << right << setw(12) << "iters" << setw(14) << "p50 ns"
+        << setw(14) << "p99 ns" << setw(12) << "allocs/op" << setw(12) << "bytes/op" << "\n";
+    out << fixed;
+    for (const Benchmark& benchmark : benchmarks) {
+        Result result = measure(benchmark);
+        out << left << setw(44) << result.name << right << setw(12) << result.iterations
+            << setw(14) << setprecision(1) << result.p50Ns << setw(14) << result.p99Ns
+            << setw(12) << setprecision(2) << result.allocsPerOp << setw(12) << setprecision(0)
+            << result.bytesPerOp << "\n" << flush;
+        results.push_back(result);
+    }
+}
+
+bool BenchHarness::writeJson(const string& path) const {
+    ofstream out(path);
+    if (!out) return false;
+
+    out << "{\"format\":\"dispatch-bench-1\",\"benchmarks\":[";
+    char line[512];
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        snprintf(line, sizeof(line),
+                 "{\"name\":\"%s\",\"iterations\":%llu,\"mean_ns\":%.2f,\"p50_ns\":%.2f,\"p90_ns\":%.2f,"
+                 "\"p99_ns\":%.2f,\"min_ns\":%.2f,\"allocs_per_op\":%.4f,\"bytes_per_op\":%.1f}",
+                 r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.meanNs, r.p50Ns,
+                 r.p90Ns, r.p99Ns, r.minNs, r.allocsPerOp, r.bytesPerOp);
+        out << (i ? ",\n" : "\n") << line;
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+bool BenchHarness::compare(const string& baselinePath, ostream& out) const {
+    ifstream in(baselinePath);
+    if (!in) return false;
+
+    map<string, pair<double, double>> baseline; // p50, allocs
+    string line;
+    while (getline(in, line)) {
+        string name;
+        double p50 = 0;
+        double allocs = 0;
+        if (jsonString(line, "name", name) && jsonNumber(line, "p50_ns", p50)) {
+            jsonNumber(line, "allocs_per_op", allocs);
+            baseline[name] = {p50, allocs};
+        }
+    }
+
+    out << left << setw(44) << "benchmark" << right << setw(14) << "base p50" << setw(14) << "p50"
+        << setw(10) << "change" << setw(18) << "allocs/op" << "\n";
+    out << fixed;
+    for (const Result& result : results) {
+        auto it = baseline.find(result.name);
+        if (it == baseline.end()) {
+            out << left << setw(44) << result.name << right << setw(14) << "-" << "\n";
+            continue;
+        }
+        double base = it->second.first;
+        double change = base > 0 ? (result.p50Ns - base) / base * 100.0 : 0.0;
+        char allocs[32];
+        snprintf(allocs, sizeof(allocs), "%.2f -> %.2f", it->second.second, result.allocsPerOp);
+        out << left << setw(44) << result.name << right << setw(14) << setprecision(1) << base
+            << setw(14) << result.p50Ns << setw(9) << showpos << change << noshowpos << "%"
+            << setw(18) << allocs << "\n";
+    }
+    return true;
+}
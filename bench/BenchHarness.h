@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <cstdint>
+
+// Self-contained microbenchmark runner. After a warmup, each benchmark is
+// timed in samples of a calibrated batch of calls, so a sample is well above
+// the clock's resolution; percentiles are over the per-call time of the
+// samples. Heap allocations are those AllocationCounter sees on the calling
+// thread.
+class BenchHarness {
+public:
+    using Op = std::function<void()>;
+
+    struct Options {
+        double warmupSeconds = 0.05;
+        double minSeconds = 0.3; // Measured time per benchmark, across all samples
+        int samples = 50;
+        std::string filter;      // Substring of the names to run
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t iterations = 0;
+        double meanNs = 0;
+        double p50Ns = 0;
+        double p90Ns = 0;
+        double p99Ns = 0;
+        double minNs = 0;
+        double allocsPerOp = 0;
+        double bytesPerOp = 0;
+    };
+
+    explicit BenchHarness(const Options& options);
+
+    // setup runs before every sample, untimed and uncounted
+    void add(const std::string& name, Op op, Op setup = nullptr);
+
+    void run(std::ostream& out); // Prints a table row as each benchmark finishes
+    void list(std::ostream& out) const;
+    const std::vector<Result>& getResults() const { return results; }
+
+    // One benchmark object per line, so files diff and grep cleanly
+    bool writeJson(const std::string& path) const;
+    // p50 and allocations against an earlier writeJson file
+    bool compare(const std::string& baselinePath, std::ostream& out) const;
+
+private:
+    struct Benchmark {
+        std::string name;
+        Op op;
+        Op setup;
+    };
+
+    Options options;
+    std::vector<Benchmark> benchmarks;
+    std::vector<Result> results;
+
+    Result measure(const Benchmark& benchmark) const;
+};
+
+// Keeps a result alive so the optimizer can't drop the call producing it
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
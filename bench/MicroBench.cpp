@@ -0,0 +1,302 @@
+#include "BenchHarness.h"
+#include "../core/PatternGrid.h"
+#include "../core/CommandParser.h"
+#include "../core/MessageSystem.h"
+#include "../roles/Messenger.h"
+#include "../roles/Dispatcher.h"
+#include "../roles/Builder.h"
+#include "../game/DispatchGame.h"
+#include "../game/TurnStateMachine.h"
+#include "../game/TurnPipeline.h"
+#include "../game/BatchEnvironment.h"
+#include "../game/PatternGenerator.h"
+#include "../data/SaveSystem.h"
+#include "../data/Leaderboard.h"
+#include "../utils/EventLoop.h"
+#include "../utils/ScratchArena.h"
+#include "../ui/AsyncInput.h"
+#include <iostream>
+#include <memory>
+#include <filesystem>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+const char* INSTRUCTION = "Row 2 has A A D D and the last row is D C C C, column 3 starts with C";
+
+void addGridBenchmarks(BenchHarness& bench) {
+    PatternGenerator generator(11);
+    for (int size : {4, 8}) {
+        auto target = make_shared<PatternGrid>(generator.generate(size, Difficulty::HARD));
+        auto other = make_shared<PatternGrid>(generator.generate(size, Difficulty::HARD));
+        auto grid = make_shared<PatternGrid>(*target);
+        auto text = make_shared<string>(target->toString());
+        string suffix = "/" + to_string(size);
+
+        auto cell = make_shared<int>(0);
+        bench.add("grid/setCell" + suffix, [grid, cell, size]() {
+            *cell = (*cell + 1) % (size * size);
+            grid->setCell(*cell / size, *cell % size, static_cast<char>('A' + *cell % 4));
+        });
+        bench.add("grid/equals" + suffix, [target, other]() { doNotOptimize(*target == *other); });
+        bench.add("grid/calculateAccuracy" + suffix, [target, other]() {
+            doNotOptimize(target->calculateAccuracy(*other));
+        });
+        bench.add("grid/getDifference" + suffix, [target, other]() { doNotOptimize(target->getDifference(*other)); });
+        bench.add("grid/rotate90" + suffix, [grid]() { grid->rotate90(); });
+        bench.add("grid/toString" + suffix, [target]() { doNotOptimize(target->toString()); });
+        bench.add("grid/fromString" + suffix, [text]() { doNotOptimize(PatternGrid::fromString(*text)); });
+        bench.add("grid/canonicalForm" + suffix, [target]() { doNotOptimize(target->canonicalForm()); });
+    }
+}
+
+void addParserBenchmarks(BenchHarness& bench) {
+    const pair<const char*, const char*> commands[] = {
+        {"set", "SET(2,3)=B"},
+        {"fillRow", "FILL ROW 3 WITH B"},
+        {"replaceAll", "REPLACE ALL A WITH B"},
+        {"invalid", "put a B somewhere near the middle"}
+    };
+    for (const auto& command : commands) {
+        string text = command.second;
+        bench.add(string("parser/") + command.first, [text]() { doNotOptimize(CommandParser::parse(text)); });
+    }
+}
+
+void addMessageBenchmarks(BenchHarness& bench) {
+    const pair<const char*, NoiseLevel> levels[] = {
+        {"low", NoiseLevel::LOW},
+        {"medium", NoiseLevel::MEDIUM},
+        {"high", NoiseLevel::HIGH},
+        {"extreme", NoiseLevel::EXTREME}
+    };
+    for (const auto& level : levels) {
+        auto noise = make_shared<MessageNoiseSimulator>(level.second);
+        auto stream = make_shared<RandomStream>(5);
+        bench.add(string("noise/applyNoise/") + level.first, [noise, stream]() {
+            doNotOptimize(noise->applyNoise(INSTRUCTION, *stream));
+        });
+    }
+
+    // History grows with every message, so each sample starts from an empty one
+    auto messenger = make_shared<Messenger>(make_shared<MessageNoiseSimulator>(NoiseLevel::MEDIUM), 2, true);
+    auto instruction = make_shared<string>(INSTRUCTION); // Built once, as DispatchGame passes it
+    bench.add("messenger/processMessage",
+              [messenger, instruction]() { doNotOptimize(messenger->processMessage(*instruction)); },
+              [messenger]() { messenger->restoreHistory({}, {}); });
+}
+
+void addDispatcherBenchmarks(BenchHarness& bench) {
+    const pair<const char*, Dispatcher::Strategy> strategies[] = {
+        {"rows", Dispatcher::Strategy::ROWS},
+        {"columns", Dispatcher::Strategy::COLUMNS},
+        {"quadrants", Dispatcher::Strategy::QUADRANTS},
+        {"rle", Dispatcher::Strategy::RLE},
+        {"quadtree", Dispatcher::Strategy::QUADTREE},
+        {"rectangles", Dispatcher::Strategy::RECTANGLES},
+        {"patterns", Dispatcher::Strategy::PATTERNS}
+    };
+
+    PatternGenerator generator(13);
+    auto target = make_shared<PatternGrid>(generator.generate(8, Difficulty::HARD));
+
+    // Encodings are cached per dispatcher and across episodes, so each call
+    // builds a fresh dispatcher with an empty global cache
+    bench.add("dispatcher/construct/8", [target]() { Dispatcher dispatcher(*target); doNotOptimize(dispatcher); });
+    for (const auto& strategy : strategies) {
+        Dispatcher::Strategy which = strategy.second;
+        bench.add(string("dispatcher/encode/") + strategy.first + "/8", [target, which]() {
+            Dispatcher::clearGlobalCache();
+            Dispatcher dispatcher(*target);
+            doNotOptimize(dispatcher.getEncoding(which));
+        });
+    }
+}
+
+void addTurnBenchmarks(BenchHarness& bench) {
+    // One headless turn as the pipeline plays it: noise the message, then build.
+    // Histories grow with every turn, so each sample starts from a fresh builder.
+    auto noise = make_shared<MessageNoiseSimulator>(NoiseLevel::MEDIUM);
+    auto stream = make_shared<RandomStream>(23);
+    for (bool logging : {true, false}) {
+        auto builder = make_shared<Builder>(4);
+        builder->setActionLogging(logging);
+        bench.add(logging ? "turn/headless" : "turn/headless/nolog", [noise, stream, builder]() {
+            ScratchArena::Scope scratch;
+            doNotOptimize(builder->executeInstruction(noise->applyNoise("SET(2,3)=B", *stream)));
+        }, [builder]() { builder->reset(); });
+    }
+}
+
+void addEpisodeBenchmarks(BenchHarness& bench) {
+    PatternGenerator generator(17);
+    auto target = make_shared<PatternGrid>(generator.generate(4, Difficulty::NORMAL));
+    auto script = make_shared<vector<string>>(TurnPipeline::scriptFor(*target));
+
+    // A whole game through the event loop: scripted Dispatcher, no console
+    bench.add("episode/headless/normal", [target, script]() {
+        EventLoop loop;
+        ScriptedInput input(loop, *script);
+        DispatchGame game(*target, Difficulty::NORMAL);
+        game.setInteractive(false);
+        TurnStateMachine machine(game, loop, input);
+        machine.start();
+        loop.run();
+        doNotOptimize(game.getAccuracy());
+    });
+
+    auto targets = make_shared<vector<PatternGrid>>();
+    auto scripts = make_shared<vector<vector<string>>>();
+    for (int i = 0; i < 64; i++) {
+        targets->push_back(generator.generate(4, Difficulty::NORMAL));
+        scripts->push_back(TurnPipeline::scriptFor(targets->back()));
+    }
+    auto pipeline = make_shared<TurnPipeline>(Difficulty::NORMAL, 3);
+    bench.add("episode/simulated/x64", [pipeline, targets, scripts]() {
+        doNotOptimize(pipeline->runSequential(*targets, *scripts));
+    });
+}
+
+void addBatchBenchmarks(BenchHarness& bench) {
+    // One step of 1024 headless games; the pool's threads are started once
+    for (int threads : {1, 4}) {
+        auto env = make_shared<BatchEnvironment>(4, Difficulty::NORMAL, 29);
+        env->setThreadCount(threads);
+        auto messages = make_shared<vector<string>>(1024, "FILL ROW 2 WITH B");
+        bench.add("batch/step/1024/threads" + to_string(threads),
+                  [env, messages]() { doNotOptimize(env->step(*messages)); },
+                  [env]() { env->reset(1024); });
+    }
+}
+
+void addLeaderboardBenchmarks(BenchHarness& bench) {
+    // One BatchEnvironment-sized batch per op; 1024 ops ingest 4M results
+    const size_t batchSize = 4096;
+    auto scores = make_shared<vector<int>>(batchSize);
+    auto done = make_shared<vector<uint8_t>>(batchSize, 1);
+    RandomStream stream(31);
+    for (int& score : *scores) {
+        score = stream.getInt(0, 400) + stream.getInt(0, 400);
+    }
+
+    auto leaderboard = make_shared<Leaderboard>();
+    uint32_t player = leaderboard->addPlayer("bench");
+    bench.add("leaderboard/submitBatch/4096", [leaderboard, player, scores, done]() {
+        leaderboard->submitBatch(player, 1, Difficulty::NORMAL, *scores, *done);
+    });
+    auto next = make_shared<size_t>(0);
+    bench.add("leaderboard/submit", [leaderboard, player, scores, next]() {
+        int score = (*scores)[(*next)++ % scores->size()];
+        leaderboard->submit({score, player, 2, Difficulty::HARD, 0});
+    });
+    bench.add("leaderboard/getRank", [leaderboard, scores, next]() {
+        doNotOptimize(leaderboard->getRank((*scores)[(*next)++ % scores->size()]));
+    });
+}
+
+void addSaveBenchmarks(BenchHarness& bench, const string& directory) {
+    SaveSystem::setSaveDirectory(directory);
+
+    PatternGenerator generator(19);
+    auto gameData = make_shared<GameData>();
+    for (int i = 0; i < 100; i++) {
+        GameMetrics metrics{};
+        metrics.accuracy = 40 + i % 60;
+        metrics.turnsTaken = 5 + i % 15;
+        metrics.messagesUsed = metrics.turnsTaken;
+        metrics.timeElapsed = chrono::seconds(30 + i);
+        metrics.score = 300 + i * 7;
+        gameData->addCompletedEpisode(1 + i % 3, metrics);
+    }
+
+    DispatchGame game(generator.generate(4, Difficulty::NORMAL));
+    auto snapshot = make_shared<GameSnapshot>(game.createSnapshot());
+
+    bench.add("save/saveGame", [gameData, snapshot]() {
+        doNotOptimize(SaveSystem::saveGame("bench", *gameData, 1, snapshot.get()));
+    });
+    bench.add("save/loadGame", [snapshot]() {
+        GameData loaded;
+        GameSnapshot restored;
+        int episode = 0;
+        doNotOptimize(SaveSystem::loadGame("bench", loaded, episode, &restored));
+    }, [gameData, snapshot]() { SaveSystem::saveGame("bench", *gameData, 1, snapshot.get()); });
+}
+
+void usage() {
+    cout << "usage: dispatch_bench [--filter text] [--json out.json] [--compare base.json]\n"
+            "                      [--min-time seconds] [--samples n] [--list]\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    BenchHarness::Options options;
+    string jsonPath;
+    string baselinePath;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--compare" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--min-time" && hasValue) {
+            options.minSeconds = atof(argv[++i]);
+        } else if (arg == "--samples" && hasValue) {
+            options.samples = atoi(argv[++i]);
+        } else if (arg == "--list") {
+            listOnly = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    // Saves go to a scratch directory, never the player's
+    filesystem::path saveDirectory = filesystem::temp_directory_path() / "dispatch_bench_saves";
+
+    BenchHarness bench(options);
+    addGridBenchmarks(bench);
+    addParserBenchmarks(bench);
+    addMessageBenchmarks(bench);
+    addDispatcherBenchmarks(bench);
+    addTurnBenchmarks(bench);
+    addEpisodeBenchmarks(bench);
+    addBatchBenchmarks(bench);
+    addLeaderboardBenchmarks(bench);
+    addSaveBenchmarks(bench, saveDirectory.string());
+
+    if (listOnly) {
+        bench.list(cout);
+        return 0;
+    }
+
+    bench.run(cout);
+
+    error_code ignored;
+    filesystem::remove_all(saveDirectory, ignored);
+
+    if (!jsonPath.empty()) {
+        if (!bench.writeJson(jsonPath)) {
+            cerr << "Cannot write " << jsonPath << "\n";
+            return 1;
+        }
+        cout << "\nResults written to " << jsonPath << "\n";
+    }
+    if (!baselinePath.empty()) {
+        cout << "\n";
+        if (!bench.compare(baselinePath, cout)) {
+            cerr << "Cannot read " << baselinePath << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "../game/TurnPipeline.h"
+#include "../game/PatternGenerator.h"
+#include "../utils/Trace.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <functional>
+
+using namespace std;
+using namespace chrono;
+
+namespace {
+    // Best of a few runs, in seconds
+    double timeRun(const function<TurnPipeline::Result()>& run, TurnPipeline::Result& result, int repeats = 3) {
+        double best = 1e30;
+        for (int i = 0; i < repeats; i++) {
+            auto start = steady_clock::now();
+            result = run();
+            best = min(best, duration<double>(steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    bool sameOutcome(const TurnPipeline::Result& a, const TurnPipeline::Result& b) {
+        if (a.turnsPlayed != b.turnsPlayed || a.metrics.size() != b.metrics.size()) return false;
+        for (size_t g = 0; g < a.metrics.size(); g++) {
+            if (a.metrics[g].score != b.metrics[g].score || !(a.grids[g] == b.grids[g])) return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int games = argc > 1 ? atoi(argv[1]) : 5000;
+
+    PatternGenerator generator(42);
+    vector<PatternGrid> targets;
+    vector<vector<string>> scripts;
+    for (int i = 0; i < games; i++) {
+        targets.push_back(generator.generate(4, Difficulty::HARD));
+        scripts.push_back(TurnPipeline::scriptFor(targets.back()));
+    }
+
+    TurnPipeline pipeline(Difficulty::NORMAL, 7);
+    TurnPipeline::Result reference;
+    double sequential = timeRun([&]() { return pipeline.runSequential(targets, scripts); }, reference);
+
+    cout << "games: " << games << "  turns: " << reference.turnsPlayed
+         << "  hardware threads: " << thread::hardware_concurrency() << "\n";
+    cout << left << setw(24) << "mode" << right << setw(14) << "turns/s" << setw(12) << "speedup"
+         << setw(10) << "match" << "\n";
+    cout << left << setw(24) << "sequential" << right << setw(14) << fixed << setprecision(0)
+         << reference.turnsPlayed / sequential << setw(12) << setprecision(2) << 1.0 << setw(10) << "-" << "\n";
+
+    for (int workers : {1, 2, 4}) {
+        pipeline.setMessengerThreads(workers);
+        TurnPipeline::Result result;
+        double elapsed = timeRun([&]() { return pipeline.run(targets, scripts); }, result);
+        cout << left << setw(24) << ("pipeline, " + to_string(workers) + " messenger" + (workers > 1 ? "s" : ""))
+             << right << setw(14) << setprecision(0) << result.turnsPlayed / elapsed
+             << setw(12) << setprecision(2) << sequential / elapsed
+             << setw(10) << (sameOutcome(reference, result) ? "yes" : "NO") << "\n";
+    }
+
+    if (Trace::isCompiledIn()) {
+        Trace::writeChromeJson("pipeline_trace.json");
+        cout << "\n" << Trace::formatSummary();
+    }
+    return 0;
+}
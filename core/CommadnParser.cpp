@@ -1,56 +1,71 @@
 #include "CommandParser.h"
 #include "../utils/Utilities.h"
-#include <sstream>
+#include "../utils/Trace.h"
 #include <algorithm>
 
 using namespace std;
 
 ParsedCommand CommandParser::parse(const string& command) {
-    string upperCmd = Utilities::toUpper(Utilities::trim(command));
+    ParsedCommand cmd;
+    parseInto(command, cmd);
+    return cmd;
+}
+
+void CommandParser::parseInto(const string& command, ParsedCommand& out) {
+    TRACE_SCOPE("CommandParser::parse");
+    ScratchArena::Scope scratch;
+    string_view trimmed = Utilities::trimView(command);
+    ScratchString upper(trimmed.begin(), trimmed.end(), scratch.resource());
+    transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    string_view upperCmd = upper;
     
-    if (upperCmd.find("SET") != string::npos || upperCmd.find("PUT") != string::npos) {
-        return parseSetCommand(upperCmd);
-    } else if (upperCmd.find("FILL ROW") != string::npos) {
-        return parseFillRowCommand(upperCmd);
-    } else if (upperCmd.find("FILL COLUMN") != string::npos || upperCmd.find("FILL COL") != string::npos) {
-        return parseFillColumnCommand(upperCmd);
-    } else if (upperCmd.find("REPLACE") != string::npos) {
-        return parseReplaceCommand(upperCmd);
-    } else if (upperCmd.find("CLEAR") != string::npos) {
-        return parseClearCommand(upperCmd);
+    string raw = move(out.rawCommand); // Its buffer is reused below
+    if (upperCmd.find("SET") != string_view::npos || upperCmd.find("PUT") != string_view::npos) {
+        out = parseSetCommand(upperCmd);
+    } else if (upperCmd.find("FILL ROW") != string_view::npos) {
+        out = parseFillRowCommand(upperCmd);
+    } else if (upperCmd.find("FILL COLUMN") != string_view::npos || upperCmd.find("FILL COL") != string_view::npos) {
+        out = parseFillColumnCommand(upperCmd);
+    } else if (upperCmd.find("REPLACE") != string_view::npos) {
+        out = parseReplaceCommand(upperCmd);
+    } else if (upperCmd.find("CLEAR") != string_view::npos) {
+        out = parseClearCommand(upperCmd);
+    } else {
+        out = ParsedCommand();
+        upperCmd = command; // Unrecognised commands keep their original text
     }
     
-    ParsedCommand invalid;
-    invalid.rawCommand = command;
-    return invalid;
+    raw.assign(upperCmd);
+    out.rawCommand = move(raw);
 }
 
-ParsedCommand CommandParser::parseSetCommand(const string& command) {
+ParsedCommand CommandParser::parseSetCommand(string_view command) {
     ParsedCommand cmd;
-    cmd.rawCommand = command;
     
     // Look for patterns like: SET(1,2)=A or PUT 1,2 A
     size_t setPos = command.find("SET");
     size_t putPos = command.find("PUT");
     
-    if (setPos != string::npos) {
+    if (setPos != string_view::npos) {
         // SET format: SET(row,col)=value
         size_t parenStart = command.find('(', setPos);
         size_t parenEnd = command.find(')', parenStart);
         size_t eqPos = command.find('=', parenEnd);
         
-        if (parenStart != string::npos && parenEnd != string::npos && eqPos != string::npos) {
-            string coordStr = command.substr(parenStart + 1, parenEnd - parenStart - 1);
-            string valueStr = command.substr(eqPos + 1);
+        if (parenStart != string_view::npos && parenEnd != string_view::npos && eqPos != string_view::npos) {
+            string_view coordStr = command.substr(parenStart + 1, parenEnd - parenStart - 1);
+            string_view valueStr = command.substr(eqPos + 1);
             
             if (extractCoordinates(coordStr, cmd.row, cmd.col)) {
                 cmd.value = extractValue(valueStr);
                 cmd.type = ParsedCommand::Type::SET_CELL;
             }
         }
-    } else if (putPos != string::npos) {
+    } else if (putPos != string_view::npos) {
         // PUT format: PUT row,col value
-        vector<string> tokens = tokenize(command);
+        ScratchArena::Scope scratch;
+        ScratchVector<string_view> tokens(scratch.resource());
+        tokenize(command, tokens);
         if (tokens.size() >= 3) {
             if (extractCoordinates(tokens[1], cmd.row, cmd.col)) {
                 cmd.value = extractValue(tokens[2]);
@@ -62,64 +77,61 @@ ParsedCommand CommandParser::parseSetCommand(const string& command) {
     return cmd;
 }
 
-ParsedCommand CommandParser::parseFillRowCommand(const string& command) {
+ParsedCommand CommandParser::parseFillRowCommand(string_view command) {
     ParsedCommand cmd;
-    cmd.rawCommand = command;
     
-    vector<string> tokens = tokenize(command);
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> tokens(scratch.resource());
+    tokenize(command, tokens);
     if (tokens.size() >= 5) { // FILL ROW X WITH Y
         auto rowIt = find(tokens.begin(), tokens.end(), "ROW");
         auto withIt = find(tokens.begin(), tokens.end(), "WITH");
         
-        if (rowIt != tokens.end() && withIt != tokens.end() && withIt > rowIt) {
-            try {
-                cmd.row = stoi(*(rowIt + 1)) - 1; // Convert to 0-based
-                cmd.value = extractValue(*(withIt + 1));
-                cmd.type = ParsedCommand::Type::FILL_ROW;
-            } catch (const exception&) {
-                // Conversion failed
-            }
+        if (rowIt != tokens.end() && withIt != tokens.end() && withIt > rowIt && withIt + 1 != tokens.end() &&
+            Utilities::parseInt(*(rowIt + 1), cmd.row)) {
+            cmd.row -= 1; // Convert to 0-based
+            cmd.value = extractValue(*(withIt + 1));
+            cmd.type = ParsedCommand::Type::FILL_ROW;
         }
     }
     
     return cmd;
 }
 
-ParsedCommand CommandParser::parseFillColumnCommand(const string& command) {
+ParsedCommand CommandParser::parseFillColumnCommand(string_view command) {
     ParsedCommand cmd;
-    cmd.rawCommand = command;
     
-    vector<string> tokens = tokenize(command);
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> tokens(scratch.resource());
+    tokenize(command, tokens);
     if (tokens.size() >= 5) { // FILL COLUMN X WITH Y
         auto colIt = find(tokens.begin(), tokens.end(), "COLUMN");
         if (colIt == tokens.end()) colIt = find(tokens.begin(), tokens.end(), "COL");
         
         auto withIt = find(tokens.begin(), tokens.end(), "WITH");
         
-        if (colIt != tokens.end() && withIt != tokens.end() && withIt > colIt) {
-            try {
-                cmd.col = stoi(*(colIt + 1)) - 1; // Convert to 0-based
-                cmd.value = extractValue(*(withIt + 1));
-                cmd.type = ParsedCommand::Type::FILL_COLUMN;
-            } catch (const exception&) {
-                // Conversion failed
-            }
+        if (colIt != tokens.end() && withIt != tokens.end() && withIt > colIt && withIt + 1 != tokens.end() &&
+            Utilities::parseInt(*(colIt + 1), cmd.col)) {
+            cmd.col -= 1; // Convert to 0-based
+            cmd.value = extractValue(*(withIt + 1));
+            cmd.type = ParsedCommand::Type::FILL_COLUMN;
         }
     }
     
     return cmd;
 }
 
-ParsedCommand CommandParser::parseReplaceCommand(const string& command) {
+ParsedCommand CommandParser::parseReplaceCommand(string_view command) {
     ParsedCommand cmd;
-    cmd.rawCommand = command;
     
-    vector<string> tokens = tokenize(command);
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> tokens(scratch.resource());
+    tokenize(command, tokens);
     if (tokens.size() >= 6) { // REPLACE ALL X WITH Y
         auto allIt = find(tokens.begin(), tokens.end(), "ALL");
         auto withIt = find(tokens.begin(), tokens.end(), "WITH");
         
-        if (allIt != tokens.end() && withIt != tokens.end() && withIt > allIt) {
+        if (allIt != tokens.end() && withIt != tokens.end() && withIt > allIt && withIt + 1 != tokens.end()) {
             cmd.oldValue = extractValue(*(allIt + 1));
             cmd.value = extractValue(*(withIt + 1));
             cmd.type = ParsedCommand::Type::REPLACE_ALL;
@@ -129,9 +141,8 @@ ParsedCommand CommandParser::parseReplaceCommand(const string& command) {
     return cmd;
 }
 
-ParsedCommand CommandParser::parseClearCommand(const string& command) {
+ParsedCommand CommandParser::parseClearCommand(string_view) {
     ParsedCommand cmd;
-    cmd.rawCommand = command;
     cmd.type = ParsedCommand::Type::CLEAR_GRID;
     return cmd;
 }
@@ -168,26 +179,30 @@ Values: A-Z, 0-9, or _ for empty
 )";
 }
 
-vector<string> CommandParser::tokenize(const string& command) {
-    return Utilities::split(command, ' ');
+void CommandParser::tokenize(string_view command, ScratchVector<string_view>& tokens) {
+    Utilities::splitInto(command, ' ', tokens);
 }
 
-bool CommandParser::extractCoordinates(const string& coordStr, int& row, int& col) {
-    string cleanStr = Utilities::replaceAll(coordStr, " ", "");
+bool CommandParser::extractCoordinates(string_view coordStr, int& row, int& col) {
+    ScratchArena::Scope scratch;
+    ScratchString cleanStr(scratch.resource());
+    for (char c : coordStr) {
+        if (c != ' ') cleanStr += c;
+    }
     size_t commaPos = cleanStr.find(',');
     
-    if (commaPos == string::npos) return false;
+    if (commaPos == ScratchString::npos) return false;
     
-    try {
-        row = stoi(cleanStr.substr(0, commaPos)) - 1; // Convert to 0-based
-        col = stoi(cleanStr.substr(commaPos + 1)) - 1;
-        return true;
-    } catch (const exception&) {
+    string_view clean = cleanStr;
+    if (!Utilities::parseInt(clean.substr(0, commaPos), row) || !Utilities::parseInt(clean.substr(commaPos + 1), col)) {
         return false;
     }
+    row -= 1; // Convert to 0-based
+    col -= 1;
+    return true;
 }
 
-char CommandParser::extractValue(const string& valueStr) {
+char CommandParser::extractValue(string_view valueStr) {
     if (valueStr.empty()) return '_';
     
     // Take first character and convert to uppercase
@@ -199,4 +214,4 @@ char CommandParser::extractValue(const string& valueStr) {
     } else {
         return '_';
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include "PatternGrid.h"
+#include "../utils/ScratchArena.h"
 
 struct ParsedCommand {
     enum class Type {
@@ -26,17 +28,20 @@ struct ParsedCommand {
 class CommandParser {
 public:
     static ParsedCommand parse(const std::string& command);
+    // Reuses out's rawCommand buffer, so command must not be that string
+    static void parseInto(const std::string& command, ParsedCommand& out);
     static bool validateCommand(const ParsedCommand& cmd, const PatternGrid& grid);
     static std::string getCommandHelp();
     
 private:
-    static ParsedCommand parseSetCommand(const std::string& command);
-    static ParsedCommand parseFillRowCommand(const std::string& command);
-    static ParsedCommand parseFillColumnCommand(const std::string& command);
-    static ParsedCommand parseReplaceCommand(const std::string& command);
-    static ParsedCommand parseClearCommand(const std::string& command);
+    // Commands arrive trimmed and upper-cased; scratch comes from ScratchArena
+    static ParsedCommand parseSetCommand(std::string_view command);
+    static ParsedCommand parseFillRowCommand(std::string_view command);
+    static ParsedCommand parseFillColumnCommand(std::string_view command);
+    static ParsedCommand parseReplaceCommand(std::string_view command);
+    static ParsedCommand parseClearCommand(std::string_view command);
     
-    static std::vector<std::string> tokenize(const std::string& command);
-    static bool extractCoordinates(const std::string& coordStr, int& row, int& col);
-    static char extractValue(const std::string& valueStr);
+    static void tokenize(std::string_view command, ScratchVector<std::string_view>& tokens);
+    static bool extractCoordinates(std::string_view coordStr, int& row, int& col);
+    static char extractValue(std::string_view valueStr);
 };
\ No newline at end of file
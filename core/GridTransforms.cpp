@@ -0,0 +1,191 @@
+#include "GridTransforms.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+#if defined(__SSE2__)
+    // Transposes 8 rows of 8 bytes held in the low halves of r[0..7]
+    void transpose8x8(__m128i r[8]) {
+        __m128i t0 = _mm_unpacklo_epi8(r[0], r[1]);
+        __m128i t1 = _mm_unpacklo_epi8(r[2], r[3]);
+        __m128i t2 = _mm_unpacklo_epi8(r[4], r[5]);
+        __m128i t3 = _mm_unpacklo_epi8(r[6], r[7]);
+        
+        __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+        __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+        __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+        __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+        
+        __m128i v0 = _mm_unpacklo_epi32(u0, u2);
+        __m128i v1 = _mm_unpackhi_epi32(u0, u2);
+        __m128i v2 = _mm_unpacklo_epi32(u1, u3);
+        __m128i v3 = _mm_unpackhi_epi32(u1, u3);
+        
+        r[0] = v0; r[1] = _mm_unpackhi_epi64(v0, v0);
+        r[2] = v1; r[3] = _mm_unpackhi_epi64(v1, v1);
+        r[4] = v2; r[5] = _mm_unpackhi_epi64(v2, v2);
+        r[6] = v3; r[7] = _mm_unpackhi_epi64(v3, v3);
+    }
+    
+    void loadTile(const char* data, int size, int row, int col, __m128i r[8]) {
+        for (int i = 0; i < 8; i++) {
+            r[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + (row + i) * size + col));
+        }
+    }
+    
+    void storeTile(char* data, int size, int row, int col, const __m128i r[8]) {
+        for (int i = 0; i < 8; i++) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(data + (row + i) * size + col), r[i]);
+        }
+    }
+    
+    __m128i reverse16(__m128i x) {
+#if defined(__SSSE3__)
+        const __m128i mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        return _mm_shuffle_epi8(x, mask);
+#else
+        x = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+#endif
+    }
+#endif
+}
+
+void GridTransforms::transpose(char* data, int size) {
+    int tiled = size - size % TILE;
+    
+    for (int blockRow = 0; blockRow < tiled; blockRow += BLOCK) {
+        int blockRowEnd = min(blockRow + BLOCK, tiled);
+        for (int blockCol = blockRow; blockCol < tiled; blockCol += BLOCK) {
+            int blockColEnd = min(blockCol + BLOCK, tiled);
+            for (int row = blockRow; row < blockRowEnd; row += TILE) {
+                for (int col = max(blockCol, row); col < blockColEnd; col += TILE) {
+                    if (row == col) {
+                        transposeTile(data, size, row, col);
+                    } else {
+                        swapTransposedTiles(data, size, row, col);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Ragged right/bottom edge left over when size isn't a multiple of TILE
+    transposeEdge(data, size, tiled);
+}
+
+void GridTransforms::rotate90(char* data, int size) {
+    transpose(data, size);
+    flipHorizontal(data, size);
+}
+
+void GridTransforms::rotate180(char* data, int size) {
+    reverseBytes(data, size * size);
+}
+
+void GridTransforms::flipHorizontal(char* data, int size) {
+    for (int row = 0; row < size; row++) {
+        reverseBytes(data + row * size, size);
+    }
+}
+
+void GridTransforms::flipVertical(char* data, int size) {
+    // Whole-row swaps keep every access sequential; memcpy through a small
+    // stack buffer vectorizes where a byte-wise swap_ranges does not
+    char buffer[SWAP_CHUNK];
+    for (int row = 0; row < size / 2; row++) {
+        char* top = data + row * size;
+        char* bottom = data + (size - 1 - row) * size;
+        if (size < TILE * TILE) {
+            swap_ranges(top, top + size, bottom);
+            continue;
+        }
+        for (int offset = 0; offset < size; offset += SWAP_CHUNK) {
+            int length = min(SWAP_CHUNK, size - offset);
+            memcpy(buffer, top + offset, length);
+            memcpy(top + offset, bottom + offset, length);
+            memcpy(bottom + offset, buffer, length);
+        }
+    }
+}
+
+bool GridTransforms::isSimdEnabled() {
+#if defined(__SSE2__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GridTransforms::transposeTile(char* data, int size, int row, int col) {
+#if defined(__SSE2__)
+    __m128i tile[8];
+    loadTile(data, size, row, col, tile);
+    transpose8x8(tile);
+    storeTile(data, size, row, col, tile);
+#else
+    for (int i = 0; i < TILE; i++) {
+        for (int j = i + 1; j < TILE; j++) {
+            swap(data[(row + i) * size + col + j], data[(row + j) * size + col + i]);
+        }
+    }
+#endif
+}
+
+void GridTransforms::swapTransposedTiles(char* data, int size, int rowA, int colA) {
+    // Tile (rowA, colA) and its mirror (colA, rowA) trade transposed contents
+#if defined(__SSE2__)
+    __m128i a[8], b[8];
+    loadTile(data, size, rowA, colA, a);
+    loadTile(data, size, colA, rowA, b);
+    transpose8x8(a);
+    transpose8x8(b);
+    storeTile(data, size, colA, rowA, a);
+    storeTile(data, size, rowA, colA, b);
+#else
+    for (int i = 0; i < TILE; i++) {
+        for (int j = 0; j < TILE; j++) {
+            swap(data[(rowA + i) * size + colA + j], data[(colA + j) * size + rowA + i]);
+        }
+    }
+#endif
+}
+
+void GridTransforms::transposeEdge(char* data, int size, int edgeStart) {
+    // Every pair with at least one coordinate in the edge band has its
+    // upper-triangle member in a column >= edgeStart
+    for (int row = 0; row < size; row++) {
+        for (int col = max(edgeStart, row + 1); col < size; col++) {
+            swap(data[row * size + col], data[col * size + row]);
+        }
+    }
+}
+
+void GridTransforms::reverseBytes(char* begin, int length) {
+    int left = 0;
+    int right = length;
+    
+#if defined(__SSE2__)
+    while (right - left >= 32) {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + left));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + right - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(begin + left), reverse16(tail));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(begin + right - 16), reverse16(head));
+        left += 16;
+        right -= 16;
+    }
+#endif
+    
+    reverse(begin + left, begin + right);
+}
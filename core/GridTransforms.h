@@ -0,0 +1,25 @@
+#pragma once
+
+// In-place transforms over a square, row-major byte grid. Large grids are
+// processed in cache-sized blocks of 8x8 tiles; tiles and row reversals use
+// SSE2/SSSE3 byte shuffles when the compiler targets them.
+class GridTransforms {
+public:
+    static void transpose(char* data, int size);
+    static void rotate90(char* data, int size);      // Clockwise
+    static void rotate180(char* data, int size);
+    static void flipHorizontal(char* data, int size); // Mirror each row
+    static void flipVertical(char* data, int size);   // Mirror row order
+    
+    static bool isSimdEnabled();
+    
+private:
+    static const int TILE = 8;
+    static const int BLOCK = 64; // Tiles are visited in BLOCK x BLOCK groups
+    static const int SWAP_CHUNK = 1024;
+    
+    static void transposeTile(char* data, int size, int row, int col);
+    static void swapTransposedTiles(char* data, int size, int rowA, int colA);
+    static void transposeEdge(char* data, int size, int edgeStart);
+    static void reverseBytes(char* begin, int length);
+};
@@ -1,4 +1,6 @@
 #include "MessageSystem.h"
+#include "../utils/Trace.h"
+#include "../utils/Utilities.h"
 #include <sstream>
 #include <algorithm>
 
@@ -6,7 +8,7 @@ using namespace std;
 
 MessageNoiseSimulator::MessageNoiseSimulator(NoiseLevel level) {
     random_device rd;
-    rng.seed(rd());
+    stream.seed((static_cast<uint64_t>(rd()) << 32) | rd());
     setNoiseLevel(level);
     initializeDictionaries();
 }
@@ -65,29 +67,53 @@ void MessageNoiseSimulator::initializeDictionaries() {
 }
 
 string MessageNoiseSimulator::applyNoise(const string& message) {
-    vector<string> words = splitMessage(message);
-    vector<string> noisyWords;
+    return applyNoise(message, stream);
+}
+
+string MessageNoiseSimulator::applyNoise(const string& message, RandomStream& stream) const {
+    string noisy;
+    applyNoiseInto(message, stream, noisy);
+    return noisy;
+}
+
+void MessageNoiseSimulator::applyNoiseInto(string_view message, string& out) {
+    applyNoiseInto(message, stream, out);
+}
+
+void MessageNoiseSimulator::applyNoiseInto(string_view message, RandomStream& stream, string& out) const {
+    TRACE_SCOPE("MessageNoiseSimulator::applyNoise");
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> words(scratch.resource());
+    splitMessage(message, words);
     
-    for (const auto& word : words) {
-        double roll = Random::getDouble(0.0, 1.0);
+    // Changed words are kept here; reserved up front so views into them stay valid
+    ScratchVector<ScratchString> altered(scratch.resource());
+    altered.reserve(words.size());
+    ScratchVector<string_view> noisyWords(scratch.resource());
+    noisyWords.reserve(words.size());
+    
+    for (string_view word : words) {
+        double roll = stream.getDouble(0.0, 1.0);
         
         if (roll < forgetProbability) {
             continue; // Word forgotten
         } else if (roll < forgetProbability + misinterpretProbability) {
-            noisyWords.push_back(misinterpretWord(word));
+            misinterpretWord(word, stream, altered.emplace_back());
+            noisyWords.push_back(altered.back());
         } else if (roll < forgetProbability + misinterpretProbability + reorderProbability) {
-            noisyWords.push_back(simulateTypo(word));
+            simulateTypo(word, stream, altered.emplace_back());
+            noisyWords.push_back(altered.back());
         } else {
             noisyWords.push_back(word);
         }
     }
     
     // Occasionally reorder the entire sentence
-    if (Random::getDouble(0.0, 1.0) < reorderProbability && noisyWords.size() > 3) {
-        shuffle(noisyWords.begin() + 1, noisyWords.end() - 1, rng);
+    if (stream.getDouble(0.0, 1.0) < reorderProbability && noisyWords.size() > 3) {
+        shuffle(noisyWords.begin() + 1, noisyWords.end() - 1, stream);
     }
     
-    return joinWords(noisyWords);
+    joinWordsInto(noisyWords, out);
 }
 
 string MessageNoiseSimulator::applyStrategicNoise(const string& message, const string& context) {
@@ -119,10 +145,12 @@ string MessageNoiseSimulator::applyStrategicNoise(const string& message, const s
 
 string MessageNoiseSimulator::applyMemoryDecay(const string& message, int turnDelay) {
     double decayFactor = min(0.8, turnDelay * 0.2);
-    vector<string> words = splitMessage(message);
-    vector<string> decayedWords;
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> words(scratch.resource());
+    splitMessage(message, words);
+    ScratchVector<string_view> decayedWords(scratch.resource());
     
-    for (const auto& word : words) {
+    for (string_view word : words) {
         if (Random::getDouble(0.0, 1.0) > decayFactor) {
             decayedWords.push_back(word);
         }
@@ -156,63 +184,66 @@ string MessageNoiseSimulator::applyProtocolLimits(const string& message, int max
     return truncated;
 }
 
-vector<string> MessageNoiseSimulator::splitMessage(const string& message) {
-    vector<string> words;
-    istringstream stream(message);
-    string word;
-    
-    while (stream >> word) {
-        words.push_back(word);
-    }
-    return words;
+void MessageNoiseSimulator::splitMessage(string_view message, ScratchVector<string_view>& words) const {
+    Utilities::splitWordsInto(message, words);
 }
 
-string MessageNoiseSimulator::joinWords(const vector<string>& words) {
+string MessageNoiseSimulator::joinWords(const ScratchVector<string_view>& words) const {
     string result;
+    joinWordsInto(words, result);
+    return result;
+}
+
+void MessageNoiseSimulator::joinWordsInto(const ScratchVector<string_view>& words, string& out) const {
+    size_t length = words.empty() ? 0 : words.size() - 1;
+    for (string_view word : words) length += word.size();
+    
+    out.clear();
+    out.reserve(length);
     for (size_t i = 0; i < words.size(); i++) {
-        result += words[i];
-        if (i < words.size() - 1) result += ' ';
+        out += words[i];
+        if (i < words.size() - 1) out += ' ';
     }
-    return result;
 }
 
-string MessageNoiseSimulator::misinterpretWord(const string& word) {
-    string upperWord = word;
-    transform(upperWord.begin(), upperWord.end(), upperWord.begin(), ::toupper);
+void MessageNoiseSimulator::misinterpretWord(string_view word, RandomStream& stream, ScratchString& out) const {
+    out.assign(word.begin(), word.end());
+    transform(out.begin(), out.end(), out.begin(), ::toupper);
     
-    auto it = misinterpretations.find(upperWord);
+    auto it = misinterpretations.find(string_view(out));
     if (it != misinterpretations.end()) {
-        return it->second[Random::getInt(0, it->second.size() - 1)];
+        out = it->second[stream.getInt(0, it->second.size() - 1)];
+        return;
     }
     
     // Number misinterpretations
-    if (word == "1") return "one";
-    if (word == "2") return "two"; 
-    if (word == "3") return "three";
-    if (word == "4") return "four";
+    if (word == "1") { out = "one"; return; }
+    if (word == "2") { out = "two"; return; }
+    if (word == "3") { out = "three"; return; }
+    if (word == "4") { out = "four"; return; }
     
-    return simulateTypo(word);
+    simulateTypo(word, stream, out);
 }
 
-string MessageNoiseSimulator::simulateTypo(const string& word) {
-    if (word.length() <= 2) return word;
+void MessageNoiseSimulator::simulateTypo(string_view word, RandomStream& stream, ScratchString& typo) const {
+    typo.assign(word.begin(), word.end());
+    if (word.length() <= 2) return;
     
-    string typo = word;
-    int typoType = Random::getInt(0, 3);
+    int typoType = stream.getInt(0, 3);
     
     switch(typoType) {
         case 0: // Missing letter
-            typo.erase(Random::getInt(0, typo.length() - 1), 1);
+            typo.erase(stream.getInt(0, typo.length() - 1), 1);
             break;
         case 1: // Duplicate letter
             if (typo.length() < 10) {
-                int pos = Random::getInt(0, typo.length() - 1);
+                int pos = stream.getInt(0, typo.length() - 1);
                 typo.insert(pos, 1, typo[pos]);
             }
             break;
         case 2: // Wrong letter (keyboard adjacent)
             if (isalpha(typo[0])) {
-                int pos = Random::getInt(0, typo.length() - 1);
+                int pos = stream.getInt(0, typo.length() - 1);
                 char original = tolower(typo[pos]);
                 // Simple keyboard adjacency (qwerty)
                 if (original == 'a') typo[pos] = 's';
@@ -224,13 +255,11 @@ string MessageNoiseSimulator::simulateTypo(const string& word) {
             break;
         case 3: // Transposition
             if (typo.length() >= 2) {
-                int pos = Random::getInt(0, typo.length() - 2);
+                int pos = stream.getInt(0, typo.length() - 2);
                 swap(typo[pos], typo[pos + 1]);
             }
             break;
     }
-    
-    return typo;
 }
 
 // MessageFormatter implementations
@@ -308,22 +337,37 @@ string MessageFormatter::compressGridDescription(const string& description) {
 }
 
 vector<string> MessageFormatter::splitByBandwidth(const string& message, int maxLines, int maxLineLength) {
-    vector<string> lines;
-    stringstream ss(message);
-    string line;
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> pieces(scratch.resource());
+    bool cut = splitByBandwidthInto(message, maxLines, maxLineLength, pieces);
+    
+    vector<string> lines(pieces.begin(), pieces.end());
+    if (cut) lines.back() += "...";
+    return lines;
+}
+
+bool MessageFormatter::splitByBandwidthInto(string_view message, int maxLines, int maxLineLength,
+                                            ScratchVector<string_view>& lines) {
+    size_t width = static_cast<size_t>(maxLineLength);
+    size_t pos = 0;
     
-    while (getline(ss, line)) {
-        if (line.length() <= maxLineLength) {
+    while (pos < message.length()) {
+        size_t newline = message.find('\n', pos);
+        if (newline == string_view::npos) newline = message.length();
+        string_view line = message.substr(pos, newline - pos);
+        pos = newline + 1;
+        
+        if (line.length() <= width) {
             lines.push_back(line);
         } else {
             // Split long lines
             size_t start = 0;
             while (start < line.length()) {
-                size_t end = min(start + maxLineLength, line.length());
+                size_t end = min(start + width, line.length());
                 if (end < line.length()) {
                     // Try to break at space
                     size_t breakPos = line.rfind(' ', end);
-                    if (breakPos != string::npos && breakPos > start) {
+                    if (breakPos != string_view::npos && breakPos > start) {
                         end = breakPos;
                     }
                 }
@@ -333,10 +377,9 @@ vector<string> MessageFormatter::splitByBandwidth(const string& message, int max
         }
     }
     
-    if (lines.size() > maxLines) {
+    if (lines.size() > static_cast<size_t>(maxLines)) {
         lines.resize(maxLines);
-        lines.back() += "...";
+        return true;
     }
-    
-    return lines;
+    return false;
 }
\ No newline at end of file
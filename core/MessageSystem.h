@@ -1,9 +1,11 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <random>
 #include "../utils/Random.h"
+#include "../utils/ScratchArena.h"
 
 enum class NoiseLevel {
     LOW = 0,    // 5% noise - Training
@@ -18,6 +20,11 @@ public:
     
     void setNoiseLevel(NoiseLevel level);
     std::string applyNoise(const std::string& message);
+    // Same channel, drawing from the caller's stream; safe to call concurrently
+    std::string applyNoise(const std::string& message, RandomStream& stream) const;
+    // Same again into out, reusing its buffer; out must not alias message
+    void applyNoiseInto(std::string_view message, std::string& out);
+    void applyNoiseInto(std::string_view message, RandomStream& stream, std::string& out) const;
     std::string applyStrategicNoise(const std::string& message, const std::string& context);
     
     // Advanced noise types
@@ -25,20 +32,27 @@ public:
     std::string applyChannelInterference(const std::string& message);
     std::string applyProtocolLimits(const std::string& message, int maxLength);
     
+    // Noise model parameters, for decoders that invert the channel
+    double getForgetProbability() const { return forgetProbability; }
+    double getMisinterpretProbability() const { return misinterpretProbability; }
+    double getTypoProbability() const { return reorderProbability; } // applyNoise's typo band
+    const std::map<std::string, std::vector<std::string>, std::less<>>& getMisinterpretations() const { return misinterpretations; }
+    
 private:
     double forgetProbability;
     double misinterpretProbability;
     double reorderProbability;
-    std::mt19937 rng;
+    RandomStream stream;
     
-    std::map<std::string, std::vector<std::string>> misinterpretations;
+    std::map<std::string, std::vector<std::string>, std::less<>> misinterpretations; // Looked up by view
     std::map<std::string, std::vector<std::string>> technicalTerms;
     
     void initializeDictionaries();
-    std::vector<std::string> splitMessage(const std::string& message);
-    std::string joinWords(const std::vector<std::string>& words);
-    std::string misinterpretWord(const std::string& word);
-    std::string simulateTypo(const std::string& word);
+    void splitMessage(std::string_view message, ScratchVector<std::string_view>& words) const;
+    std::string joinWords(const ScratchVector<std::string_view>& words) const;
+    void joinWordsInto(const ScratchVector<std::string_view>& words, std::string& out) const;
+    void misinterpretWord(std::string_view word, RandomStream& stream, ScratchString& out) const;
+    void simulateTypo(std::string_view word, RandomStream& stream, ScratchString& out) const;
 };
 
 class MessageFormatter {
@@ -46,6 +60,10 @@ public:
     static std::string formatAsProtocol(const std::string& message, int protocolVersion = 1);
     static std::string compressGridDescription(const std::string& description);
     static std::vector<std::string> splitByBandwidth(const std::string& message, int maxLines, int maxLineLength);
+    // Same split as views into message; true when lines were dropped (the
+    // last kept line then needs "..." appended)
+    static bool splitByBandwidthInto(std::string_view message, int maxLines, int maxLineLength,
+                                     ScratchVector<std::string_view>& lines);
     
     // Protocol versions
     static std::string useProtocolV1(const std::string& message); // Basic
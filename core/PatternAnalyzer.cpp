@@ -0,0 +1,191 @@
+#include "PatternAnalyzer.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+
+const int PatternAnalyzer::MIN_RECT_AREA = 4;
+
+bool PatternReport::hasSymmetry() const {
+    return symmetry.mirrorLeftRight || symmetry.mirrorTopBottom || symmetry.mirrorDiagonal ||
+           symmetry.mirrorAntiDiagonal || symmetry.rotation180;
+}
+
+string PatternReport::primaryPattern() const {
+    if (!fullRows.empty()) {
+        return "Full row " + to_string(fullRows[0].index + 1) + " of " + fullRows[0].symbol;
+    }
+    if (!fullColumns.empty()) {
+        return "Full column " + to_string(fullColumns[0].index + 1) + " of " + fullColumns[0].symbol;
+    }
+    if (checkerboard) {
+        return string("Checkerboard of ") + checkerSymbols[0] + " and " + checkerSymbols[1];
+    }
+    if (!repeatedRows.empty()) {
+        return "Row " + to_string(repeatedRows[0][1] + 1) + " repeats row " + to_string(repeatedRows[0][0] + 1);
+    }
+    if (mainDiagonal.uniform && size > 1) {
+        return string("Main diagonal of ") + mainDiagonal.symbol;
+    }
+    if (antiDiagonal.uniform && size > 1) {
+        return string("Anti-diagonal of ") + antiDiagonal.symbol;
+    }
+    if (symmetry.mirrorLeftRight) return "Mirrored left to right";
+    if (symmetry.mirrorTopBottom) return "Mirrored top to bottom";
+    if (symmetry.rotation180) return "Same when turned upside down";
+    return "No obvious patterns";
+}
+
+PatternReport PatternAnalyzer::analyze(const PatternGrid& grid) {
+    PatternReport report;
+    int n = grid.getSize();
+    report.size = n;
+    report.histogram.fill(0);
+    report.checkerboard = false;
+    report.checkerSymbols[0] = report.checkerSymbols[1] = '_';
+    report.mainDiagonal = {n > 0, n > 0 ? grid.getCell(0, 0) : '_'};
+    report.antiDiagonal = {n > 0, n > 0 ? grid.getCell(0, n - 1) : '_'};
+    report.symmetry = {true, true, true, true, true, true};
+    if (n == 0) return report;
+    
+    // Everything below is checked in a single row-major pass; each test is
+    // O(1) per cell and stops being evaluated once it has failed.
+    const char* firstRow = grid.getRowData(0);
+    char evenSymbol = firstRow[0];
+    char oddSymbol = n > 1 ? firstRow[1] : firstRow[0];
+    bool checker = n > 1 && evenSymbol != oddSymbol;
+    PatternReport::Symmetry& sym = report.symmetry;
+    
+    vector<char> columnUniform(n, 1);
+    vector<uint64_t> rowHashes(n);
+    
+    for (int row = 0; row < n; row++) {
+        const char* cells = grid.getRowData(row);
+        const char* mirrorRow = grid.getRowData(n - 1 - row);
+        char rowFirst = cells[0];
+        bool rowUniform = true;
+        uint64_t rowHash = 1469598103934665603ULL;
+        
+        for (int col = 0; col < n; col++) {
+            char value = cells[col];
+            report.histogram[static_cast<unsigned char>(value)]++;
+            rowHash = (rowHash ^ static_cast<unsigned char>(value)) * 1099511628211ULL;
+            
+            rowUniform = rowUniform && value == rowFirst;
+            if (columnUniform[col] && value != firstRow[col]) columnUniform[col] = 0;
+            
+            if (row == col && value != report.mainDiagonal.symbol) report.mainDiagonal.uniform = false;
+            if (row + col == n - 1 && value != report.antiDiagonal.symbol) report.antiDiagonal.uniform = false;
+            if (checker && value != (((row + col) & 1) ? oddSymbol : evenSymbol)) checker = false;
+            
+            if (sym.mirrorLeftRight && value != cells[n - 1 - col]) sym.mirrorLeftRight = false;
+            if (sym.mirrorTopBottom && value != mirrorRow[col]) sym.mirrorTopBottom = false;
+            if (sym.rotation180 && value != mirrorRow[n - 1 - col]) sym.rotation180 = false;
+            if (sym.mirrorDiagonal && value != grid.getCell(col, row)) sym.mirrorDiagonal = false;
+            if (sym.mirrorAntiDiagonal && value != grid.getCell(n - 1 - col, n - 1 - row)) {
+                sym.mirrorAntiDiagonal = false;
+            }
+            if (sym.rotation90 && value != grid.getCell(col, n - 1 - row)) sym.rotation90 = false;
+        }
+        
+        rowHashes[row] = rowHash;
+        if (rowUniform) report.fullRows.push_back({row, rowFirst});
+    }
+    
+    for (int col = 0; col < n; col++) {
+        if (columnUniform[col]) report.fullColumns.push_back({col, firstRow[col]});
+    }
+    
+    report.checkerboard = checker;
+    if (checker) {
+        report.checkerSymbols[0] = evenSymbol;
+        report.checkerSymbols[1] = oddSymbol;
+    }
+    
+    for (int symbol = 0; symbol < 256; symbol++) {
+        if (report.histogram[symbol] > 0) {
+            report.symbolCounts.push_back({static_cast<char>(symbol), report.histogram[symbol]});
+        }
+    }
+    stable_sort(report.symbolCounts.begin(), report.symbolCounts.end(),
+                [](const pair<char, int>& a, const pair<char, int>& b) { return a.second > b.second; });
+    
+    findRepeatedRows(grid, rowHashes, report);
+    
+    for (const auto& rect : coverWithRectangles(grid, '\0')) {
+        if (rect.area() >= MIN_RECT_AREA) report.uniformRectangles.push_back(rect);
+    }
+    
+    return report;
+}
+
+void PatternAnalyzer::findRepeatedRows(const PatternGrid& grid, const vector<uint64_t>& rowHashes,
+                                       PatternReport& report) {
+    int n = grid.getSize();
+    unordered_map<uint64_t, vector<size_t>> groupsByHash; // Row hash -> indices into groups
+    vector<vector<int>> groups;
+    
+    for (int row = 0; row < n; row++) {
+        auto& candidates = groupsByHash[rowHashes[row]];
+        bool placed = false;
+        for (size_t groupIndex : candidates) {
+            if (memcmp(grid.getRowData(groups[groupIndex][0]), grid.getRowData(row), n) == 0) {
+                groups[groupIndex].push_back(row);
+                placed = true;
+                break;
+            }
+        }
+        if (!placed) {
+            candidates.push_back(groups.size());
+            groups.push_back({row});
+        }
+    }
+    
+    for (auto& group : groups) {
+        if (group.size() > 1) report.repeatedRows.push_back(move(group));
+    }
+}
+
+vector<GridRect> PatternAnalyzer::coverWithRectangles(const PatternGrid& grid, char skipSymbol) {
+    int size = grid.getSize();
+    vector<bool> covered(size * size, false);
+    vector<GridRect> rects;
+    
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            char symbol = grid.getCell(row, col);
+            if (covered[row * size + col] || symbol == skipSymbol) continue;
+            
+            int width = 1;
+            while (col + width < size && !covered[row * size + col + width] &&
+                   grid.getCell(row, col + width) == symbol) {
+                width++;
+            }
+            
+            int height = 1;
+            while (row + height < size) {
+                bool rowMatches = true;
+                for (int c = col; c < col + width; c++) {
+                    if (covered[(row + height) * size + c] ||
+                        grid.getCell(row + height, c) != symbol) {
+                        rowMatches = false;
+                        break;
+                    }
+                }
+                if (!rowMatches) break;
+                height++;
+            }
+            
+            for (int r = row; r < row + height; r++) {
+                for (int c = col; c < col + width; c++) {
+                    covered[r * size + c] = true;
+                }
+            }
+            
+            rects.push_back({row, col, height, width, symbol});
+        }
+    }
+    
+    return rects;
+}
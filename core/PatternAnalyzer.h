@@ -0,0 +1,69 @@
+#pragma once
+#include "PatternGrid.h"
+#include <vector>
+#include <string>
+#include <array>
+
+struct GridRect {
+    int row;
+    int col;
+    int height;
+    int width;
+    char symbol;
+    
+    int area() const { return height * width; }
+};
+
+struct PatternReport {
+    struct Line {
+        int index;
+        char symbol;
+    };
+    
+    struct Diagonal {
+        bool uniform;
+        char symbol;
+    };
+    
+    struct Symmetry {
+        bool mirrorLeftRight;   // Columns mirror around the vertical axis
+        bool mirrorTopBottom;   // Rows mirror around the horizontal axis
+        bool mirrorDiagonal;    // Equal to its transpose
+        bool mirrorAntiDiagonal;
+        bool rotation180;
+        bool rotation90;
+    };
+    
+    int size;
+    std::vector<Line> fullRows;
+    std::vector<Line> fullColumns;
+    std::vector<std::vector<int>> repeatedRows; // Groups of identical rows (0-based)
+    Diagonal mainDiagonal;
+    Diagonal antiDiagonal;
+    bool checkerboard;
+    char checkerSymbols[2];
+    Symmetry symmetry;
+    std::vector<GridRect> uniformRectangles;    // Greedy cover, area >= MIN_RECT_AREA
+    std::array<int, 256> histogram;
+    std::vector<std::pair<char, int>> symbolCounts; // Most frequent first
+    
+    int countOf(char symbol) const { return histogram[static_cast<unsigned char>(symbol)]; }
+    char dominantSymbol() const { return symbolCounts.empty() ? '_' : symbolCounts[0].first; }
+    bool hasSymmetry() const;
+    std::string primaryPattern() const; // The single most useful finding, as text
+};
+
+class PatternAnalyzer {
+public:
+    static const int MIN_RECT_AREA;
+    
+    static PatternReport analyze(const PatternGrid& grid);
+    
+    // Greedy row-major cover of every cell not equal to skipSymbol with
+    // maximal uniform rectangles (pass '\0' to cover the whole grid)
+    static std::vector<GridRect> coverWithRectangles(const PatternGrid& grid, char skipSymbol);
+
+private:
+    static void findRepeatedRows(const PatternGrid& grid, const std::vector<uint64_t>& rowHashes,
+                                 PatternReport& report);
+};
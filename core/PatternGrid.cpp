@@ -1,33 +1,48 @@
 #include "PatternGrid.h"
+#include "GridTransforms.h"
+#include "PatternAnalyzer.h"
+#include "../utils/Trace.h"
 #include <sstream>
 #include <algorithm>
 #include <cmath>
 
 using namespace std;
 
-PatternGrid::PatternGrid(int gridSize) : size(gridSize) {
-    grid.resize(size, vector<char>(size, '_'));
+namespace {
+    uint64_t splitMix64(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
 }
 
-PatternGrid::PatternGrid(const vector<vector<char>>& initialGrid) {
-    grid = initialGrid;
-    size = grid.size();
+PatternGrid::PatternGrid(int gridSize) : cells(gridSize * gridSize, '_'), size(gridSize) {
+    recomputeHash();
+}
+
+PatternGrid::PatternGrid(const vector<vector<char>>& initialGrid) : size(initialGrid.size()) {
+    cells.assign(size * size, '_');
+    for (int row = 0; row < size; row++) {
+        copy_n(initialGrid[row].begin(), min<size_t>(size, initialGrid[row].size()), cells.begin() + row * size);
+    }
+    recomputeHash();
 }
 
 char PatternGrid::getCell(int row, int col) const {
-    return isValidPosition(row, col) ? grid[row][col] : '_';
+    return isValidPosition(row, col) ? cells[row * size + col] : '_';
 }
 
 void PatternGrid::setCell(int row, int col, char value) {
     if (isValidPosition(row, col)) {
-        grid[row][col] = value;
+        writeCell(row, col, value);
     }
 }
 
 void PatternGrid::fillRow(int row, char value) {
     if (isValidPosition(row, 0)) {
         for (int col = 0; col < size; col++) {
-            grid[row][col] = value;
+            writeCell(row, col, value);
         }
     }
 }
@@ -35,7 +50,7 @@ void PatternGrid::fillRow(int row, char value) {
 void PatternGrid::fillColumn(int col, char value) {
     if (isValidPosition(0, col)) {
         for (int row = 0; row < size; row++) {
-            grid[row][col] = value;
+            writeCell(row, col, value);
         }
     }
 }
@@ -43,8 +58,8 @@ void PatternGrid::fillColumn(int col, char value) {
 void PatternGrid::replaceAll(char oldVal, char newVal) {
     for (int row = 0; row < size; row++) {
         for (int col = 0; col < size; col++) {
-            if (grid[row][col] == oldVal) {
-                grid[row][col] = newVal;
+            if (cells[row * size + col] == oldVal) {
+                writeCell(row, col, newVal);
             }
         }
     }
@@ -53,69 +68,43 @@ void PatternGrid::replaceAll(char oldVal, char newVal) {
 void PatternGrid::clear() {
     for (int row = 0; row < size; row++) {
         for (int col = 0; col < size; col++) {
-            grid[row][col] = '_';
+            writeCell(row, col, '_');
         }
     }
 }
 
 void PatternGrid::rotate90() {
-    vector<vector<char>> newGrid(size, vector<char>(size));
-    for (int row = 0; row < size; row++) {
-        for (int col = 0; col < size; col++) {
-            newGrid[col][size - 1 - row] = grid[row][col];
-        }
-    }
-    grid = newGrid;
+    GridTransforms::rotate90(cells.data(), size);
+    recomputeHash();
 }
 
 void PatternGrid::flipHorizontal() {
-    for (int row = 0; row < size; row++) {
-        reverse(grid[row].begin(), grid[row].end());
-    }
+    GridTransforms::flipHorizontal(cells.data(), size);
+    recomputeHash();
 }
 
 void PatternGrid::flipVertical() {
-    for (int col = 0; col < size; col++) {
-        for (int row = 0; row < size / 2; row++) {
-            swap(grid[row][col], grid[size - 1 - row][col]);
-        }
-    }
+    GridTransforms::flipVertical(cells.data(), size);
+    recomputeHash();
+}
+
+void PatternGrid::transpose() {
+    GridTransforms::transpose(cells.data(), size);
+    recomputeHash();
 }
 
 string PatternGrid::detectPatterns() const {
-    vector<string> patterns;
-    
-    // Check for full rows/columns
-    for (int i = 0; i < size; i++) {
-        if (hasFullRow(grid[i][0])) patterns.push_back("Full row " + to_string(i+1) + " of " + grid[i][0]);
-        
-        char firstCol = grid[0][i];
-        bool fullCol = true;
-        for (int j = 0; j < size; j++) {
-            if (grid[j][i] != firstCol) {
-                fullCol = false;
-                break;
-            }
-        }
-        if (fullCol) patterns.push_back("Full column " + to_string(i+1) + " of " + firstCol);
-    }
-    
-    return patterns.empty() ? "No obvious patterns" : patterns[0];
+    return PatternAnalyzer::analyze(*this).primaryPattern();
 }
 
 int PatternGrid::countSymbol(char symbol) const {
-    int count = 0;
-    for (const auto& row : grid) {
-        for (char cell : row) {
-            if (cell == symbol) count++;
-        }
-    }
-    return count;
+    return static_cast<int>(std::count(cells.begin(), cells.end(), symbol));
 }
 
 bool PatternGrid::hasFullRow(char symbol) const {
-    for (const auto& row : grid) {
-        if (all_of(row.begin(), row.end(), [symbol](char c) { return c == symbol; })) {
+    for (int row = 0; row < size; row++) {
+        const char* rowData = &cells[row * size];
+        if (all_of(rowData, rowData + size, [symbol](char c) { return c == symbol; })) {
             return true;
         }
     }
@@ -126,7 +115,7 @@ bool PatternGrid::hasFullColumn(char symbol) const {
     for (int col = 0; col < size; col++) {
         bool full = true;
         for (int row = 0; row < size; row++) {
-            if (grid[row][col] != symbol) {
+            if (cells[row * size + col] != symbol) {
                 full = false;
                 break;
             }
@@ -137,41 +126,38 @@ bool PatternGrid::hasFullColumn(char symbol) const {
 }
 
 bool PatternGrid::operator==(const PatternGrid& other) const {
-    if (size != other.size) return false;
-    for (int row = 0; row < size; row++) {
-        for (int col = 0; col < size; col++) {
-            if (grid[row][col] != other.grid[row][col]) return false;
-        }
-    }
-    return true;
+    return size == other.size && hash == other.hash && cells == other.cells;
 }
 
 PatternGrid PatternGrid::getDifference(const PatternGrid& other) const {
+    TRACE_SCOPE("PatternGrid::getDifference");
     PatternGrid diff(size);
     for (int row = 0; row < size; row++) {
         for (int col = 0; col < size; col++) {
-            diff.setCell(row, col, (grid[row][col] == other.grid[row][col]) ? grid[row][col] : 'X');
+            diff.setCell(row, col, (cells[row * size + col] == other.cells[row * size + col]) ? cells[row * size + col] : 'X');
         }
     }
     return diff;
 }
 
 double PatternGrid::calculateAccuracy(const PatternGrid& other) const {
+    TRACE_SCOPE("PatternGrid::calculateAccuracy");
     if (size != other.size) return 0.0;
     int correct = 0;
     for (int row = 0; row < size; row++) {
         for (int col = 0; col < size; col++) {
-            if (grid[row][col] == other.grid[row][col]) correct++;
+            if (cells[row * size + col] == other.cells[row * size + col]) correct++;
         }
     }
     return (static_cast<double>(correct) / (size * size)) * 100.0;
 }
 
 string PatternGrid::toString() const {
+    TRACE_SCOPE("PatternGrid::toString");
     stringstream ss;
     for (int row = 0; row < size; row++) {
         for (int col = 0; col < size; col++) {
-            ss << grid[row][col];
+            ss << cells[row * size + col];
             if (col < size - 1) ss << ' ';
         }
         if (row < size - 1) ss << '\n';
@@ -180,16 +166,11 @@ string PatternGrid::toString() const {
 }
 
 string PatternGrid::toCompressedString() const {
-    string result;
-    for (const auto& row : grid) {
-        for (char cell : row) {
-            result += cell;
-        }
-    }
-    return result;
+    return string(cells.begin(), cells.end());
 }
 
 PatternGrid PatternGrid::fromString(const std::string& data) {
+    TRACE_SCOPE("PatternGrid::fromString");
     int side = static_cast<int>(sqrt(data.length()));
     PatternGrid grid(side);
     for (int i = 0; i < data.length(); i++) {
@@ -198,6 +179,77 @@ PatternGrid PatternGrid::fromString(const std::string& data) {
     return grid;
 }
 
+PatternGrid PatternGrid::canonicalForm() const {
+    TRACE_SCOPE("PatternGrid::canonicalForm");
+    // Try all 8 dihedral orientations; relabel symbols by first appearance so
+    // grids that differ only by a symbol permutation also collapse together.
+    PatternGrid oriented(*this);
+    PatternGrid best = relabeledBySymbolOrder();
+    string bestKey = best.toCompressedString();
+    
+    for (int flip = 0; flip < 2; flip++) {
+        for (int turn = 0; turn < 4; turn++) {
+            if (flip > 0 || turn > 0) {
+                PatternGrid candidate = oriented.relabeledBySymbolOrder();
+                string key = candidate.toCompressedString();
+                if (key < bestKey) {
+                    bestKey = key;
+                    best = candidate;
+                }
+            }
+            oriented.rotate90();
+        }
+        oriented.flipHorizontal();
+    }
+    
+    return best;
+}
+
+PatternGrid PatternGrid::relabeledBySymbolOrder() const {
+    // Empty cells stay empty. Labels run up from 'A' and wrap round the byte
+    // values, skipping '_', so there is one for every other symbol a cell holds
+    char mapping[256];
+    bool mapped[256] = {false};
+    mapping[static_cast<unsigned char>('_')] = '_';
+    mapped[static_cast<unsigned char>('_')] = true;
+    unsigned char nextLabel = 'A';
+    PatternGrid result(size);
+    
+    for (size_t i = 0; i < cells.size(); i++) {
+        unsigned char symbol = static_cast<unsigned char>(cells[i]);
+        if (!mapped[symbol]) {
+            mapping[symbol] = static_cast<char>(nextLabel);
+            mapped[symbol] = true;
+            if (++nextLabel == '_') nextLabel++;
+        }
+        result.cells[i] = mapping[symbol];
+    }
+    
+    result.recomputeHash();
+    return result;
+}
+
+void PatternGrid::writeCell(int row, int col, char value) {
+    int index = row * size + col;
+    char& cell = cells[index];
+    if (cell == value) return;
+    
+    hash ^= zobristKey(index, cell) ^ zobristKey(index, value);
+    cell = value;
+}
+
+void PatternGrid::recomputeHash() {
+    hash = splitMix64(static_cast<uint64_t>(size));
+    for (size_t i = 0; i < cells.size(); i++) {
+        hash ^= zobristKey(static_cast<int>(i), cells[i]);
+    }
+}
+
+uint64_t PatternGrid::zobristKey(int index, char symbol) {
+    // Keys are derived on the fly rather than tabulated so any grid size works
+    return splitMix64((static_cast<uint64_t>(index) << 8) | static_cast<unsigned char>(symbol));
+}
+
 bool PatternGrid::isValidPosition(int row, int col) const {
     return row >= 0 && row < size && col >= 0 && col < size;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
 
 class PatternGrid {
 public:
@@ -20,15 +21,16 @@ public:
     void rotate90();
     void flipHorizontal();
     void flipVertical();
+    void transpose();
     
     // Analysis
-    std::string detectPatterns() const;
+    std::string detectPatterns() const; // See PatternAnalyzer for the full report
     int countSymbol(char symbol) const;
     bool hasFullRow(char symbol) const;
     bool hasFullColumn(char symbol) const;
     
     // Comparison
-    bool operator==(const PatternGrid& other) const;
+    bool operator==(const PatternGrid& other) const; // O(1) reject on hash mismatch
     PatternGrid getDifference(const PatternGrid& other) const;
     double calculateAccuracy(const PatternGrid& other) const;
     
@@ -37,11 +39,22 @@ public:
     std::string toCompressedString() const;
     static PatternGrid fromString(const std::string& data);
     
+    // Hashing (Zobrist, maintained incrementally on every cell write)
+    uint64_t getHash() const { return hash; }
+    PatternGrid canonicalForm() const; // Min over 8 symmetries + symbol relabeling; empty stays '_'
+    uint64_t getCanonicalHash() const { return canonicalForm().getHash(); }
+    
     int getSize() const { return size; }
+    const char* getRowData(int row) const { return cells.data() + row * size; }
     
 private:
-    std::vector<std::vector<char>> grid;
+    std::vector<char> cells; // Row-major, size * size
     int size;
+    uint64_t hash;
     
     bool isValidPosition(int row, int col) const;
+    void writeCell(int row, int col, char value);
+    void recomputeHash();
+    static uint64_t zobristKey(int index, char symbol);
+    PatternGrid relabeledBySymbolOrder() const;
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "AchievementRegistry.h"
+#include <algorithm>
+
+using namespace std;
+
+const size_t AchievementSet::MAX_ACHIEVEMENTS;
+const size_t AchievementSet::WORD_COUNT;
+
+bool AchievementSet::set(AchievementId id) {
+    if (id >= MAX_ACHIEVEMENTS) return false;
+    uint64_t bit = uint64_t(1) << (id & 63);
+    uint64_t& word = words[id >> 6];
+    if (word & bit) return false;
+    word |= bit;
+    return true;
+}
+
+size_t AchievementSet::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+AchievementRegistry::AchievementRegistry() {}
+
+AchievementId AchievementRegistry::add(const string& name, const string& description,
+                                       MetricEvent event, Comparison comparison, double threshold) {
+    auto existing = byName.find(name);
+    if (existing != byName.end()) return existing->second;
+    if (rules.size() >= AchievementSet::MAX_ACHIEVEMENTS) return INVALID_ACHIEVEMENT;
+
+    AchievementId id = static_cast<AchievementId>(rules.size());
+    rules.push_back({id, name, description, event, comparison, threshold});
+    byName[name] = id;
+
+    size_t slot = static_cast<size_t>(event);
+    if (comparison == Comparison::AT_LEAST) {
+        auto& list = atLeast[slot];
+        auto position = upper_bound(list.begin(), list.end(), threshold,
+                                    [this](double value, AchievementId other) { return value < rules[other].threshold; });
+        list.insert(position, id);
+    } else {
+        auto& list = atMost[slot];
+        auto position = upper_bound(list.begin(), list.end(), threshold,
+                                    [this](double value, AchievementId other) { return value > rules[other].threshold; });
+        list.insert(position, id);
+    }
+    return id;
+}
+
+void AchievementRegistry::onEvent(MetricEvent event, double value, AchievementSet& unlocked,
+                                  vector<AchievementId>& newlyUnlocked) const {
+    size_t slot = static_cast<size_t>(event);
+
+    // Satisfied rules form a prefix of each list; stop at the first miss
+    for (AchievementId id : atLeast[slot]) {
+        if (value < rules[id].threshold) break;
+        if (unlocked.set(id)) newlyUnlocked.push_back(id);
+    }
+    for (AchievementId id : atMost[slot]) {
+        if (value > rules[id].threshold) break;
+        if (unlocked.set(id)) newlyUnlocked.push_back(id);
+    }
+}
+
+int AchievementRegistry::findByName(const string& name) const {
+    auto it = byName.find(name);
+    return it != byName.end() ? it->second : -1;
+}
+
+const AchievementRegistry& AchievementRegistry::getDefault() {
+    static const AchievementRegistry registry = [] {
+        AchievementRegistry built;
+        built.add("Perfect Transmission", "Rebuild a pattern with 100% accuracy",
+                  MetricEvent::ACCURACY, Comparison::AT_LEAST, 100.0);
+        built.add("Speed Demon", "Finish an episode in 5 turns or fewer",
+                  MetricEvent::TURNS_TAKEN, Comparison::AT_MOST, 5);
+        built.add("First Contact", "Complete your first episode",
+                  MetricEvent::GAMES_PLAYED, Comparison::AT_LEAST, 1);
+        built.add("Veteran Dispatcher", "Complete 50 episodes",
+                  MetricEvent::GAMES_PLAYED, Comparison::AT_LEAST, 50);
+        built.add("High Scorer", "Score 1100 points in a single episode",
+                  MetricEvent::SCORE, Comparison::AT_LEAST, 1100);
+        built.add("Skilled Operator", "Earn 100 skill points",
+                  MetricEvent::SKILL_POINTS, Comparison::AT_LEAST, 100);
+        return built;
+    }();
+    return registry;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+using AchievementId = uint16_t;
+const AchievementId INVALID_ACHIEVEMENT = 0xFFFF;
+
+// Everything a rule can watch. Each completed game emits one of each.
+enum class MetricEvent : uint8_t {
+    ACCURACY = 0,
+    TURNS_TAKEN,
+    MESSAGES_USED,
+    SCORE,
+    TIME_ELAPSED,
+    GAMES_PLAYED,
+    SKILL_POINTS,
+    COUNT
+};
+
+enum class Comparison : uint8_t {
+    AT_LEAST,
+    AT_MOST
+};
+
+struct AchievementRule {
+    AchievementId id;
+    std::string name;
+    std::string description;
+    MetricEvent event;
+    Comparison comparison;
+    double threshold;
+};
+
+// Fixed-size bitset of unlocked achievements, indexed by AchievementId
+class AchievementSet {
+public:
+    static const size_t MAX_ACHIEVEMENTS = 512;
+    static const size_t WORD_COUNT = MAX_ACHIEVEMENTS / 64;
+
+    AchievementSet() : words{} {}
+
+    bool test(AchievementId id) const { return id < MAX_ACHIEVEMENTS && (words[id >> 6] >> (id & 63)) & 1; }
+    bool set(AchievementId id); // True if newly unlocked
+    size_t count() const;
+    bool empty() const { return count() == 0; }
+
+    const std::array<uint64_t, WORD_COUNT>& getWords() const { return words; }
+    std::array<uint64_t, WORD_COUNT>& getWords() { return words; }
+
+private:
+    std::array<uint64_t, WORD_COUNT> words;
+};
+
+// Declarative achievement rules, indexed by the event they watch and sorted
+// by threshold, so an event only visits the rules it could satisfy.
+// IDs are assigned in registration order and persisted in saves: only ever
+// append new rules.
+class AchievementRegistry {
+public:
+    AchievementRegistry();
+
+    // Re-adding a name returns its existing ID; INVALID_ACHIEVEMENT once full
+    AchievementId add(const std::string& name, const std::string& description,
+                      MetricEvent event, Comparison comparison, double threshold);
+
+    // Unlocks every rule the value satisfies; appends newly unlocked IDs to newlyUnlocked
+    void onEvent(MetricEvent event, double value, AchievementSet& unlocked,
+                 std::vector<AchievementId>& newlyUnlocked) const;
+
+    const AchievementRule& getRule(AchievementId id) const { return rules[id]; }
+    const std::vector<AchievementRule>& getRules() const { return rules; }
+    int findByName(const std::string& name) const; // -1 if unknown
+    size_t size() const { return rules.size(); }
+
+    static const AchievementRegistry& getDefault(); // The game's built-in achievements
+
+private:
+    std::vector<AchievementRule> rules;
+    std::unordered_map<std::string, AchievementId> byName;
+
+    // Per event: AT_LEAST rules by ascending threshold, AT_MOST by descending
+    std::array<std::vector<AchievementId>, static_cast<size_t>(MetricEvent::COUNT)> atLeast;
+    std::array<std::vector<AchievementId>, static_cast<size_t>(MetricEvent::COUNT)> atMost;
+};
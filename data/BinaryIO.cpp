@@ -0,0 +1,52 @@
+#include "BinaryIO.h"
+#include <cstring>
+
+using namespace std;
+
+void BinaryWriter::writeString(const string& value) {
+    writeU32(static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+void BinaryWriter::writeRaw(const void* data, size_t size) {
+    buffer.append(static_cast<const char*>(data), size);
+}
+
+string BinaryReader::readString() {
+    uint32_t length = readU32();
+    if (failed || length > remaining()) {
+        failed = true;
+        return string();
+    }
+    string value(data + pos, length);
+    pos += length;
+    return value;
+}
+
+bool BinaryReader::readRaw(void* out, size_t count) {
+    if (failed || count > remaining()) {
+        failed = true;
+        return false;
+    }
+    memcpy(out, data + pos, count);
+    pos += count;
+    return true;
+}
+
+bool BinaryReader::skip(size_t count) {
+    if (failed || count > remaining()) {
+        failed = true;
+        return false;
+    }
+    pos += count;
+    return true;
+}
+
+uint32_t checksum32(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Little helpers for the binary save formats. Values are written in host
+// byte order; files are not meant to move between architectures.
+class BinaryWriter {
+public:
+    void writeU8(uint8_t value) { writeRaw(&value, sizeof(value)); }
+    void writeU32(uint32_t value) { writeRaw(&value, sizeof(value)); }
+    void writeI32(int32_t value) { writeRaw(&value, sizeof(value)); }
+    void writeU64(uint64_t value) { writeRaw(&value, sizeof(value)); }
+    void writeI64(int64_t value) { writeRaw(&value, sizeof(value)); }
+    void writeF64(double value) { writeRaw(&value, sizeof(value)); }
+    void writeString(const std::string& value);
+    void writeRaw(const void* data, size_t size);
+
+    const std::string& getBuffer() const { return buffer; }
+    std::string& getBuffer() { return buffer; }
+    size_t size() const { return buffer.size(); }
+    void clear() { buffer.clear(); }
+
+private:
+    std::string buffer;
+};
+
+// Bounds-checked reader; after the first short read every further read
+// fails too, so callers can check ok() once at the end
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size) : data(data), size(size), pos(0), failed(false) {}
+
+    uint8_t readU8() { uint8_t v = 0; readRaw(&v, sizeof(v)); return v; }
+    uint32_t readU32() { uint32_t v = 0; readRaw(&v, sizeof(v)); return v; }
+    int32_t readI32() { int32_t v = 0; readRaw(&v, sizeof(v)); return v; }
+    uint64_t readU64() { uint64_t v = 0; readRaw(&v, sizeof(v)); return v; }
+    int64_t readI64() { int64_t v = 0; readRaw(&v, sizeof(v)); return v; }
+    double readF64() { double v = 0; readRaw(&v, sizeof(v)); return v; }
+    std::string readString();
+    bool readRaw(void* out, size_t count);
+    bool skip(size_t count);
+
+    bool ok() const { return !failed; }
+    size_t remaining() const { return size - pos; }
+    size_t position() const { return pos; }
+
+private:
+    const char* data;
+    size_t size;
+    size_t pos;
+    bool failed;
+};
+
+uint32_t checksum32(const char* data, size_t size); // FNV-1a
@@ -0,0 +1,326 @@
+#include "ContentPack.h"
+#include "SaveSystem.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+struct ContentPack::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t episodeCount;
+    uint32_t cutsceneCount;
+    uint32_t reserved;
+    uint64_t episodeIndexOffset;
+    uint64_t cutsceneIndexOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t patternsOffset;
+    uint64_t patternsSize;
+};
+
+struct ContentPack::EpisodeRecord {
+    int32_t number;
+    int32_t requiredSkillPoints;
+    uint32_t titleOffset;
+    uint32_t titleLength;
+    uint32_t descriptionOffset;
+    uint32_t descriptionLength;
+    uint32_t patternOffset;
+    uint16_t gridSize;
+    uint8_t difficulty;
+    uint8_t unlocked;
+};
+
+struct ContentPack::CutsceneRecord {
+    uint32_t keyOffset;
+    uint32_t keyLength;
+    uint32_t titleOffset;
+    uint32_t titleLength;
+    uint32_t linesOffset;
+    uint32_t linesLength;
+    int32_t lineDelayMs;
+    uint32_t reserved;
+};
+
+const char ContentPack::MAGIC[8] = {'D', 'S', 'P', 'P', 'A', 'C', 'K', '1'};
+const uint32_t ContentPack::VERSION = 1;
+
+ContentPack::ContentPack() : data(nullptr), size(0) {}
+
+ContentPack::~ContentPack() {
+    close();
+}
+
+bool ContentPack::open(const string& path) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail("Cannot open " + path);
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return fail("Not a content pack: " + path);
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return fail("Cannot map " + path);
+
+    data = static_cast<const char*>(mapped);
+    size = static_cast<size_t>(info.st_size);
+#else
+    ifstream file(path, ios::binary);
+    if (!file) return fail("Cannot open " + path);
+    fallbackBuffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (fallbackBuffer.size() < sizeof(Header)) return fail("Not a content pack: " + path);
+    data = fallbackBuffer.data();
+    size = fallbackBuffer.size();
+#endif
+
+    // Validate the header and table bounds once so lookups can trust them
+    const Header* h = header();
+    uint64_t episodeEnd = h->episodeIndexOffset + uint64_t(h->episodeCount) * sizeof(EpisodeRecord);
+    uint64_t cutsceneEnd = h->cutsceneIndexOffset + uint64_t(h->cutsceneCount) * sizeof(CutsceneRecord);
+    if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION ||
+        episodeEnd > size || cutsceneEnd > size ||
+        h->stringsOffset + h->stringsSize > size || h->patternsOffset + h->patternsSize > size) {
+        close();
+        return fail("Corrupt or unsupported content pack: " + path);
+    }
+
+    lastError.clear();
+    return true;
+}
+
+void ContentPack::close() {
+    if (!data) return;
+
+#ifndef _WIN32
+    munmap(const_cast<char*>(data), size);
+#endif
+    fallbackBuffer.clear();
+    data = nullptr;
+    size = 0;
+}
+
+size_t ContentPack::getEpisodeCount() const {
+    return data ? header()->episodeCount : 0;
+}
+
+size_t ContentPack::getCutsceneCount() const {
+    return data ? header()->cutsceneCount : 0;
+}
+
+bool ContentPack::getEpisodeAt(size_t index, PackedEpisode& out) const {
+    if (index >= getEpisodeCount()) return false;
+
+    EpisodeRecord record;
+    memcpy(&record, episodeRecords() + index, sizeof(record));
+    return decodeEpisode(record, out);
+}
+
+bool ContentPack::findEpisode(int number, PackedEpisode& out) const {
+    size_t low = 0;
+    size_t high = getEpisodeCount();
+    const EpisodeRecord* records = episodeRecords();
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        EpisodeRecord record;
+        memcpy(&record, records + mid, sizeof(record));
+
+        if (record.number == number) return decodeEpisode(record, out);
+        if (record.number < number) low = mid + 1;
+        else high = mid;
+    }
+    return false;
+}
+
+bool ContentPack::findCutscene(string_view key, PackedCutscene& out) const {
+    size_t low = 0;
+    size_t high = getCutsceneCount();
+    const CutsceneRecord* records = cutsceneRecords();
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        CutsceneRecord record;
+        memcpy(&record, records + mid, sizeof(record));
+
+        string_view recordKey;
+        if (!stringAt(record.keyOffset, record.keyLength, recordKey)) return false;
+
+        int order = recordKey.compare(key);
+        if (order == 0) return decodeCutscene(record, out);
+        if (order < 0) low = mid + 1;
+        else high = mid;
+    }
+    return false;
+}
+
+bool ContentPack::write(const string& path, const vector<PackedEpisode>& episodes,
+                        const vector<PackedCutscene>& cutscenes) {
+    string strings;
+    string patterns;
+    auto addString = [&strings](string_view text, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(text.size());
+        strings.append(text.data(), text.size());
+    };
+
+    vector<const PackedEpisode*> sortedEpisodes;
+    for (const auto& episode : episodes) sortedEpisodes.push_back(&episode);
+    sort(sortedEpisodes.begin(), sortedEpisodes.end(),
+         [](const PackedEpisode* a, const PackedEpisode* b) { return a->number < b->number; });
+    // Lookups binary-search the index, so a repeated number would hide one of them
+    if (adjacent_find(sortedEpisodes.begin(), sortedEpisodes.end(), [](const PackedEpisode* a, const PackedEpisode* b) {
+            return a->number == b->number;
+        }) != sortedEpisodes.end()) {
+        return false;
+    }
+
+    vector<const PackedCutscene*> sortedCutscenes;
+    for (const auto& cutscene : cutscenes) sortedCutscenes.push_back(&cutscene);
+    sort(sortedCutscenes.begin(), sortedCutscenes.end(),
+         [](const PackedCutscene* a, const PackedCutscene* b) { return a->key < b->key; });
+    if (adjacent_find(sortedCutscenes.begin(), sortedCutscenes.end(), [](const PackedCutscene* a, const PackedCutscene* b) {
+            return a->key == b->key;
+        }) != sortedCutscenes.end()) {
+        return false;
+    }
+
+    vector<EpisodeRecord> episodeTable;
+    for (const PackedEpisode* episode : sortedEpisodes) {
+        size_t cells = static_cast<size_t>(episode->gridSize) * episode->gridSize;
+        if (episode->gridSize <= 0 || episode->pattern.size() != cells) return false;
+
+        EpisodeRecord record{};
+        record.number = episode->number;
+        record.requiredSkillPoints = episode->requiredSkillPoints;
+        addString(episode->title, record.titleOffset, record.titleLength);
+        addString(episode->description, record.descriptionOffset, record.descriptionLength);
+        record.patternOffset = static_cast<uint32_t>(patterns.size());
+        patterns.append(episode->pattern.data(), cells);
+        record.gridSize = static_cast<uint16_t>(episode->gridSize);
+        record.difficulty = static_cast<uint8_t>(episode->recommendedDifficulty);
+        record.unlocked = episode->unlocked ? 1 : 0;
+        episodeTable.push_back(record);
+    }
+
+    vector<CutsceneRecord> cutsceneTable;
+    for (const PackedCutscene* cutscene : sortedCutscenes) {
+        CutsceneRecord record{};
+        addString(cutscene->key, record.keyOffset, record.keyLength);
+        addString(cutscene->title, record.titleOffset, record.titleLength);
+        addString(cutscene->lines, record.linesOffset, record.linesLength);
+        record.lineDelayMs = cutscene->lineDelayMs;
+        cutsceneTable.push_back(record);
+    }
+
+    auto align8 = [](uint64_t offset) { return (offset + 7) & ~uint64_t(7); };
+
+    Header h{};
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.episodeCount = static_cast<uint32_t>(episodeTable.size());
+    h.cutsceneCount = static_cast<uint32_t>(cutsceneTable.size());
+    h.episodeIndexOffset = align8(sizeof(Header));
+    h.cutsceneIndexOffset = align8(h.episodeIndexOffset + episodeTable.size() * sizeof(EpisodeRecord));
+    h.stringsOffset = align8(h.cutsceneIndexOffset + cutsceneTable.size() * sizeof(CutsceneRecord));
+    h.stringsSize = strings.size();
+    h.patternsOffset = align8(h.stringsOffset + strings.size());
+    h.patternsSize = patterns.size();
+
+    string file(h.patternsOffset + patterns.size(), '\0');
+    memcpy(&file[0], &h, sizeof(h));
+    if (!episodeTable.empty()) {
+        memcpy(&file[h.episodeIndexOffset], episodeTable.data(), episodeTable.size() * sizeof(EpisodeRecord));
+    }
+    if (!cutsceneTable.empty()) {
+        memcpy(&file[h.cutsceneIndexOffset], cutsceneTable.data(), cutsceneTable.size() * sizeof(CutsceneRecord));
+    }
+    file.replace(h.stringsOffset, strings.size(), strings);
+    file.replace(h.patternsOffset, patterns.size(), patterns);
+
+    // A pack is mapped straight into the game, so never leave a half-written one
+    return SaveSystem::writeFileAtomically(path, file);
+}
+
+const ContentPack& ContentPack::getDefault() {
+    static ContentPack pack;
+    static bool attempted = false;
+
+    if (!attempted) {
+        attempted = true;
+        const char* env = getenv("DISPATCH_CONTENT_PACK");
+        pack.open(env && *env ? env : "content.pack");
+    }
+    return pack;
+}
+
+const ContentPack::Header* ContentPack::header() const {
+    return reinterpret_cast<const Header*>(data);
+}
+
+const ContentPack::EpisodeRecord* ContentPack::episodeRecords() const {
+    if (!data) return nullptr;
+    return reinterpret_cast<const EpisodeRecord*>(data + header()->episodeIndexOffset);
+}
+
+const ContentPack::CutsceneRecord* ContentPack::cutsceneRecords() const {
+    if (!data) return nullptr;
+    return reinterpret_cast<const CutsceneRecord*>(data + header()->cutsceneIndexOffset);
+}
+
+bool ContentPack::decodeEpisode(const EpisodeRecord& record, PackedEpisode& out) const {
+    uint64_t cells = uint64_t(record.gridSize) * record.gridSize;
+    if (record.difficulty > static_cast<uint8_t>(Difficulty::EXPERT) ||
+        record.patternOffset + cells > header()->patternsSize) {
+        return false;
+    }
+
+    if (!stringAt(record.titleOffset, record.titleLength, out.title) ||
+        !stringAt(record.descriptionOffset, record.descriptionLength, out.description)) {
+        return false;
+    }
+
+    out.number = record.number;
+    out.pattern = string_view(data + header()->patternsOffset + record.patternOffset, cells);
+    out.gridSize = record.gridSize;
+    out.recommendedDifficulty = static_cast<Difficulty>(record.difficulty);
+    out.unlocked = record.unlocked != 0;
+    out.requiredSkillPoints = record.requiredSkillPoints;
+    return true;
+}
+
+bool ContentPack::decodeCutscene(const CutsceneRecord& record, PackedCutscene& out) const {
+    if (!stringAt(record.keyOffset, record.keyLength, out.key) ||
+        !stringAt(record.titleOffset, record.titleLength, out.title) ||
+        !stringAt(record.linesOffset, record.linesLength, out.lines)) {
+        return false;
+    }
+    out.lineDelayMs = record.lineDelayMs;
+    return true;
+}
+
+bool ContentPack::stringAt(uint32_t offset, uint32_t length, string_view& out) const {
+    if (uint64_t(offset) + length > header()->stringsSize) return false;
+    out = string_view(data + header()->stringsOffset + offset, length);
+    return true;
+}
+
+bool ContentPack::fail(const string& message) {
+    lastError = message;
+    return false;
+}
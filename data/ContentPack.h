@@ -0,0 +1,80 @@
+#pragma once
+#include "GameData.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// One episode as stored in a pack. The views point into the mapped file
+// (or, when writing, into the caller's strings); pattern is gridSize^2
+// cells in row-major order.
+struct PackedEpisode {
+    int number = 0;
+    std::string_view title;
+    std::string_view description;
+    std::string_view pattern;
+    int gridSize = 0;
+    Difficulty recommendedDifficulty = Difficulty::NORMAL;
+    bool unlocked = false;
+    int requiredSkillPoints = 0;
+};
+
+// Cutscene text, looked up by key (e.g. "episode1_intro"); lines are '\n'-separated
+struct PackedCutscene {
+    std::string_view key;
+    std::string_view title;
+    std::string_view lines;
+    int lineDelayMs = 50;
+};
+
+// Read-only content pack: a header, fixed-size index records sorted by
+// episode number / cutscene key, then string and pattern blobs. The file is
+// memory-mapped on open; nothing is decoded until an entry is asked for.
+class ContentPack {
+public:
+    ContentPack();
+    ~ContentPack();
+    ContentPack(const ContentPack&) = delete;
+    ContentPack& operator=(const ContentPack&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    const std::string& getLastError() const { return lastError; }
+
+    // Index access is O(1) / O(log n) and touches only the record table
+    size_t getEpisodeCount() const;
+    size_t getCutsceneCount() const;
+    bool getEpisodeAt(size_t index, PackedEpisode& out) const;
+    bool findEpisode(int number, PackedEpisode& out) const;
+    bool findCutscene(std::string_view key, PackedCutscene& out) const;
+
+    // Replaces path atomically. False on a malformed pattern or a repeated
+    // episode number or cutscene key, leaving any existing pack as it was.
+    static bool write(const std::string& path, const std::vector<PackedEpisode>& episodes,
+                      const std::vector<PackedCutscene>& cutscenes);
+
+    // Pack named by DISPATCH_CONTENT_PACK, else content.pack; opened on first use
+    static const ContentPack& getDefault();
+
+private:
+    struct Header;
+    struct EpisodeRecord;
+    struct CutsceneRecord;
+
+    static const char MAGIC[8];
+    static const uint32_t VERSION;
+
+    const char* data;
+    size_t size;
+    std::vector<char> fallbackBuffer; // Used where mmap isn't available
+    std::string lastError;
+
+    const Header* header() const;
+    const EpisodeRecord* episodeRecords() const;
+    const CutsceneRecord* cutsceneRecords() const;
+    bool decodeEpisode(const EpisodeRecord& record, PackedEpisode& out) const;
+    bool decodeCutscene(const CutsceneRecord& record, PackedCutscene& out) const;
+    bool stringAt(uint32_t offset, uint32_t length, std::string_view& out) const;
+    bool fail(const std::string& message);
+};
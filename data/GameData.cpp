@@ -3,15 +3,38 @@
 
 using namespace std;
 
+const size_t GameData::MAX_HISTORY = 100;
+
+void GameStatistics::record(const GameMetrics& metrics) {
+    accuracy.add(metrics.accuracy);
+    score.add(metrics.score);
+    turns.add(metrics.turnsTaken);
+    time.add(static_cast<double>(metrics.timeElapsed.count()));
+}
+
+void GameStatistics::merge(const GameStatistics& other) {
+    accuracy.merge(other.accuracy);
+    score.merge(other.score);
+    turns.merge(other.turns);
+    time.merge(other.time);
+}
+
 GameData::GameData() 
     : currentDifficulty(Difficulty::NORMAL), 
       skillPoints(0), 
       currentEpisode(1),
       tutorialEnabled(true) {}
 
-void GameData::addCompletedEpisode(int episode, const GameMetrics& metrics) {
+vector<AchievementId> GameData::addCompletedEpisode(int episode, const GameMetrics& metrics) {
     gameHistory.push_back(metrics);
-    currentEpisode = max(currentEpisode, episode + 1);
+    if (gameHistory.size() > MAX_HISTORY) {
+        gameHistory.pop_front();
+    }
+    overall.record(metrics);
+    byDifficulty[static_cast<size_t>(currentDifficulty)].record(metrics);
+    if (episode == currentEpisode) {
+        currentEpisode++; // Replays and random challenges don't advance the story
+    }
     
     // Award skill points based on performance
     int points = static_cast<int>(metrics.accuracy / 10) + 
@@ -19,12 +42,23 @@ void GameData::addCompletedEpisode(int episode, const GameMetrics& metrics) {
                  (metrics.accuracy == 100.0 ? 5 : 0);
     
     addSkillPoints(points);
+    
+    const AchievementRegistry& registry = AchievementRegistry::getDefault();
+    vector<AchievementId> unlocked;
+    registry.onEvent(MetricEvent::ACCURACY, metrics.accuracy, unlockedAchievements, unlocked);
+    registry.onEvent(MetricEvent::TURNS_TAKEN, metrics.turnsTaken, unlockedAchievements, unlocked);
+    registry.onEvent(MetricEvent::MESSAGES_USED, metrics.messagesUsed, unlockedAchievements, unlocked);
+    registry.onEvent(MetricEvent::SCORE, metrics.score, unlockedAchievements, unlocked);
+    registry.onEvent(MetricEvent::TIME_ELAPSED, static_cast<double>(metrics.timeElapsed.count()),
+                     unlockedAchievements, unlocked);
+    registry.onEvent(MetricEvent::GAMES_PLAYED, static_cast<double>(overall.getGamesPlayed()),
+                     unlockedAchievements, unlocked);
+    registry.onEvent(MetricEvent::SKILL_POINTS, skillPoints, unlockedAchievements, unlocked);
+    return unlocked;
 }
 
-void GameData::unlockAchievement(const std::string& achievement) {
-    if (find(unlockedAchievements.begin(), unlockedAchievements.end(), achievement) == unlockedAchievements.end()) {
-        unlockedAchievements.push_back(achievement);
-    }
+bool GameData::unlockAchievement(AchievementId achievement) {
+    return unlockedAchievements.set(achievement);
 }
 
 void GameData::addSkillPoints(int points) {
@@ -32,31 +66,19 @@ void GameData::addSkillPoints(int points) {
 }
 
 int GameData::getTotalGamesPlayed() const {
-    return gameHistory.size();
+    return static_cast<int>(overall.getGamesPlayed());
 }
 
 double GameData::getAverageAccuracy() const {
-    if (gameHistory.empty()) return 0.0;
-    
-    double total = 0.0;
-    for (const auto& metrics : gameHistory) {
-        total += metrics.accuracy;
-    }
-    return total / gameHistory.size();
+    return overall.accuracy.summary.getMean();
 }
 
 int GameData::getHighestScore() const {
-    int highest = 0;
-    for (const auto& metrics : gameHistory) {
-        if (metrics.score > highest) {
-            highest = metrics.score;
-        }
-    }
-    return highest;
+    return static_cast<int>(overall.score.summary.getMax());
 }
 
-vector<string> GameData::getUnlockedAchievements() const {
-    return unlockedAchievements;
+const GameStatistics& GameData::getStatistics(Difficulty difficulty) const {
+    return byDifficulty[static_cast<size_t>(difficulty)];
 }
 
 void GameData::setDifficulty(Difficulty diff) {
@@ -1,8 +1,12 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <deque>
+#include <array>
 #include <chrono>
 #include "../core/PatternGrid.h"
+#include "StreamingStats.h"
+#include "AchievementRegistry.h"
 
 enum class Difficulty {
     TRAINING = 0,
@@ -55,20 +59,49 @@ struct SaveData {
     GameMetrics currentMetrics;
 };
 
+// In-progress DispatchGame, as persisted by SaveSystem
+struct GameSnapshot {
+    PatternGrid target;
+    PatternGrid builderGrid;
+    Difficulty difficulty = Difficulty::NORMAL;
+    int currentTurn = 0;
+    int totalTurns = 0;
+    int messagesUsed = 0;
+    int64_t elapsedSeconds = 0;
+    std::vector<std::string> messagesReceived; // Messenger history
+    std::vector<std::string> messagesSent;
+};
+
+// Streaming aggregates over every game ever played, in fixed memory
+struct GameStatistics {
+    MetricStats accuracy;
+    MetricStats score;
+    MetricStats turns;
+    MetricStats time; // Seconds
+    
+    void record(const GameMetrics& metrics);
+    void merge(const GameStatistics& other);
+    uint64_t getGamesPlayed() const { return accuracy.summary.getCount(); }
+};
+
 class GameData {
 public:
     GameData();
     
     // Player progression
-    void addCompletedEpisode(int episode, const GameMetrics& metrics);
-    void unlockAchievement(const std::string& achievement);
+    // Returns the achievements this game unlocked
+    std::vector<AchievementId> addCompletedEpisode(int episode, const GameMetrics& metrics);
+    bool unlockAchievement(AchievementId achievement); // True if newly unlocked
+    bool hasAchievement(AchievementId achievement) const { return unlockedAchievements.test(achievement); }
     void addSkillPoints(int points);
     
     // Statistics
     int getTotalGamesPlayed() const;
     double getAverageAccuracy() const;
     int getHighestScore() const;
-    std::vector<std::string> getUnlockedAchievements() const;
+    const AchievementSet& getUnlockedAchievements() const { return unlockedAchievements; }
+    const GameStatistics& getStatistics() const { return overall; }
+    const GameStatistics& getStatistics(Difficulty difficulty) const;
     
     // Settings
     void setDifficulty(Difficulty diff);
@@ -79,12 +112,21 @@ public:
     int getSkillPoints() const { return skillPoints; }
     int getCurrentEpisode() const { return currentEpisode; }
     bool isTutorialEnabled() const { return tutorialEnabled; }
+    const std::deque<GameMetrics>& getGameHistory() const { return gameHistory; } // Most recent games only
 
 private:
+    friend class SaveSystem;
+    
     Difficulty currentDifficulty;
     int skillPoints;
     int currentEpisode;
     bool tutorialEnabled;
-    std::vector<std::string> unlockedAchievements;
-    std::vector<GameMetrics> gameHistory;
+    AchievementSet unlockedAchievements; // Bits index AchievementRegistry::getDefault()
+    std::deque<GameMetrics> gameHistory;
+    
+    // Statistics never depend on the capped history
+    GameStatistics overall;
+    std::array<GameStatistics, 4> byDifficulty;
+    
+    static const size_t MAX_HISTORY;
 };
\ No newline at end of file
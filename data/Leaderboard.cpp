@@ -0,0 +1,304 @@
+#include "Leaderboard.h"
+#include "SaveSystem.h"
+#include "BinaryIO.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+using namespace std;
+
+const int ScoreIndex::MIN_SCORE = -1024;
+const int ScoreIndex::MAX_SCORE = 4095;
+
+const char Leaderboard::MAGIC[8] = {'D', 'S', 'P', 'L', 'D', 'B', 'D', '1'};
+const uint32_t Leaderboard::FORMAT_VERSION = 1;
+
+namespace {
+
+// Higher score first, then the earlier result
+bool ranksAbove(const LeaderboardEntry& a, const LeaderboardEntry& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.timestamp < b.timestamp;
+}
+
+void writeEntry(BinaryWriter& out, const LeaderboardEntry& entry) {
+    out.writeI32(entry.score);
+    out.writeU32(entry.player);
+    out.writeI32(entry.episode);
+    out.writeU8(static_cast<uint8_t>(entry.difficulty));
+    out.writeU32(entry.timestamp);
+}
+
+LeaderboardEntry readEntry(BinaryReader& in) {
+    LeaderboardEntry entry;
+    entry.score = in.readI32();
+    entry.player = in.readU32();
+    entry.episode = in.readI32();
+    entry.difficulty = static_cast<Difficulty>(min<uint8_t>(in.readU8(), static_cast<uint8_t>(Difficulty::EXPERT)));
+    entry.timestamp = in.readU32();
+    return entry;
+}
+
+}
+
+ScoreIndex::ScoreIndex() : total(0) {}
+
+size_t ScoreIndex::slotFor(int score) {
+    return static_cast<size_t>(max(MIN_SCORE, min(MAX_SCORE, score)) - MIN_SCORE);
+}
+
+void ScoreIndex::add(int score, uint32_t count) {
+    if (tree.empty()) tree.assign(MAX_SCORE - MIN_SCORE + 2, 0);
+    for (size_t i = slotFor(score) + 1; i < tree.size(); i += i & (~i + 1)) {
+        tree[i] += count;
+    }
+    total += count;
+}
+
+uint64_t ScoreIndex::countAbove(int score) const {
+    if (tree.empty()) return 0;
+    uint64_t atOrBelow = 0;
+    for (size_t i = slotFor(score) + 1; i > 0; i -= i & (~i + 1)) {
+        atOrBelow += tree[i];
+    }
+    return total - atOrBelow;
+}
+
+uint32_t ScoreIndex::countAt(int score) const {
+    if (tree.empty()) return 0;
+    uint64_t below = score > MIN_SCORE ? countAbove(score - 1) : total;
+    return static_cast<uint32_t>(below - countAbove(score));
+}
+
+bool TopScores::offer(const LeaderboardEntry& entry) {
+    // ranksAbove as the heap order puts the weakest entry at the front
+    if (heap.size() < capacity) {
+        heap.push_back(entry);
+        push_heap(heap.begin(), heap.end(), ranksAbove);
+        return true;
+    }
+    if (capacity == 0 || !ranksAbove(entry, heap.front())) return false;
+
+    pop_heap(heap.begin(), heap.end(), ranksAbove);
+    heap.back() = entry;
+    push_heap(heap.begin(), heap.end(), ranksAbove);
+    return true;
+}
+
+vector<LeaderboardEntry> TopScores::getSorted() const {
+    vector<LeaderboardEntry> sorted = heap;
+    sort(sorted.begin(), sorted.end(), ranksAbove);
+    return sorted;
+}
+
+Leaderboard::Leaderboard(size_t topCount) : topCount(topCount) {
+    topByDifficulty.fill(TopScores(topCount));
+}
+
+uint32_t Leaderboard::addPlayer(const string& name) {
+    auto it = playerIds.find(name);
+    if (it != playerIds.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(players.size());
+    players.push_back(name);
+    playerIds[name] = id;
+    return id;
+}
+
+const string& Leaderboard::getPlayerName(uint32_t player) const {
+    static const string unknown = "Unknown";
+    return player < players.size() ? players[player] : unknown;
+}
+
+void Leaderboard::submit(const LeaderboardEntry& entry) {
+    size_t slot = static_cast<size_t>(entry.difficulty);
+    scoresByDifficulty[slot].add(entry.score);
+    topByDifficulty[slot].offer(entry);
+    episodeBoard(entry.episode, entry.difficulty).offer(entry);
+}
+
+void Leaderboard::submit(const string& player, int episode, Difficulty difficulty, int score) {
+    submit({score, addPlayer(player), episode, difficulty, now()});
+}
+
+void Leaderboard::submitBatch(uint32_t player, int episode, Difficulty difficulty,
+                              const vector<int>& scores, const vector<uint8_t>& done) {
+    size_t slot = static_cast<size_t>(difficulty);
+    ScoreIndex& index = scoresByDifficulty[slot];
+    TopScores& overall = topByDifficulty[slot];
+    TopScores& board = episodeBoard(episode, difficulty);
+    uint32_t timestamp = now();
+
+    size_t count = min(scores.size(), done.size());
+    for (size_t i = 0; i < count; i++) {
+        if (!done[i]) continue;
+        index.add(scores[i]);
+
+        // Most batch results miss both lists; skip building the entry for them
+        if (overall.qualifies(scores[i]) || board.qualifies(scores[i])) {
+            LeaderboardEntry entry{scores[i], player, episode, difficulty, timestamp};
+            overall.offer(entry);
+            board.offer(entry);
+        }
+    }
+}
+
+uint64_t Leaderboard::getRank(int score, Difficulty difficulty) const {
+    return 1 + scoresByDifficulty[static_cast<size_t>(difficulty)].countAbove(score);
+}
+
+uint64_t Leaderboard::getRank(int score) const {
+    uint64_t above = 0;
+    for (const auto& index : scoresByDifficulty) {
+        above += index.countAbove(score);
+    }
+    return 1 + above;
+}
+
+uint64_t Leaderboard::getEntryCount(Difficulty difficulty) const {
+    return scoresByDifficulty[static_cast<size_t>(difficulty)].getTotal();
+}
+
+uint64_t Leaderboard::getEntryCount() const {
+    uint64_t count = 0;
+    for (const auto& index : scoresByDifficulty) {
+        count += index.getTotal();
+    }
+    return count;
+}
+
+vector<LeaderboardEntry> Leaderboard::getTop(Difficulty difficulty) const {
+    return topByDifficulty[static_cast<size_t>(difficulty)].getSorted();
+}
+
+vector<LeaderboardEntry> Leaderboard::getTop(int episode, Difficulty difficulty) const {
+    auto it = topByEpisode.find(episodeKey(episode, difficulty));
+    return it != topByEpisode.end() ? it->second.getSorted() : vector<LeaderboardEntry>();
+}
+
+bool Leaderboard::save(const string& path) const {
+    BinaryWriter payload;
+    payload.writeU32(static_cast<uint32_t>(players.size()));
+    for (const auto& name : players) {
+        payload.writeString(name);
+    }
+
+    // Score counts, sparse: most of the score range is never hit
+    for (const auto& index : scoresByDifficulty) {
+        vector<pair<int, uint32_t>> used;
+        if (index.getTotal() > 0) {
+            for (int score = ScoreIndex::MIN_SCORE; score <= ScoreIndex::MAX_SCORE; score++) {
+                uint32_t count = index.countAt(score);
+                if (count > 0) used.push_back({score, count});
+            }
+        }
+        payload.writeU32(static_cast<uint32_t>(used.size()));
+        for (const auto& bucket : used) {
+            payload.writeI32(bucket.first);
+            payload.writeU32(bucket.second);
+        }
+    }
+
+    for (const auto& board : topByDifficulty) {
+        payload.writeU32(static_cast<uint32_t>(board.heap.size()));
+        for (const auto& entry : board.heap) {
+            writeEntry(payload, entry);
+        }
+    }
+    payload.writeU32(static_cast<uint32_t>(topByEpisode.size()));
+    for (const auto& board : topByEpisode) {
+        payload.writeU64(board.first);
+        payload.writeU32(static_cast<uint32_t>(board.second.heap.size()));
+        for (const auto& entry : board.second.heap) {
+            writeEntry(payload, entry);
+        }
+    }
+
+    BinaryWriter file;
+    file.writeRaw(MAGIC, sizeof(MAGIC));
+    file.writeU32(FORMAT_VERSION);
+    file.writeU64(payload.size());
+    file.writeU32(checksum32(payload.getBuffer().data(), payload.size()));
+    file.writeRaw(payload.getBuffer().data(), payload.size());
+
+    error_code ec;
+    filesystem::path parent = filesystem::path(path).parent_path();
+    if (!parent.empty()) filesystem::create_directories(parent, ec);
+    return SaveSystem::writeFileAtomically(path, file.getBuffer());
+}
+
+bool Leaderboard::load(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file) return false;
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    const size_t headerSize = sizeof(MAGIC) + 4 + 8 + 4;
+    if (contents.size() < headerSize || memcmp(contents.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    BinaryReader header(contents.data() + sizeof(MAGIC), headerSize - sizeof(MAGIC));
+    uint32_t version = header.readU32();
+    uint64_t payloadSize = header.readU64();
+    uint32_t expectedChecksum = header.readU32();
+    const char* payloadData = contents.data() + headerSize;
+    if (version != FORMAT_VERSION || payloadSize != contents.size() - headerSize ||
+        checksum32(payloadData, payloadSize) != expectedChecksum) {
+        return false;
+    }
+
+    // Build into a fresh board so a bad file leaves this one alone
+    Leaderboard loaded(topCount);
+    BinaryReader in(payloadData, payloadSize);
+
+    uint32_t playerCount = in.readU32();
+    for (uint32_t i = 0; i < playerCount && in.ok(); i++) {
+        loaded.addPlayer(in.readString());
+    }
+
+    for (auto& index : loaded.scoresByDifficulty) {
+        uint32_t used = in.readU32();
+        for (uint32_t i = 0; i < used && in.ok(); i++) {
+            int score = in.readI32();
+            index.add(score, in.readU32());
+        }
+    }
+
+    for (auto& board : loaded.topByDifficulty) {
+        uint32_t count = in.readU32();
+        for (uint32_t i = 0; i < count && in.ok(); i++) {
+            board.offer(readEntry(in));
+        }
+    }
+    uint32_t boardCount = in.readU32();
+    for (uint32_t b = 0; b < boardCount && in.ok(); b++) {
+        uint64_t key = in.readU64();
+        TopScores& board = loaded.topByEpisode.emplace(key, TopScores(topCount)).first->second;
+        uint32_t count = in.readU32();
+        for (uint32_t i = 0; i < count && in.ok(); i++) {
+            board.offer(readEntry(in));
+        }
+    }
+
+    if (!in.ok()) return false;
+    *this = move(loaded);
+    return true;
+}
+
+string Leaderboard::getDefaultPath() {
+    return SaveSystem::getSaveDirectory() + "/leaderboard.dat";
+}
+
+uint64_t Leaderboard::episodeKey(int episode, Difficulty difficulty) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(episode)) << 8) | static_cast<uint8_t>(difficulty);
+}
+
+TopScores& Leaderboard::episodeBoard(int episode, Difficulty difficulty) {
+    return topByEpisode.emplace(episodeKey(episode, difficulty), TopScores(topCount)).first->second;
+}
+
+uint32_t Leaderboard::now() {
+    return static_cast<uint32_t>(chrono::duration_cast<chrono::seconds>(
+        chrono::system_clock::now().time_since_epoch()).count());
+}
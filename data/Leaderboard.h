@@ -0,0 +1,102 @@
+#pragma once
+#include "GameData.h"
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
+
+struct LeaderboardEntry {
+    int32_t score;
+    uint32_t player;    // Leaderboard::addPlayer
+    int32_t episode;
+    Difficulty difficulty;
+    uint32_t timestamp; // Unix seconds; earlier wins ties
+};
+
+// Count of results per score, as a Fenwick tree: insert and "how many
+// scored above s" are O(log range). Scores outside the range are clamped.
+class ScoreIndex {
+public:
+    static const int MIN_SCORE;
+    static const int MAX_SCORE;
+
+    ScoreIndex();
+
+    void add(int score, uint32_t count = 1);
+    uint64_t countAbove(int score) const;
+    uint64_t getTotal() const { return total; }
+    uint32_t countAt(int score) const;
+
+private:
+    std::vector<uint32_t> tree; // Empty until the first add
+    uint64_t total;
+
+    static size_t slotFor(int score);
+};
+
+// The best `capacity` entries, kept as a min-heap so a new result is
+// checked against the current cut-off in O(1)
+class TopScores {
+public:
+    explicit TopScores(size_t capacity = 10) : capacity(capacity) {}
+
+    bool offer(const LeaderboardEntry& entry); // True if it made the list
+    bool qualifies(int score) const {
+        return capacity > 0 && (heap.size() < capacity || score > heap.front().score);
+    }
+    std::vector<LeaderboardEntry> getSorted() const; // Best first
+    size_t size() const { return heap.size(); }
+
+private:
+    friend class Leaderboard;
+
+    size_t capacity;
+    std::vector<LeaderboardEntry> heap;
+};
+
+// Local leaderboard: rank queries per difficulty and overall, top-k lists
+// per difficulty and per (episode, difficulty). Persists to a small binary
+// file: player names, non-empty score counts and the top-k entries.
+class Leaderboard {
+public:
+    explicit Leaderboard(size_t topCount = 10);
+
+    uint32_t addPlayer(const std::string& name); // Existing ID if already known
+    const std::string& getPlayerName(uint32_t player) const;
+
+    void submit(const LeaderboardEntry& entry);
+    void submit(const std::string& player, int episode, Difficulty difficulty, int score);
+    // Bulk ingest in BatchStepResult's layout; only finished environments count
+    void submitBatch(uint32_t player, int episode, Difficulty difficulty,
+                     const std::vector<int>& scores, const std::vector<uint8_t>& done);
+
+    // 1 + number of results that scored strictly higher
+    uint64_t getRank(int score, Difficulty difficulty) const;
+    uint64_t getRank(int score) const;
+    uint64_t getEntryCount(Difficulty difficulty) const;
+    uint64_t getEntryCount() const;
+
+    std::vector<LeaderboardEntry> getTop(Difficulty difficulty) const;
+    std::vector<LeaderboardEntry> getTop(int episode, Difficulty difficulty) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+    static std::string getDefaultPath(); // Next to the save slots
+
+private:
+    static const char MAGIC[8];
+    static const uint32_t FORMAT_VERSION;
+
+    size_t topCount;
+    std::vector<std::string> players;
+    std::unordered_map<std::string, uint32_t> playerIds;
+
+    std::array<ScoreIndex, 4> scoresByDifficulty;
+    std::array<TopScores, 4> topByDifficulty;
+    std::unordered_map<uint64_t, TopScores> topByEpisode; // Key: episode << 8 | difficulty
+
+    static uint64_t episodeKey(int episode, Difficulty difficulty);
+    TopScores& episodeBoard(int episode, Difficulty difficulty);
+    static uint32_t now();
+};
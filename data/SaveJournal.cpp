@@ -0,0 +1,270 @@
+#include "SaveJournal.h"
+#include "SaveSystem.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const char SaveJournal::MAGIC[8] = {'D', 'S', 'P', 'J', 'R', 'N', 'L', '1'};
+
+TurnDelta TurnDelta::between(const PatternGrid& before, const PatternGrid& after) {
+    TurnDelta delta;
+    int size = after.getSize();
+    for (int row = 0; row < size; row++) {
+        const char* now = after.getRowData(row);
+        const char* old = before.getSize() == size ? before.getRowData(row) : nullptr;
+        for (int col = 0; col < size; col++) {
+            if (!old || old[col] != now[col]) {
+                delta.changes.push_back({static_cast<uint16_t>(row), static_cast<uint16_t>(col), now[col]});
+            }
+        }
+    }
+    return delta;
+}
+
+SaveJournal::SaveJournal(const string& slotName, const GameData& gameData, int currentEpisode,
+                         const GameSnapshot& base, size_t compactEvery)
+    : slotName(slotName), journalPath(getJournalPath(slotName)), compactEvery(max<size_t>(1, compactEvery)),
+      gameData(gameData), currentEpisode(currentEpisode), state(base), sinceCompaction(0), fd(-1),
+      pendingGameData(false), nextEpisode(currentEpisode), stopping(false), failed(false),
+      appended(0), durable(0) {
+
+    writer = thread(&SaveJournal::run, this);
+}
+
+SaveJournal::~SaveJournal() {
+    {
+        lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    workAvailable.notify_one();
+    writer.join();
+
+#ifndef _WIN32
+    if (fd >= 0) ::close(fd);
+#endif
+}
+
+void SaveJournal::append(TurnDelta delta) {
+    {
+        lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(move(delta));
+        appended++;
+    }
+    workAvailable.notify_one();
+}
+
+void SaveJournal::flush() {
+    unique_lock<std::mutex> lock(queueMutex);
+    progress.wait(lock, [this] { return durable == appended || failed; });
+}
+
+void SaveJournal::updateGameData(const GameData& data, int episode) {
+    lock_guard<std::mutex> lock(queueMutex);
+    nextGameData = data;
+    nextEpisode = episode;
+    pendingGameData = true;
+}
+
+size_t SaveJournal::getAppendedCount() const {
+    lock_guard<std::mutex> lock(queueMutex);
+    return appended;
+}
+
+size_t SaveJournal::getDurableCount() const {
+    lock_guard<std::mutex> lock(queueMutex);
+    return durable;
+}
+
+bool SaveJournal::hasFailed() const {
+    lock_guard<std::mutex> lock(queueMutex);
+    return failed;
+}
+
+bool SaveJournal::recover(const string& slotName, GameData& gameData, int& currentEpisode,
+                          GameSnapshot& snapshot) {
+    GameData loadedData;
+    GameSnapshot loadedSnapshot;
+    int episode = 1;
+    if (!SaveSystem::loadGame(slotName, loadedData, episode, &loadedSnapshot)) {
+        return false;
+    }
+
+    ifstream file(getJournalPath(slotName), ios::binary);
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    if (contents.size() >= sizeof(MAGIC) && memcmp(contents.data(), MAGIC, sizeof(MAGIC)) == 0) {
+        BinaryReader in(contents.data() + sizeof(MAGIC), contents.size() - sizeof(MAGIC));
+        while (in.remaining() >= 8) {
+            uint32_t length = in.readU32();
+            uint32_t expected = in.readU32();
+            if (length > in.remaining()) break; // Torn tail
+
+            const char* record = contents.data() + sizeof(MAGIC) + in.position();
+            if (checksum32(record, length) != expected) break;
+
+            BinaryReader recordReader(record, length);
+            TurnDelta delta;
+            if (!decode(recordReader, delta)) break;
+            in.skip(length);
+
+            // Deltas already folded into the snapshot are skipped, so a crash
+            // between compaction and truncation replays safely
+            if (delta.turn > loadedSnapshot.currentTurn) {
+                applyDelta(loadedSnapshot, delta);
+            }
+        }
+    }
+
+    gameData = move(loadedData);
+    currentEpisode = episode;
+    snapshot = move(loadedSnapshot);
+    return true;
+}
+
+void SaveJournal::applyDelta(GameSnapshot& snapshot, const TurnDelta& delta) {
+    for (const auto& change : delta.changes) {
+        snapshot.builderGrid.setCell(change.row, change.col, change.value);
+    }
+    snapshot.currentTurn = delta.turn;
+    snapshot.messagesUsed = delta.messagesUsed;
+    snapshot.elapsedSeconds = delta.elapsedSeconds;
+    if (!delta.messageReceived.empty()) snapshot.messagesReceived.push_back(delta.messageReceived);
+    if (!delta.messageSent.empty()) snapshot.messagesSent.push_back(delta.messageSent);
+}
+
+void SaveJournal::discard(const string& slotName) {
+    error_code ec;
+    filesystem::remove(getJournalPath(slotName), ec);
+    SaveSystem::deleteSave(slotName);
+}
+
+string SaveJournal::getJournalPath(const string& slotName) {
+    string path = SaveSystem::getSaveFilePath(slotName);
+    return path.substr(0, path.size() - 4) + ".journal";
+}
+
+void SaveJournal::run() {
+    bool ok = compact(); // Start from a snapshot of the base state
+
+    unique_lock<std::mutex> lock(queueMutex);
+    failed = !ok;
+    progress.notify_all();
+
+    while (true) {
+        workAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty() && stopping) break;
+
+        vector<TurnDelta> batch;
+        batch.swap(queue);
+        if (pendingGameData) {
+            gameData = nextGameData;
+            currentEpisode = nextEpisode;
+            pendingGameData = false;
+        }
+        lock.unlock();
+
+        ok = writeBatch(batch);
+        for (const auto& delta : batch) {
+            applyDelta(state, delta);
+        }
+        sinceCompaction += batch.size();
+        if (ok && sinceCompaction >= compactEvery) {
+            ok = compact();
+        }
+
+        lock.lock();
+        durable += batch.size();
+        failed = failed || !ok;
+        progress.notify_all();
+    }
+}
+
+bool SaveJournal::writeBatch(const vector<TurnDelta>& batch) {
+    BinaryWriter out;
+    BinaryWriter record;
+    for (const auto& delta : batch) {
+        record.clear();
+        encode(record, delta);
+        out.writeU32(static_cast<uint32_t>(record.size()));
+        out.writeU32(checksum32(record.getBuffer().data(), record.size()));
+        out.writeRaw(record.getBuffer().data(), record.size());
+    }
+
+#ifndef _WIN32
+    if (fd < 0) return false;
+    const string& data = out.getBuffer();
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n <= 0) return false;
+        written += static_cast<size_t>(n);
+    }
+    return ::fdatasync(fd) == 0;
+#else
+    ofstream file(journalPath, ios::binary | ios::app);
+    file.write(out.getBuffer().data(), out.size());
+    file.flush();
+    return static_cast<bool>(file);
+#endif
+}
+
+bool SaveJournal::compact() {
+    if (!SaveSystem::saveGame(slotName, gameData, currentEpisode, &state)) {
+        return false;
+    }
+    sinceCompaction = 0;
+
+    // The snapshot now covers everything journaled so far
+#ifndef _WIN32
+    if (fd < 0) {
+        fd = ::open(journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) return false;
+    }
+    if (::ftruncate(fd, 0) != 0) return false;
+    if (::write(fd, MAGIC, sizeof(MAGIC)) != static_cast<ssize_t>(sizeof(MAGIC))) return false;
+    return ::fdatasync(fd) == 0;
+#else
+    ofstream file(journalPath, ios::binary | ios::trunc);
+    file.write(MAGIC, sizeof(MAGIC));
+    return static_cast<bool>(file);
+#endif
+}
+
+void SaveJournal::encode(BinaryWriter& out, const TurnDelta& delta) {
+    out.writeI32(delta.turn);
+    out.writeI32(delta.messagesUsed);
+    out.writeI64(delta.elapsedSeconds);
+    out.writeString(delta.messageReceived);
+    out.writeString(delta.messageSent);
+    out.writeU32(static_cast<uint32_t>(delta.changes.size()));
+    for (const auto& change : delta.changes) {
+        out.writeU32((static_cast<uint32_t>(change.row) << 16) | change.col);
+        out.writeU8(static_cast<uint8_t>(change.value));
+    }
+}
+
+bool SaveJournal::decode(BinaryReader& in, TurnDelta& delta) {
+    delta.turn = in.readI32();
+    delta.messagesUsed = in.readI32();
+    delta.elapsedSeconds = in.readI64();
+    delta.messageReceived = in.readString();
+    delta.messageSent = in.readString();
+
+    uint32_t count = in.readU32();
+    if (!in.ok() || count > in.remaining() / 5) return false;
+    delta.changes.resize(count);
+    for (auto& change : delta.changes) {
+        uint32_t position = in.readU32();
+        change.row = static_cast<uint16_t>(position >> 16);
+        change.col = static_cast<uint16_t>(position & 0xFFFF);
+        change.value = static_cast<char>(in.readU8());
+    }
+    return in.ok();
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "GameData.h"
+#include "BinaryIO.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+struct CellChange {
+    uint16_t row;
+    uint16_t col;
+    char value;
+};
+
+// What one turn changed, relative to the previous turn
+struct TurnDelta {
+    int turn = 0;
+    int messagesUsed = 0;
+    int64_t elapsedSeconds = 0;
+    std::string messageReceived;
+    std::string messageSent;
+    std::vector<CellChange> changes;
+
+    static TurnDelta between(const PatternGrid& before, const PatternGrid& after);
+};
+
+// Journaled autosave. append() only queues the delta; a background thread
+// writes queued deltas in one batch, fsyncs, and every compactEvery deltas
+// folds them into a fresh SaveSystem snapshot and truncates the journal.
+// Recovery loads the snapshot and replays the journal tail.
+class SaveJournal {
+public:
+    SaveJournal(const std::string& slotName, const GameData& gameData, int currentEpisode,
+                const GameSnapshot& base, size_t compactEvery = 32);
+    ~SaveJournal(); // Drains the queue
+    SaveJournal(const SaveJournal&) = delete;
+    SaveJournal& operator=(const SaveJournal&) = delete;
+
+    void append(TurnDelta delta); // Never touches the disk
+    void flush();                 // Blocks until everything appended is durable
+    void updateGameData(const GameData& gameData, int currentEpisode); // Taken at next compaction
+
+    size_t getAppendedCount() const;
+    size_t getDurableCount() const;
+    bool hasFailed() const;
+
+    static bool recover(const std::string& slotName, GameData& gameData, int& currentEpisode,
+                        GameSnapshot& snapshot);
+    static void applyDelta(GameSnapshot& snapshot, const TurnDelta& delta);
+    static void discard(const std::string& slotName); // Removes the snapshot and journal
+    static std::string getJournalPath(const std::string& slotName);
+
+private:
+    static const char MAGIC[8];
+
+    std::string slotName;
+    std::string journalPath;
+    size_t compactEvery;
+
+    // Owned by the writer thread
+    GameData gameData;
+    int currentEpisode;
+    GameSnapshot state;
+    size_t sinceCompaction;
+    int fd;
+
+    // Shared, guarded by queueMutex
+    mutable std::mutex queueMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable progress;
+    std::vector<TurnDelta> queue;
+    bool pendingGameData;
+    GameData nextGameData;
+    int nextEpisode;
+    bool stopping;
+    bool failed;
+    size_t appended;
+    size_t durable;
+
+    std::thread writer;
+
+    void run();
+    bool writeBatch(const std::vector<TurnDelta>& batch);
+    bool compact();
+    static void encode(BinaryWriter& out, const TurnDelta& delta);
+    static bool decode(BinaryReader& in, TurnDelta& delta);
+};
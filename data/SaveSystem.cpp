@@ -2,39 +2,382 @@
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-bool SaveSystem::saveGame(const string& slotName, const GameData& gameData, int currentEpisode) {
-    // In a real implementation, this would serialize to file
-    // For this example, we'll just return success
+const char SaveSystem::MAGIC[8] = {'D', 'S', 'P', 'S', 'A', 'V', 'E', '1'};
+const uint32_t SaveSystem::FORMAT_VERSION = 1;
+const size_t SaveSystem::MAX_PERSISTED_HISTORY = 100;
+
+string SaveSystem::saveDirectory = "saves";
+vector<string> SaveSystem::cachedSlots;
+filesystem::file_time_type SaveSystem::cachedDirectoryTime;
+bool SaveSystem::slotCacheValid = false;
+mutex SaveSystem::cacheMutex;
+
+namespace {
+
+const uint32_t FLAG_HAS_SNAPSHOT = 1;
+
+// magic, version, flags, payload size, payload checksum
+const size_t HEADER_SIZE = 8 + 4 + 4 + 8 + 4;
+
+}
+
+bool SaveSystem::saveGame(const string& slotName, const GameData& gameData, int currentEpisode,
+                          const GameSnapshot* snapshot) {
+    BinaryWriter payload;
+    payload.writeI32(currentEpisode);
+    writeGameData(payload, gameData);
+    if (snapshot) {
+        writeSnapshot(payload, *snapshot);
+    }
+    
+    BinaryWriter file;
+    file.writeRaw(MAGIC, sizeof(MAGIC));
+    file.writeU32(FORMAT_VERSION);
+    file.writeU32(snapshot ? FLAG_HAS_SNAPSHOT : 0);
+    file.writeU64(payload.size());
+    file.writeU32(checksum32(payload.getBuffer().data(), payload.size()));
+    file.writeRaw(payload.getBuffer().data(), payload.size());
+    
+    error_code ec;
+    filesystem::create_directories(saveDirectory, ec);
+    if (!writeFileAtomically(getSaveFilePath(slotName), file.getBuffer())) {
+        return false;
+    }
+    
+    noteSlotWritten(slotName);
     return true;
 }
 
-bool SaveSystem::loadGame(const string& slotName, GameData& gameData, int& currentEpisode) {
-    // In a real implementation, this would deserialize from file
-    // For this example, we'll just return false (no save system implemented)
-    return false;
+bool SaveSystem::loadGame(const string& slotName, GameData& gameData, int& currentEpisode,
+                          GameSnapshot* snapshot) {
+    ifstream file(getSaveFilePath(slotName), ios::binary);
+    if (!file) return false;
+    
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    if (contents.size() < HEADER_SIZE || memcmp(contents.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    
+    BinaryReader header(contents.data() + sizeof(MAGIC), HEADER_SIZE - sizeof(MAGIC));
+    uint32_t version = header.readU32();
+    uint32_t flags = header.readU32();
+    uint64_t payloadSize = header.readU64();
+    uint32_t expectedChecksum = header.readU32();
+    
+    const char* payloadData = contents.data() + HEADER_SIZE;
+    if (!header.ok() || version != FORMAT_VERSION ||
+        payloadSize != contents.size() - HEADER_SIZE ||
+        checksum32(payloadData, payloadSize) != expectedChecksum) {
+        return false;
+    }
+    
+    // Decode into temporaries so a bad file leaves the caller's state alone
+    BinaryReader in(payloadData, payloadSize);
+    int episode = in.readI32();
+    GameData loaded;
+    if (!readGameData(in, loaded)) return false;
+    
+    GameSnapshot loadedSnapshot;
+    bool hasSnapshot = (flags & FLAG_HAS_SNAPSHOT) != 0;
+    if (hasSnapshot && !readSnapshot(in, loadedSnapshot)) return false;
+    
+    gameData = move(loaded);
+    currentEpisode = episode;
+    if (snapshot) {
+        *snapshot = hasSnapshot ? move(loadedSnapshot) : GameSnapshot();
+    }
+    return true;
 }
 
 vector<string> SaveSystem::getSaveSlots() {
-    // Mock implementation - in real game would scan save directory
-    return {"Auto Save", "Manual Save 1", "Manual Save 2"};
+    lock_guard<mutex> lock(cacheMutex);
+    error_code ec;
+    auto directoryTime = filesystem::last_write_time(saveDirectory, ec);
+    if (ec) {
+        cachedSlots.clear();
+        slotCacheValid = false;
+        return cachedSlots;
+    }
+    
+    if (slotCacheValid && directoryTime == cachedDirectoryTime) {
+        return cachedSlots;
+    }
+    
+    cachedSlots.clear();
+    for (const auto& entry : filesystem::directory_iterator(saveDirectory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".sav") {
+            cachedSlots.push_back(entry.path().stem().string());
+        }
+    }
+    sort(cachedSlots.begin(), cachedSlots.end());
+    
+    cachedDirectoryTime = directoryTime;
+    slotCacheValid = true;
+    return cachedSlots;
 }
 
 bool SaveSystem::deleteSave(const string& slotName) {
-    // Mock implementation
-    return true;
+    error_code ec;
+    bool removed = filesystem::remove(getSaveFilePath(slotName), ec);
+    
+    lock_guard<mutex> lock(cacheMutex);
+    if (removed && slotCacheValid) {
+        cachedSlots.erase(remove(cachedSlots.begin(), cachedSlots.end(), sanitizeFilename(slotName)),
+                          cachedSlots.end());
+        cachedDirectoryTime = filesystem::last_write_time(saveDirectory, ec);
+    }
+    return removed;
 }
 
 bool SaveSystem::saveExists(const string& slotName) {
-    // Mock implementation - always return false for simplicity
-    return false;
+    error_code ec;
+    return filesystem::is_regular_file(getSaveFilePath(slotName), ec);
+}
+
+void SaveSystem::setSaveDirectory(const string& directory) {
+    lock_guard<mutex> lock(cacheMutex);
+    saveDirectory = directory;
+    slotCacheValid = false;
+}
+
+bool SaveSystem::writeFileAtomically(const string& path, const string& contents) {
+    string tempPath = path + ".tmp";
+    
+#ifndef _WIN32
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    
+    size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t n = ::write(fd, contents.data() + written, contents.size() - written);
+        if (n <= 0) {
+            ::close(fd);
+            ::unlink(tempPath.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || ::rename(tempPath.c_str(), path.c_str()) != 0) {
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    
+    // Persist the rename itself
+    string directory = filesystem::path(path).parent_path().string();
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+#else
+    {
+        ofstream out(tempPath, ios::binary | ios::trunc);
+        out.write(contents.data(), contents.size());
+        out.flush();
+        if (!out) return false;
+    }
+    error_code ec;
+    filesystem::rename(tempPath, path, ec);
+    return !ec;
+#endif
+}
+
+void SaveSystem::writeGameData(BinaryWriter& out, const GameData& gameData) {
+    out.writeU8(static_cast<uint8_t>(gameData.currentDifficulty));
+    out.writeI32(gameData.skillPoints);
+    out.writeI32(gameData.currentEpisode);
+    out.writeU8(gameData.tutorialEnabled ? 1 : 0);
+    
+    const auto& words = gameData.unlockedAchievements.getWords();
+    out.writeU32(static_cast<uint32_t>(words.size()));
+    for (uint64_t word : words) {
+        out.writeU64(word);
+    }
+    
+    writeStatistics(out, gameData.overall);
+    for (const auto& statistics : gameData.byDifficulty) {
+        writeStatistics(out, statistics);
+    }
+    
+    // Only the most recent games; statistics above cover the rest
+    const auto& history = gameData.gameHistory;
+    size_t first = history.size() > MAX_PERSISTED_HISTORY ? history.size() - MAX_PERSISTED_HISTORY : 0;
+    out.writeU32(static_cast<uint32_t>(history.size() - first));
+    for (size_t i = first; i < history.size(); i++) {
+        const GameMetrics& metrics = history[i];
+        out.writeF64(metrics.accuracy);
+        out.writeI32(metrics.turnsTaken);
+        out.writeI32(metrics.messagesUsed);
+        out.writeI32(metrics.messengerMistakes);
+        out.writeI32(metrics.dispatcherClarity);
+        out.writeI64(metrics.timeElapsed.count());
+        out.writeI32(metrics.score);
+        out.writeF64(metrics.communicationEfficiency);
+        out.writeF64(metrics.errorRecoveryRate);
+        out.writeF64(metrics.patternRecognitionScore);
+    }
+}
+
+bool SaveSystem::readGameData(BinaryReader& in, GameData& gameData) {
+    uint8_t difficulty = in.readU8();
+    if (difficulty > static_cast<uint8_t>(Difficulty::EXPERT)) return false;
+    gameData.currentDifficulty = static_cast<Difficulty>(difficulty);
+    gameData.skillPoints = in.readI32();
+    gameData.currentEpisode = in.readI32();
+    gameData.tutorialEnabled = in.readU8() != 0;
+    
+    gameData.unlockedAchievements = AchievementSet();
+    uint32_t wordCount = in.readU32();
+    auto& words = gameData.unlockedAchievements.getWords();
+    for (uint32_t i = 0; i < wordCount && in.ok(); i++) {
+        uint64_t word = in.readU64();
+        if (i < words.size()) words[i] = word;
+    }
+    
+    gameData.overall = GameStatistics();
+    gameData.byDifficulty.fill(GameStatistics());
+    readStatistics(in, gameData.overall);
+    for (auto& statistics : gameData.byDifficulty) {
+        readStatistics(in, statistics);
+    }
+    
+    uint32_t historyCount = in.readU32();
+    gameData.gameHistory.clear();
+    for (uint32_t i = 0; i < historyCount && in.ok(); i++) {
+        GameMetrics metrics{};
+        metrics.accuracy = in.readF64();
+        metrics.turnsTaken = in.readI32();
+        metrics.messagesUsed = in.readI32();
+        metrics.messengerMistakes = in.readI32();
+        metrics.dispatcherClarity = in.readI32();
+        metrics.timeElapsed = chrono::seconds(in.readI64());
+        metrics.score = in.readI32();
+        metrics.communicationEfficiency = in.readF64();
+        metrics.errorRecoveryRate = in.readF64();
+        metrics.patternRecognitionScore = in.readF64();
+        gameData.gameHistory.push_back(metrics);
+    }
+    
+    return in.ok();
+}
+
+void SaveSystem::writeStatistics(BinaryWriter& out, const GameStatistics& statistics) {
+    writeMetricStats(out, statistics.accuracy);
+    writeMetricStats(out, statistics.score);
+    writeMetricStats(out, statistics.turns);
+    writeMetricStats(out, statistics.time);
+}
+
+bool SaveSystem::readStatistics(BinaryReader& in, GameStatistics& statistics) {
+    return readMetricStats(in, statistics.accuracy) && readMetricStats(in, statistics.score) &&
+           readMetricStats(in, statistics.turns) && readMetricStats(in, statistics.time);
+}
+
+void SaveSystem::writeMetricStats(BinaryWriter& out, const MetricStats& stats) {
+    const RunningStats& summary = stats.summary;
+    out.writeU64(summary.count);
+    out.writeF64(summary.mean);
+    out.writeF64(summary.m2);
+    out.writeF64(summary.minValue);
+    out.writeF64(summary.maxValue);
+    
+    // Histograms are sparse in practice: store (bucket, count) pairs
+    const LogHistogram& histogram = stats.distribution;
+    uint32_t used = static_cast<uint32_t>(
+        count_if(histogram.counts.begin(), histogram.counts.end(), [](uint64_t c) { return c > 0; }));
+    out.writeU32(used);
+    for (size_t i = 0; i < histogram.counts.size(); i++) {
+        if (histogram.counts[i] > 0) {
+            out.writeU32(static_cast<uint32_t>(i));
+            out.writeU64(histogram.counts[i]);
+        }
+    }
+    out.writeF64(histogram.minValue);
+    out.writeF64(histogram.maxValue);
+}
+
+bool SaveSystem::readMetricStats(BinaryReader& in, MetricStats& stats) {
+    RunningStats& summary = stats.summary;
+    summary.count = in.readU64();
+    summary.mean = in.readF64();
+    summary.m2 = in.readF64();
+    summary.minValue = in.readF64();
+    summary.maxValue = in.readF64();
+    
+    LogHistogram& histogram = stats.distribution;
+    uint32_t used = in.readU32();
+    if (!in.ok() || used > LogHistogram::BUCKET_COUNT) return false;
+    histogram.counts.clear();
+    histogram.total = 0;
+    if (used > 0) histogram.counts.assign(LogHistogram::BUCKET_COUNT, 0);
+    for (uint32_t i = 0; i < used; i++) {
+        uint32_t bucket = in.readU32();
+        uint64_t count = in.readU64();
+        if (!in.ok() || bucket >= LogHistogram::BUCKET_COUNT) return false;
+        histogram.counts[bucket] = count;
+        histogram.total += count;
+    }
+    histogram.minValue = in.readF64();
+    histogram.maxValue = in.readF64();
+    return in.ok();
+}
+
+void SaveSystem::writeSnapshot(BinaryWriter& out, const GameSnapshot& snapshot) {
+    writeGrid(out, snapshot.target);
+    writeGrid(out, snapshot.builderGrid);
+    out.writeU8(static_cast<uint8_t>(snapshot.difficulty));
+    out.writeI32(snapshot.currentTurn);
+    out.writeI32(snapshot.totalTurns);
+    out.writeI32(snapshot.messagesUsed);
+    out.writeI64(snapshot.elapsedSeconds);
+    
+    out.writeU32(static_cast<uint32_t>(snapshot.messagesReceived.size()));
+    for (const auto& message : snapshot.messagesReceived) out.writeString(message);
+    out.writeU32(static_cast<uint32_t>(snapshot.messagesSent.size()));
+    for (const auto& message : snapshot.messagesSent) out.writeString(message);
+}
+
+bool SaveSystem::readSnapshot(BinaryReader& in, GameSnapshot& snapshot) {
+    if (!readGrid(in, snapshot.target) || !readGrid(in, snapshot.builderGrid)) return false;
+    
+    uint8_t difficulty = in.readU8();
+    if (difficulty > static_cast<uint8_t>(Difficulty::EXPERT)) return false;
+    snapshot.difficulty = static_cast<Difficulty>(difficulty);
+    snapshot.currentTurn = in.readI32();
+    snapshot.totalTurns = in.readI32();
+    snapshot.messagesUsed = in.readI32();
+    snapshot.elapsedSeconds = in.readI64();
+    
+    uint32_t receivedCount = in.readU32();
+    snapshot.messagesReceived.clear();
+    for (uint32_t i = 0; i < receivedCount && in.ok(); i++) {
+        snapshot.messagesReceived.push_back(in.readString());
+    }
+    uint32_t sentCount = in.readU32();
+    snapshot.messagesSent.clear();
+    for (uint32_t i = 0; i < sentCount && in.ok(); i++) {
+        snapshot.messagesSent.push_back(in.readString());
+    }
+    
+    return in.ok();
 }
 
 string SaveSystem::getSaveFilePath(const string& slotName) {
     string cleanName = sanitizeFilename(slotName);
-    return "saves/" + cleanName + ".sav";
+    return (filesystem::path(saveDirectory) / (cleanName + ".sav")).string();
 }
 
 string SaveSystem::sanitizeFilename(const string& name) {
@@ -49,4 +392,44 @@ string SaveSystem::sanitizeFilename(const string& name) {
     }
     
     return result;
+}
+
+void SaveSystem::writeGrid(BinaryWriter& out, const PatternGrid& grid) {
+    int size = grid.getSize();
+    out.writeI32(size);
+    for (int row = 0; row < size; row++) {
+        out.writeRaw(grid.getRowData(row), size);
+    }
+}
+
+bool SaveSystem::readGrid(BinaryReader& in, PatternGrid& grid) {
+    int32_t size = in.readI32();
+    if (!in.ok() || size < 0 || static_cast<uint64_t>(size) * size > in.remaining()) {
+        return false;
+    }
+    
+    PatternGrid loaded(size);
+    string row(size, '_');
+    for (int r = 0; r < size; r++) {
+        in.readRaw(&row[0], size);
+        for (int c = 0; c < size; c++) {
+            loaded.setCell(r, c, row[c]);
+        }
+    }
+    grid = move(loaded);
+    return in.ok();
+}
+
+void SaveSystem::noteSlotWritten(const string& slotName) {
+    lock_guard<mutex> lock(cacheMutex);
+    if (!slotCacheValid) return;
+    
+    string name = sanitizeFilename(slotName);
+    if (!binary_search(cachedSlots.begin(), cachedSlots.end(), name)) {
+        cachedSlots.insert(lower_bound(cachedSlots.begin(), cachedSlots.end(), name), name);
+    }
+    
+    error_code ec;
+    cachedDirectoryTime = filesystem::last_write_time(saveDirectory, ec);
+    if (ec) slotCacheValid = false;
 }
\ No newline at end of file
@@ -1,17 +1,53 @@
 #pragma once
 #include "GameData.h"
+#include "BinaryIO.h"
 #include <string>
 #include <vector>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
 
 class SaveSystem {
 public:
-    static bool saveGame(const std::string& slotName, const GameData& gameData, int currentEpisode);
-    static bool loadGame(const std::string& slotName, GameData& gameData, int& currentEpisode);
-    static std::vector<std::string> getSaveSlots();
+    // Binary, versioned, checksummed; written to a temp file, fsync'd and
+    // renamed into place so a crash never leaves a torn save
+    static bool saveGame(const std::string& slotName, const GameData& gameData, int currentEpisode,
+                         const GameSnapshot* snapshot = nullptr);
+    static bool loadGame(const std::string& slotName, GameData& gameData, int& currentEpisode,
+                         GameSnapshot* snapshot = nullptr);
+    static std::vector<std::string> getSaveSlots(); // Rescans only when the directory changes
     static bool deleteSave(const std::string& slotName);
     static bool saveExists(const std::string& slotName);
-    
-private:
+
+    static void setSaveDirectory(const std::string& directory);
+    static const std::string& getSaveDirectory() { return saveDirectory; }
+
+    static bool writeFileAtomically(const std::string& path, const std::string& contents);
     static std::string getSaveFilePath(const std::string& slotName);
+
+    // Payload encoding, shared with the journal's snapshots
+    static void writeGameData(BinaryWriter& out, const GameData& gameData);
+    static bool readGameData(BinaryReader& in, GameData& gameData);
+    static void writeSnapshot(BinaryWriter& out, const GameSnapshot& snapshot);
+    static bool readSnapshot(BinaryReader& in, GameSnapshot& snapshot);
+
+private:
+    static const char MAGIC[8];
+    static const uint32_t FORMAT_VERSION;
+    static const size_t MAX_PERSISTED_HISTORY; // Older games survive only in the statistics
+
+    static std::string saveDirectory;
+    static std::vector<std::string> cachedSlots;
+    static std::filesystem::file_time_type cachedDirectoryTime;
+    static bool slotCacheValid;
+    static std::mutex cacheMutex; // Saves may come from the journal's writer thread
+
     static std::string sanitizeFilename(const std::string& name);
-};
\ No newline at end of file
+    static void writeGrid(BinaryWriter& out, const PatternGrid& grid);
+    static bool readGrid(BinaryReader& in, PatternGrid& grid);
+    static void noteSlotWritten(const std::string& slotName);
+    static void writeStatistics(BinaryWriter& out, const GameStatistics& statistics);
+    static bool readStatistics(BinaryReader& in, GameStatistics& statistics);
+    static void writeMetricStats(BinaryWriter& out, const MetricStats& stats);
+    static bool readMetricStats(BinaryReader& in, MetricStats& stats);
+};
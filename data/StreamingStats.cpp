@@ -0,0 +1,120 @@
+#include "StreamingStats.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const int LogHistogram::SUB_BUCKET_BITS = 4;
+const int LogHistogram::MIN_EXPONENT = -4;
+const int LogHistogram::MAX_EXPONENT = 20;
+const size_t LogHistogram::BUCKET_COUNT = 1 + ((MAX_EXPONENT - MIN_EXPONENT) << SUB_BUCKET_BITS);
+
+RunningStats::RunningStats() : count(0), mean(0.0), m2(0.0), minValue(0.0), maxValue(0.0) {}
+
+void RunningStats::add(double value) {
+    count++;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+
+    if (count == 1) {
+        minValue = maxValue = value;
+    } else {
+        minValue = min(minValue, value);
+        maxValue = max(maxValue, value);
+    }
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    uint64_t combined = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / combined;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / combined);
+    count = combined;
+    minValue = min(minValue, other.minValue);
+    maxValue = max(maxValue, other.maxValue);
+}
+
+double RunningStats::getVariance() const {
+    return count > 1 ? m2 / (count - 1) : 0.0;
+}
+
+double RunningStats::getStdDev() const {
+    return sqrt(getVariance());
+}
+
+LogHistogram::LogHistogram() : total(0), minValue(0.0), maxValue(0.0) {}
+
+void LogHistogram::add(double value) {
+    if (!(value > 0.0)) value = 0.0; // Also catches NaN
+    if (counts.empty()) counts.assign(BUCKET_COUNT, 0);
+
+    counts[bucketFor(value)]++;
+    if (total == 0) {
+        minValue = maxValue = value;
+    } else {
+        minValue = min(minValue, value);
+        maxValue = max(maxValue, value);
+    }
+    total++;
+}
+
+void LogHistogram::merge(const LogHistogram& other) {
+    if (other.total == 0) return;
+    if (total == 0) {
+        *this = other;
+        return;
+    }
+
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    minValue = min(minValue, other.minValue);
+    maxValue = max(maxValue, other.maxValue);
+}
+
+double LogHistogram::percentile(double percent) const {
+    if (total == 0) return 0.0;
+
+    percent = max(0.0, min(100.0, percent));
+    uint64_t rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(percent / 100.0 * total)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return max(minValue, min(maxValue, bucketValue(i)));
+        }
+    }
+    return maxValue;
+}
+
+size_t LogHistogram::bucketFor(double value) {
+    if (value < ldexp(1.0, MIN_EXPONENT)) return 0;
+
+    int exponent;
+    double mantissa = frexp(value, &exponent); // value = mantissa * 2^exponent, mantissa in [0.5, 1)
+    int octave = exponent - 1 - MIN_EXPONENT;
+    if (octave >= MAX_EXPONENT - MIN_EXPONENT) return BUCKET_COUNT - 1;
+
+    int subBucket = static_cast<int>((mantissa * 2.0 - 1.0) * (1 << SUB_BUCKET_BITS));
+    return 1 + (static_cast<size_t>(octave) << SUB_BUCKET_BITS) + subBucket;
+}
+
+double LogHistogram::bucketValue(size_t bucket) {
+    if (bucket == 0) return 0.0;
+
+    int octave = static_cast<int>((bucket - 1) >> SUB_BUCKET_BITS);
+    int subBucket = static_cast<int>((bucket - 1) & ((1 << SUB_BUCKET_BITS) - 1));
+    double width = 1.0 / (1 << SUB_BUCKET_BITS);
+
+    // Midpoint of [2^e * (1 + sub/16), 2^e * (1 + (sub+1)/16))
+    return ldexp(1.0 + (subBucket + 0.5) * width, octave + MIN_EXPONENT);
+}
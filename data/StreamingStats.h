@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Count, mean, variance (Welford), min and max in constant memory
+class RunningStats {
+public:
+    RunningStats();
+
+    void add(double value);
+    void merge(const RunningStats& other);
+
+    uint64_t getCount() const { return count; }
+    double getMean() const { return mean; }
+    double getVariance() const; // Sample variance
+    double getStdDev() const;
+    double getMin() const { return count > 0 ? minValue : 0.0; }
+    double getMax() const { return count > 0 ? maxValue : 0.0; }
+
+private:
+    friend class SaveSystem;
+
+    uint64_t count;
+    double mean;
+    double m2;
+    double minValue;
+    double maxValue;
+};
+
+// HDR-style histogram: 16 linear sub-buckets per power of two, so any
+// percentile is within ~3% of the true value. Fixed size once the first
+// value arrives; negative values count as zero.
+class LogHistogram {
+public:
+    LogHistogram();
+
+    void add(double value);
+    void merge(const LogHistogram& other);
+
+    uint64_t getCount() const { return total; }
+    double percentile(double percent) const; // percent in [0, 100]
+
+private:
+    friend class SaveSystem;
+
+    static const int SUB_BUCKET_BITS;
+    static const int MIN_EXPONENT; // Values below 2^MIN_EXPONENT share bucket 0
+    static const int MAX_EXPONENT; // Values above 2^MAX_EXPONENT share the last bucket
+    static const size_t BUCKET_COUNT;
+
+    std::vector<uint64_t> counts; // Empty until the first add
+    uint64_t total;
+    double minValue;
+    double maxValue;
+
+    static size_t bucketFor(double value);
+    static double bucketValue(size_t bucket);
+};
+
+struct MetricStats {
+    RunningStats summary;
+    LogHistogram distribution;
+
+    void add(double value) {
+        summary.add(value);
+        distribution.add(value);
+    }
+    void merge(const MetricStats& other) {
+        summary.merge(other.summary);
+        distribution.merge(other.distribution);
+    }
+};
@@ -0,0 +1,248 @@
+#include "BatchEnvironment.h"
+#include "EpisodeManager.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+const int BatchEnvironment::MIN_ENVS_PER_THREAD = 64;
+
+BatchEnvironment::BatchEnvironment(int gridSize, Difficulty difficulty, uint64_t seed)
+    : gridSize(gridSize), cellsPerGrid(gridSize * gridSize), count(0), threadCount(1),
+      noiseEnabled(true), baseSeed(seed), difficulty(difficulty),
+      settings(DispatchGame::getDifficultySettings(difficulty)),
+      symbols(EpisodeManager::getSymbolsForDifficulty(difficulty)), bounds(gridSize) {
+
+    noise.setNoiseLevel(settings.noiseLevel);
+}
+
+void BatchEnvironment::reset(int newCount) {
+    resize(max(0, newCount));
+
+    for (int i = 0; i < count; i++) {
+        // Each slot gets its own stream so results don't depend on thread count
+        RandomStream stream(baseSeed ^ (static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL));
+        generateTarget(i, stream);
+        rngStates[i] = stream.getState();
+        startEpisode(i);
+    }
+}
+
+bool BatchEnvironment::reset(const vector<PatternGrid>& newTargets) {
+    for (const auto& target : newTargets) {
+        if (target.getSize() != gridSize) return false;
+    }
+    resize(static_cast<int>(newTargets.size()));
+
+    for (int i = 0; i < count; i++) {
+        char* target = targets.data() + i * cellsPerGrid;
+        for (int row = 0; row < gridSize; row++) {
+            copy_n(newTargets[i].getRowData(row), gridSize, target + row * gridSize);
+        }
+
+        RandomStream stream(baseSeed ^ (static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL));
+        rngStates[i] = stream.getState();
+        startEpisode(i);
+    }
+    return true;
+}
+
+void BatchEnvironment::resetEnvironment(int index) {
+    if (index < 0 || index >= count) return;
+
+    RandomStream stream;
+    stream.setState(rngStates[index]);
+    generateTarget(index, stream);
+    rngStates[index] = stream.getState();
+    startEpisode(index);
+}
+
+const BatchStepResult& BatchEnvironment::step(const vector<string>& messages) {
+    parallelFor(min(count, static_cast<int>(messages.size())), &messages, nullptr);
+    return result;
+}
+
+const BatchStepResult& BatchEnvironment::stepCommands(const vector<ParsedCommand>& commands) {
+    parallelFor(min(count, static_cast<int>(commands.size())), nullptr, &commands);
+    return result;
+}
+
+void BatchEnvironment::setThreadCount(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(thread::hardware_concurrency());
+    }
+    threadCount = max(1, threads);
+    pool.resize(threadCount);
+}
+
+bool BatchEnvironment::allDone() const {
+    return all_of(result.done.begin(), result.done.end(), [](uint8_t d) { return d != 0; });
+}
+
+GameMetrics BatchEnvironment::calculateMetrics(int index) const {
+    GameMetrics metrics{};
+    metrics.accuracy = accuracyOf(index);
+    metrics.turnsTaken = turns[index];
+    metrics.messagesUsed = messagesUsed[index];
+    metrics.timeElapsed = chrono::seconds(0);
+    metrics.score = DispatchGame::computeScore(metrics.accuracy, metrics.turnsTaken, metrics.messagesUsed,
+                                               settings.maxTurns, settings.messageLimit);
+    return metrics;
+}
+
+PatternGrid BatchEnvironment::getGrid(int index) const {
+    PatternGrid grid(gridSize);
+    const char* cells = getGridData(index);
+    for (int i = 0; i < cellsPerGrid; i++) {
+        grid.setCell(i / gridSize, i % gridSize, cells[i]);
+    }
+    return grid;
+}
+
+PatternGrid BatchEnvironment::getTarget(int index) const {
+    PatternGrid grid(gridSize);
+    const char* cells = getTargetData(index);
+    for (int i = 0; i < cellsPerGrid; i++) {
+        grid.setCell(i / gridSize, i % gridSize, cells[i]);
+    }
+    return grid;
+}
+
+void BatchEnvironment::resize(int newCount) {
+    count = newCount;
+    targets.assign(static_cast<size_t>(count) * cellsPerGrid, '_');
+    grids.assign(static_cast<size_t>(count) * cellsPerGrid, '_');
+    turns.assign(count, 0);
+    messagesUsed.assign(count, 0);
+    rngStates.assign(count, 0);
+    lastScores.assign(count, 0);
+
+    result.rewards.assign(count, 0.0);
+    result.scores.assign(count, 0);
+    result.accuracies.assign(count, 0.0);
+    result.done.assign(count, 0);
+    result.delivered.assign(count, string());
+}
+
+void BatchEnvironment::startEpisode(int index) {
+    fill_n(grids.data() + index * cellsPerGrid, cellsPerGrid, '_');
+    turns[index] = 0;
+    messagesUsed[index] = 0;
+
+    double accuracy = accuracyOf(index);
+    lastScores[index] = DispatchGame::computeScore(accuracy, 0, 0, settings.maxTurns, settings.messageLimit);
+
+    result.rewards[index] = 0.0;
+    result.scores[index] = lastScores[index];
+    result.accuracies[index] = accuracy;
+    result.done[index] = accuracy == 100.0;
+    result.delivered[index].clear();
+}
+
+void BatchEnvironment::generateTarget(int index, RandomStream& stream) {
+    char* target = targets.data() + index * cellsPerGrid;
+    int last = static_cast<int>(symbols.length()) - 1;
+    for (int i = 0; i < cellsPerGrid; i++) {
+        target[i] = symbols[stream.getInt(0, last)];
+    }
+}
+
+void BatchEnvironment::parallelFor(int total, const vector<string>* messages,
+                                   const vector<ParsedCommand>* commands) {
+    // Environments without an action this step keep their state
+    for (int i = total; i < count; i++) {
+        result.rewards[i] = 0.0;
+        result.delivered[i].clear();
+    }
+
+    // Every environment writes only its own slots, so chunks need no locking
+    int threads = max(1, total / MIN_ENVS_PER_THREAD);
+    pool.run(total, threads, [&](int begin, int end) { stepRange(begin, end, messages, commands); });
+}
+
+void BatchEnvironment::stepRange(int begin, int end, const vector<string>* messages,
+                                 const vector<ParsedCommand>* commands) {
+    for (int i = begin; i < end; i++) {
+        if (result.done[i]) {
+            result.rewards[i] = 0.0;
+            result.delivered[i].clear();
+            continue;
+        }
+
+        if (messages) {
+            RandomStream stream;
+            stream.setState(rngStates[i]);
+            result.delivered[i] = noiseEnabled ? noise.applyNoise((*messages)[i], stream) : (*messages)[i];
+            rngStates[i] = stream.getState();
+
+            stepOne(i, CommandParser::parse(result.delivered[i]));
+        } else {
+            result.delivered[i] = (*commands)[i].rawCommand;
+            stepOne(i, (*commands)[i]);
+        }
+    }
+}
+
+void BatchEnvironment::stepOne(int index, const ParsedCommand& command) {
+    turns[index]++;
+    messagesUsed[index]++;
+
+    if (CommandParser::validateCommand(command, bounds)) {
+        applyCommand(index, command);
+    }
+
+    double accuracy = accuracyOf(index);
+    int score = DispatchGame::computeScore(accuracy, turns[index], messagesUsed[index],
+                                           settings.maxTurns, settings.messageLimit);
+
+    result.rewards[index] = score - lastScores[index];
+    result.scores[index] = score;
+    result.accuracies[index] = accuracy;
+    result.done[index] = accuracy == 100.0 ||
+                         turns[index] >= settings.maxTurns ||
+                         messagesUsed[index] >= settings.messageLimit;
+    lastScores[index] = score;
+}
+
+double BatchEnvironment::accuracyOf(int index) const {
+    if (cellsPerGrid == 0) return 100.0;
+
+    const char* grid = getGridData(index);
+    const char* target = getTargetData(index);
+    int correct = 0;
+    for (int i = 0; i < cellsPerGrid; i++) {
+        correct += grid[i] == target[i];
+    }
+    return (static_cast<double>(correct) / cellsPerGrid) * 100.0;
+}
+
+bool BatchEnvironment::applyCommand(int index, const ParsedCommand& command) {
+    char* grid = grids.data() + index * cellsPerGrid;
+
+    switch (command.type) {
+        case ParsedCommand::Type::SET_CELL:
+            grid[command.row * gridSize + command.col] = command.value;
+            return true;
+
+        case ParsedCommand::Type::FILL_ROW:
+            fill_n(grid + command.row * gridSize, gridSize, command.value);
+            return true;
+
+        case ParsedCommand::Type::FILL_COLUMN:
+            for (int row = 0; row < gridSize; row++) {
+                grid[row * gridSize + command.col] = command.value;
+            }
+            return true;
+
+        case ParsedCommand::Type::REPLACE_ALL:
+            replace(grid, grid + cellsPerGrid, command.oldValue, command.value);
+            return true;
+
+        case ParsedCommand::Type::CLEAR_GRID:
+            fill_n(grid, cellsPerGrid, '_');
+            return true;
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "../core/PatternGrid.h"
+#include "../core/CommandParser.h"
+#include "../core/MessageSystem.h"
+#include "../data/GameData.h"
+#include "DispatchGame.h"
+#include "../utils/WorkerPool.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+struct BatchStepResult {
+    std::vector<double> rewards;          // Score delta since the previous step
+    std::vector<int> scores;              // Same formula as DispatchGame::calculateMetrics
+    std::vector<double> accuracies;
+    std::vector<uint8_t> done;
+    std::vector<std::string> delivered;   // Instruction after the noisy channel
+};
+
+// N headless games stepped together for offline training. State is kept
+// structure-of-arrays: all grids live in one buffer (env-major, row-major
+// within a grid) so observations can be read without copying.
+// Instructions use the Builder's command grammar; the Messenger's paraphrase
+// step is interactive and is not simulated here, only channel noise.
+class BatchEnvironment {
+public:
+    BatchEnvironment(int gridSize = 4, Difficulty difficulty = Difficulty::NORMAL, uint64_t seed = 0);
+
+    // Episodes
+    void reset(int count);                              // Random targets for the difficulty
+    bool reset(const std::vector<PatternGrid>& targets); // False, and nothing changes, unless all are gridSize
+    void resetEnvironment(int index);                   // Fresh target for one finished slot
+
+    // Stepping; done environments ignore their action and get a zero reward
+    const BatchStepResult& step(const std::vector<std::string>& messages);
+    const BatchStepResult& stepCommands(const std::vector<ParsedCommand>& commands);
+
+    void setThreadCount(int threads); // Workers persist across steps; <= 0 means one per core
+    void setNoiseEnabled(bool enabled) { noiseEnabled = enabled; }
+
+    // Observations
+    int size() const { return count; }
+    int getGridSize() const { return gridSize; }
+    int getCellsPerGrid() const { return cellsPerGrid; }
+    const char* getGridData(int index) const { return grids.data() + index * cellsPerGrid; }
+    const char* getTargetData(int index) const { return targets.data() + index * cellsPerGrid; }
+    const std::vector<char>& getGrids() const { return grids; }
+    const std::vector<char>& getTargets() const { return targets; }
+    int getTurn(int index) const { return turns[index]; }
+    int getMessagesUsed(int index) const { return messagesUsed[index]; }
+    int getMessagesRemaining(int index) const { return settings.messageLimit - messagesUsed[index]; }
+    bool isDone(int index) const { return result.done[index] != 0; }
+    bool allDone() const;
+
+    GameMetrics calculateMetrics(int index) const;
+    PatternGrid getGrid(int index) const;
+    PatternGrid getTarget(int index) const;
+
+private:
+    int gridSize;
+    int cellsPerGrid;
+    int count;
+    int threadCount;
+    WorkerPool pool;
+    bool noiseEnabled;
+    uint64_t baseSeed;
+
+    Difficulty difficulty;
+    DifficultySettings settings;
+    std::string symbols;
+    MessageNoiseSimulator noise; // Only its const, stream-based path is used
+    PatternGrid bounds;          // For CommandParser::validateCommand
+
+    // Per-environment state, structure-of-arrays
+    std::vector<char> targets;
+    std::vector<char> grids;
+    std::vector<int> turns;
+    std::vector<int> messagesUsed;
+    std::vector<uint64_t> rngStates;
+    std::vector<int> lastScores;
+
+    BatchStepResult result;
+
+    static const int MIN_ENVS_PER_THREAD; // Below this, threads cost more than they save
+
+    void resize(int newCount);
+    void startEpisode(int index);
+    void generateTarget(int index, RandomStream& stream);
+    void stepRange(int begin, int end, const std::vector<std::string>* messages,
+                   const std::vector<ParsedCommand>* commands);
+    void stepOne(int index, const ParsedCommand& command);
+    void parallelFor(int total, const std::vector<std::string>* messages,
+                     const std::vector<ParsedCommand>* commands);
+    double accuracyOf(int index) const;
+    bool applyCommand(int index, const ParsedCommand& command);
+};
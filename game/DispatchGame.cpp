@@ -1,18 +1,33 @@
 #include "DispatchGame.h"
+#include "TurnStateMachine.h"
 #include "../ui/ConsoleUI.h"
+#include "../ui/AsyncInput.h"
 #include "../ui/CutsceneManager.h"
 #include "../utils/Utilities.h"
+#include "../utils/ScratchArena.h"
+#include "../data/SaveSystem.h"
+#include "../utils/Trace.h"
 #include <chrono>
+#include <algorithm>
 
 using namespace std;
 using namespace chrono;
 
 DispatchGame::DispatchGame(const PatternGrid& targetPattern, Difficulty difficulty) 
-    : difficulty(difficulty), totalTurns(0), currentTurn(0), maxTurns(20), 
-      messageLimit(20), messagesUsed(0) {
+    : gameData(&ownData), episodeNumber(1), difficulty(difficulty), totalTurns(0), currentTurn(0), maxTurns(20), 
+      messageLimit(20), messagesUsed(0), turnTimeLimitSeconds(0), episodeTimeLimitSeconds(0),
+      timeExpired(false), interactive(true) {
     
     initializeGame();
     dispatcher = make_unique<Dispatcher>(targetPattern);
+    ownData.setDifficulty(difficulty);
+}
+
+void DispatchGame::recordTo(GameData& data, int episode) {
+    gameData = &data;
+    episodeNumber = episode;
+    gameData->setDifficulty(difficulty); // Per-difficulty statistics file the result here
+    if (journal) journal->updateGameData(*gameData, episodeNumber);
 }
 
 void DispatchGame::initializeGame() {
@@ -22,11 +37,19 @@ void DispatchGame::initializeGame() {
     messenger = make_unique<Messenger>(noiseSimulator, 2, true);
     builder = make_unique<Builder>(4);
     
+    // A whole episode's worth, so a headless turn runs without allocating
+    messenger->reserveHistory(messageLimit);
+    builder->reserveHistory(messageLimit, messenger->getMaxRelayLength());
+    pendingInstruction.reserve(messenger->getMaxRelayLength());
+    pendingRelay.reserve(messenger->getMaxRelayLength());
+    
     startTime = steady_clock::now();
 }
 
 void DispatchGame::playEpisode() {
-    CutsceneManager::playEpisode1Intro();
+    if (currentTurn == 0) {
+        CutsceneManager::playEpisode1Intro(); // Not again when resuming a saved game
+    }
     
     ConsoleUI::clearScreen();
     ConsoleUI::showTitle("🎮 GAME START - ROLE: DISPATCHER");
@@ -43,50 +66,105 @@ void DispatchGame::playEpisode() {
     ConsoleUI::slowPrint("Send text instructions to the Messenger.");
     ConsoleUI::slowPrint("No copy-pasting the grid. No images. You must rewrite it.\n");
     
-    while (currentTurn < maxTurns && messagesUsed < messageLimit && !isComplete()) {
-        playTurn();
+    if (turnTimeLimitSeconds > 0) {
+        ConsoleUI::slowPrint("Each instruction must be sent within " + to_string(turnTimeLimitSeconds) + " seconds.");
+    }
+    if (episodeTimeLimitSeconds > 0) {
+        ConsoleUI::slowPrint("The whole delivery must be done within " + to_string(episodeTimeLimitSeconds / 60) + " minutes.");
     }
     
-    showResults();
-    showEpisodeSummary();
+    EventLoop loop;
+    ConsoleInput input(loop);
+    TurnStateMachine machine(*this, loop, input);
+    machine.start();
+    loop.run();
 }
 
 void DispatchGame::playTurn() {
+    ScratchArena::Scope scratch; // Per-turn temporaries rewind when the turn ends
+    beginTurn();
+    
+    string dispatcherMessage = needsInstruction()
+        ? ConsoleUI::getInput("Enter your instructions to Messenger: ")
+        : openingInstruction();
+    
+    relayInstruction(dispatcherMessage);
+    if (interactive) {
+        ConsoleUI::getInput("Press Enter to continue...");
+    }
+    
+    buildRelayed();
+    if (interactive && !isComplete()) {
+        ConsoleUI::getInput("Press Enter to continue...");
+    }
+}
+
+void DispatchGame::beginTurn() {
     currentTurn++;
+    if (!interactive) return;
     
     ConsoleUI::clearScreen();
     cout << "--- Turn " << currentTurn << " ---\n";
-    cout << "Messages used: " << messagesUsed << "/" << messageLimit << "\n\n";
-    
-    // Dispatcher creates message
-    string dispatcherMessage;
-    if (currentTurn == 1) {
-        dispatcherMessage = dispatcher->createInitialDescription();
-        cout << "Dispatcher: " << dispatcherMessage << "\n";
-    } else {
-        dispatcherMessage = ConsoleUI::getInput("Enter your instructions to Messenger: ");
+    cout << "Messages used: " << messagesUsed << "/" << messageLimit << "\n";
+    int64_t remaining = getTimeRemainingMs();
+    if (remaining >= 0) {
+        cout << "Time remaining: " << (remaining + 999) / 1000 << "s\n";
     }
-    
+    cout << "\n";
+}
+
+string DispatchGame::openingInstruction() const {
+    string message = dispatcher->createInitialDescription();
+    if (interactive) {
+        cout << "Dispatcher: " << message << "\n";
+    }
+    return message;
+}
+
+void DispatchGame::relayInstruction(const string& instruction) {
+    TRACE_SCOPE("DispatchGame::relayInstruction");
+    ScratchArena::Scope scratch;
     messagesUsed++;
+    pendingInstruction = instruction;
+    pendingRelay = messenger->processMessage(instruction);
+    if (!interactive) return;
     
     // Messenger processes message
     ConsoleUI::clearScreen();
     ConsoleUI::showTitle("🏃‍♂️ ROLE: MESSENGER");
     ConsoleUI::slowPrint("The messenger gets your text — but they must paraphrase it.\n");
+    ConsoleUI::showMessage("Messenger → Builder", pendingRelay);
+}
+
+void DispatchGame::buildRelayed() {
+    TRACE_SCOPE("DispatchGame::buildRelayed");
+    ScratchArena::Scope scratch;
+    if (interactive) {
+        ConsoleUI::clearScreen();
+        ConsoleUI::showTitle("🏗️ ROLE: BUILDER");
+        ConsoleUI::slowPrint("The Builder receives the messenger's paraphrased instructions.\n");
+        cout << "Current Grid:\n" << builder->getGridDisplay() << "\n";
+    }
     
-    string messengerMessage = messenger->processMessage(dispatcherMessage);
-    ConsoleUI::showMessage("Messenger → Builder", messengerMessage);
-    
-    ConsoleUI::getInput("Press Enter to continue...");
-    
-    // Builder executes instruction
-    ConsoleUI::clearScreen();
-    ConsoleUI::showTitle("🏗️ ROLE: BUILDER");
-    ConsoleUI::slowPrint("The Builder receives the messenger's paraphrased instructions.\n");
-    
-    cout << "Current Grid:\n" << builder->getGridDisplay() << "\n";
+    if (journal) journalGrid = builder->getCurrentGrid();
+    bool success = builder->executeInstruction(pendingRelay);
+    if (inference) inference->observe(pendingRelay);
+    if (decoder) {
+        // Every relay goes through the beam, so its readings carry across turns
+        if (success) {
+            decoder->decode(pendingRelay, &builder->getCurrentGrid(), inference.get());
+        } else {
+            success = decoder->recover(*builder, pendingRelay, inference.get()) > 0;
+        }
+    }
+    if (!success && inference) {
+        success = inference->commitTo(*builder) > 0;
+    }
+    journalTurn(journalGrid);
+    pendingInstruction.clear();
+    pendingRelay.clear();
+    if (!interactive) return;
     
-    bool success = builder->executeInstruction(messengerMessage);
     if (!success) {
         cout << "Builder: I didn't understand that instruction.\n";
     } else {
@@ -94,25 +172,155 @@ void DispatchGame::playTurn() {
     }
     
     cout << "\nUpdated Grid:\n" << builder->getGridDisplay() << "\n";
+}
+
+void DispatchGame::setGarbleRecovery(bool enabled) {
+    if (!enabled) {
+        decoder.reset();
+    } else if (!decoder) {
+        decoder = make_unique<BeamDecoder>(builder->getCurrentGrid().getSize(), noiseSimulator);
+        decoder->reset(builder->getCurrentGrid());
+    }
+}
+
+void DispatchGame::setBeliefInference(bool enabled) {
+    if (!enabled) {
+        inference.reset();
+    } else if (!inference) {
+        inference = make_unique<InferenceBuilder>(builder->getCurrentGrid().getSize(), noiseSimulator);
+        for (const string& relay : messenger->getSentMessages()) inference->observe(relay);
+    }
+}
+
+void DispatchGame::forfeitTurn() {
+    // The turn is spent but no message is
+    journalTurn(builder->getCurrentGrid());
+    if (interactive) {
+        ConsoleUI::slowPrint("⏱️ Time's up! The Messenger leaves without new instructions.\n");
+    }
+}
+
+void DispatchGame::expireTime() {
+    timeExpired = true;
+    if (interactive) {
+        ConsoleUI::slowPrint("\n⏱️ Time's up! Supervisor Mara calls the delivery.\n");
+    }
+}
+
+void DispatchGame::finishEpisode() {
+    if (interactive) {
+        showResults();
+        showEpisodeSummary();
+    } else {
+        gameData->addCompletedEpisode(episodeNumber, calculateMetrics());
+    }
     
-    if (!isComplete()) {
-        ConsoleUI::getInput("Press Enter to continue...");
+    if (journal) {
+        journal.reset(); // Drains the writer before its files go
+        SaveJournal::discard(journalSlot);
     }
 }
 
+void DispatchGame::journalTurn(const PatternGrid& gridBefore) {
+    if (!journal) return;
+    
+    TurnDelta delta = TurnDelta::between(gridBefore, builder->getCurrentGrid());
+    delta.turn = currentTurn;
+    delta.messagesUsed = messagesUsed;
+    delta.elapsedSeconds = duration_cast<seconds>(steady_clock::now() - startTime).count();
+    delta.messageReceived = pendingInstruction;
+    delta.messageSent = pendingRelay;
+    journal->append(move(delta));
+}
+
+bool DispatchGame::isOver() const {
+    return currentTurn >= maxTurns || messagesUsed >= messageLimit || isComplete() || !checkTimeLimit();
+}
+
+void DispatchGame::setTimeLimits(int turnSeconds, int episodeSeconds) {
+    turnTimeLimitSeconds = max(turnSeconds, 0);
+    episodeTimeLimitSeconds = max(episodeSeconds, 0);
+}
+
+int64_t DispatchGame::getTimeRemainingMs() const {
+    if (episodeTimeLimitSeconds <= 0) return -1;
+    if (timeExpired) return 0;
+    int64_t elapsed = duration_cast<milliseconds>(steady_clock::now() - startTime).count();
+    return max<int64_t>(episodeTimeLimitSeconds * 1000LL - elapsed, 0);
+}
+
 bool DispatchGame::isComplete() const {
     return builder->getCurrentGrid() == dispatcher->getTargetPattern();
 }
 
-void DispatchGame::saveGameState(const std::string& slotName) {
-    // Implementation would save game state
-    cout << "Game state saved to slot: " << slotName << "\n";
+bool DispatchGame::saveGameState(const std::string& slotName) {
+    GameSnapshot snapshot = createSnapshot();
+    return SaveSystem::saveGame(slotName, *gameData, episodeNumber, &snapshot);
 }
 
 bool DispatchGame::loadGameState(const std::string& slotName) {
-    // Implementation would load game state
-    cout << "Loading game state from slot: " << slotName << "\n";
-    return false;
+    GameData loadedData;
+    GameSnapshot snapshot;
+    int episode = 1;
+    if (!SaveJournal::recover(slotName, loadedData, episode, snapshot) || snapshot.target.getSize() == 0) {
+        return false;
+    }
+    
+    if (!restoreSnapshot(snapshot)) return false;
+    *gameData = loadedData;
+    gameData->setDifficulty(difficulty);
+    episodeNumber = episode;
+    if (journal) journal->updateGameData(*gameData, episodeNumber);
+    return true;
+}
+
+void DispatchGame::enableJournal(const std::string& slotName) {
+    journal.reset();
+    journalSlot = slotName;
+    journal = make_unique<SaveJournal>(slotName, *gameData, episodeNumber, createSnapshot());
+}
+
+GameSnapshot DispatchGame::createSnapshot() const {
+    GameSnapshot snapshot;
+    snapshot.target = dispatcher->getTargetPattern();
+    snapshot.builderGrid = builder->getCurrentGrid();
+    snapshot.difficulty = difficulty;
+    snapshot.currentTurn = currentTurn;
+    snapshot.totalTurns = totalTurns;
+    snapshot.messagesUsed = messagesUsed;
+    snapshot.elapsedSeconds = duration_cast<seconds>(steady_clock::now() - startTime).count();
+    snapshot.messagesReceived = messenger->getReceivedMessages();
+    snapshot.messagesSent = messenger->getSentMessages();
+    return snapshot;
+}
+
+bool DispatchGame::restoreSnapshot(const GameSnapshot& snapshot) {
+    if (snapshot.builderGrid.getSize() != snapshot.target.getSize()) {
+        return false;
+    }
+    
+    difficulty = snapshot.difficulty;
+    gameData->setDifficulty(difficulty);
+    applyDifficultySettings();
+    dispatcher = make_unique<Dispatcher>(snapshot.target);
+    builder = make_unique<Builder>(snapshot.target.getSize());
+    builder->restoreGrid(snapshot.builderGrid);
+    messenger->restoreHistory(snapshot.messagesReceived, snapshot.messagesSent);
+    if (decoder) {
+        decoder = make_unique<BeamDecoder>(snapshot.target.getSize(), noiseSimulator);
+        decoder->reset(snapshot.builderGrid);
+    }
+    if (inference) {
+        // The evidence so far is the relays the Builder already received
+        inference = make_unique<InferenceBuilder>(snapshot.target.getSize(), noiseSimulator);
+        for (const string& relay : snapshot.messagesSent) inference->observe(relay);
+    }
+    
+    currentTurn = snapshot.currentTurn;
+    totalTurns = snapshot.totalTurns;
+    messagesUsed = snapshot.messagesUsed;
+    startTime = steady_clock::now() - seconds(snapshot.elapsedSeconds);
+    return true;
 }
 
 double DispatchGame::getAccuracy() const {
@@ -130,16 +338,23 @@ GameMetrics DispatchGame::calculateMetrics() const {
     auto endTime = steady_clock::now();
     metrics.timeElapsed = duration_cast<seconds>(endTime - startTime);
     
-    // Calculate score
-    metrics.score = static_cast<int>(metrics.accuracy * 10) + 
-                   (maxTurns - metrics.turnsTaken) * 5 +
-                   (messageLimit - metrics.messagesUsed) * 2;
+    metrics.score = computeScore(metrics.accuracy, metrics.turnsTaken, metrics.messagesUsed,
+                                 maxTurns, messageLimit);
+    
+    return metrics;
+}
+
+int DispatchGame::computeScore(double accuracy, int turnsTaken, int messagesUsed,
+                               int maxTurns, int messageLimit) {
+    int score = static_cast<int>(accuracy * 10) + 
+                (maxTurns - turnsTaken) * 5 +
+                (messageLimit - messagesUsed) * 2;
     
-    if (metrics.accuracy == 100.0) {
-        metrics.score += 100; // Perfect score bonus
+    if (accuracy == 100.0) {
+        score += 100; // Perfect score bonus
     }
     
-    return metrics;
+    return score;
 }
 
 void DispatchGame::showResults() {
@@ -188,53 +403,42 @@ void DispatchGame::showEpisodeSummary() {
     ConsoleUI::showStats(stats);
     
     // Add to game data
-    gameData.addCompletedEpisode(1, metrics);
+    vector<AchievementId> unlocked = gameData->addCompletedEpisode(episodeNumber, metrics);
     
-    if (accuracy == 100.0) {
-        gameData.unlockAchievement("Perfect Transmission");
-        ConsoleUI::slowPrint("🎉 Achievement Unlocked: Perfect Transmission!");
-    }
-    
-    if (metrics.turnsTaken <= 5) {
-        gameData.unlockAchievement("Speed Demon");
-        ConsoleUI::slowPrint("🎉 Achievement Unlocked: Speed Demon!");
+    for (AchievementId id : unlocked) {
+        const AchievementRule& rule = AchievementRegistry::getDefault().getRule(id);
+        ConsoleUI::slowPrint("🎉 Achievement Unlocked: " + rule.name + "!");
     }
     
     ConsoleUI::getInput("Press Enter to continue...");
 }
 
 bool DispatchGame::checkTimeLimit() const {
-    // Optional time limit feature
-    return true;
+    return getTimeRemainingMs() != 0;
 }
 
 void DispatchGame::applyDifficultySettings() {
-    NoiseLevel noiseLevel = NoiseLevel::MEDIUM; // Initialize with default value
+    DifficultySettings settings = getDifficultySettings(difficulty);
+    maxTurns = settings.maxTurns;
+    messageLimit = settings.messageLimit;
+    turnTimeLimitSeconds = settings.turnTimeLimitSeconds;
+    episodeTimeLimitSeconds = settings.episodeTimeLimitSeconds;
     
+    if (noiseSimulator) {
+        noiseSimulator->setNoiseLevel(settings.noiseLevel);
+    }
+}
+
+DifficultySettings DispatchGame::getDifficultySettings(Difficulty difficulty) {
     switch (difficulty) {
         case Difficulty::TRAINING:
-            noiseLevel = NoiseLevel::LOW;
-            maxTurns = 25;
-            messageLimit = 25;
-            break;
-        case Difficulty::NORMAL:
-            noiseLevel = NoiseLevel::MEDIUM;
-            maxTurns = 20;
-            messageLimit = 20;
-            break;
+            return {NoiseLevel::LOW, 25, 25};
         case Difficulty::HARD:
-            noiseLevel = NoiseLevel::HIGH;
-            maxTurns = 15;
-            messageLimit = 15;
-            break;
+            return {NoiseLevel::HIGH, 15, 15, 90, 0};
         case Difficulty::EXPERT:
-            noiseLevel = NoiseLevel::EXTREME;
-            maxTurns = 10;
-            messageLimit = 10;
-            break;
-    }
-    
-    if (noiseSimulator) {
-        noiseSimulator->setNoiseLevel(noiseLevel);
+            return {NoiseLevel::EXTREME, 10, 10, 60, 600};
+        case Difficulty::NORMAL:
+        default:
+            return {NoiseLevel::MEDIUM, 20, 20};
     }
 }
\ No newline at end of file
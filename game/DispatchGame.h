@@ -3,22 +3,72 @@
 #include "../roles/Dispatcher.h"
 #include "../roles/Messenger.h"
 #include "../roles/Builder.h"
+#include "../roles/BeamDecoder.h"
+#include "../roles/InferenceBuilder.h"
 #include "../core/MessageSystem.h"
 #include "../data/GameData.h"
+#include "../data/SaveJournal.h"
 #include <memory>
 
+struct DifficultySettings {
+    NoiseLevel noiseLevel;
+    int maxTurns;
+    int messageLimit;
+    int turnTimeLimitSeconds = 0;    // Per instruction; 0 = none
+    int episodeTimeLimitSeconds = 0; // Whole episode; 0 = none
+};
+
 class DispatchGame {
 public:
     DispatchGame(const PatternGrid& targetPattern, Difficulty difficulty = Difficulty::NORMAL);
+    DispatchGame(const DispatchGame&) = delete;
+    DispatchGame& operator=(const DispatchGame&) = delete;
+    
+    // Results, statistics and achievements go to the player's data, which
+    // must outlive the game; until then, to a private record as episode 1
+    void recordTo(GameData& data, int episodeNumber);
+    int getEpisodeNumber() const { return episodeNumber; }
     
     // Core gameplay
     void playEpisode();
     void playTurn();
     bool isComplete() const;
+    bool isOver() const;
+    
+    // Turn steps, for callers that drive the turn themselves (TurnStateMachine).
+    // playTurn() is beginTurn, an instruction, relayInstruction, buildRelayed.
+    void beginTurn();
+    bool needsInstruction() const { return currentTurn != 1; } // Turn 1 opens with the Dispatcher's description
+    std::string openingInstruction() const;
+    void relayInstruction(const std::string& instruction);
+    void buildRelayed();
+    void forfeitTurn();  // No instruction within the turn time limit
+    void expireTime();   // Episode time limit reached
+    void finishEpisode();
+    
+    // Headless games skip all console output and pauses
+    void setInteractive(bool enabled) { interactive = enabled; }
+    bool isInteractive() const { return interactive; }
+    void setTimeLimits(int turnSeconds, int episodeSeconds); // Overrides the difficulty's; 0 = none
+    int64_t getTurnTimeLimitMs() const { return turnTimeLimitSeconds * 1000LL; }
+    int64_t getTimeRemainingMs() const; // -1 without an episode limit
+    
+    // Relays the Builder can't parse go to BeamDecoder for a best guess
+    void setGarbleRecovery(bool enabled);
+    bool isGarbleRecoveryEnabled() const { return decoder != nullptr; }
+    // Relays are also read as noisy evidence about the target; when the
+    // Builder can't parse one, the most likely grid so far is built instead
+    void setBeliefInference(bool enabled);
+    bool isBeliefInferenceEnabled() const { return inference != nullptr; }
     
     // Game state
-    void saveGameState(const std::string& slotName = "auto");
-    bool loadGameState(const std::string& slotName = "auto");
+    bool saveGameState(const std::string& slotName = "auto");
+    bool loadGameState(const std::string& slotName = "auto"); // Snapshot plus journal tail
+    GameSnapshot createSnapshot() const;
+    bool restoreSnapshot(const GameSnapshot& snapshot);
+    // Autosave every turn in the background; the slot is deleted once the
+    // episode finishes, since there is nothing left to resume
+    void enableJournal(const std::string& slotName);
     
     // Getters
     const PatternGrid& getTargetPattern() const { return dispatcher->getTargetPattern(); }
@@ -27,26 +77,45 @@ public:
     
     // Metrics
     GameMetrics calculateMetrics() const;
+    
+    // Shared with BatchEnvironment so batched rewards match the scored game
+    static DifficultySettings getDifficultySettings(Difficulty difficulty);
+    static int computeScore(double accuracy, int turnsTaken, int messagesUsed,
+                            int maxTurns, int messageLimit);
 
 private:
     std::unique_ptr<Dispatcher> dispatcher;
     std::unique_ptr<Messenger> messenger;
     std::unique_ptr<Builder> builder;
     std::shared_ptr<MessageNoiseSimulator> noiseSimulator;
+    std::unique_ptr<BeamDecoder> decoder; // Null unless garble recovery is on
+    std::unique_ptr<InferenceBuilder> inference; // Null unless belief inference is on
     
-    GameData gameData;
+    GameData ownData;
+    GameData* gameData; // &ownData unless recordTo() was called
+    int episodeNumber;
     Difficulty difficulty;
+    std::unique_ptr<SaveJournal> journal;
+    std::string journalSlot;
     
     int totalTurns;
     int currentTurn;
     int maxTurns;
     int messageLimit;
     int messagesUsed;
+    int turnTimeLimitSeconds;
+    int episodeTimeLimitSeconds;
+    bool timeExpired;
+    bool interactive;
+    
+    std::string pendingInstruction; // Between relayInstruction and buildRelayed
+    std::string pendingRelay;
+    PatternGrid journalGrid; // The grid before buildRelayed's build, when journaling
     
     std::chrono::steady_clock::time_point startTime;
     
     void initializeGame();
-    void processHumanTurn();
+    void journalTurn(const PatternGrid& gridBefore);
     void showResults();
     void showEpisodeSummary();
     
@@ -1,15 +1,41 @@
 #include "EpisodeManager.h"
 #include "../utils/Random.h"
 #include <algorithm>
+#include <climits>
 
 using namespace std;
 
-EpisodeManager::EpisodeManager() {
+const int EpisodeManager::MAX_GENERATION_ATTEMPTS = 32;
+const size_t EpisodeManager::MAX_KNOWN_PATTERNS = 4096;
+const size_t EpisodeManager::NOT_IN_PACK = static_cast<size_t>(-1);
+const int EpisodeManager::RANDOM_EPISODE_NUMBER = 100;
+const int EpisodeManager::CUSTOM_EPISODE_NUMBER = 1000;
+
+EpisodeManager::EpisodeManager(const ContentPack& pack)
+    : pack(pack),
+      generator((static_cast<uint64_t>(Random::getInt(0, INT_MAX)) << 31) ^ Random::getInt(0, INT_MAX)) {
     initializeEpisodes();
 }
 
 void EpisodeManager::initializeEpisodes() {
-    episodes.clear();
+    loaded.clear();
+    entries.clear();
+    indexByNumber.clear();
+    bySkill.clear();
+    knownPatternHashes.clear();
+    
+    if (pack.getEpisodeCount() > 0) {
+        indexPack();
+        return;
+    }
+    
+    for (const Episode& episode : builtInEpisodes()) {
+        addEpisode(episode);
+    }
+}
+
+vector<Episode> EpisodeManager::builtInEpisodes() {
+    vector<Episode> episodes;
     
     // Episode 1 - The First Job
     Episode ep1;
@@ -58,13 +84,40 @@ void EpisodeManager::initializeEpisodes() {
     ep3.unlocked = false;
     ep3.requiredSkillPoints = 25;
     episodes.push_back(ep3);
+    
+    return episodes;
+}
+
+void EpisodeManager::indexPack() {
+    // Only the fixed-size records are read here; strings and patterns stay
+    // in the mapping until an episode is first asked for
+    PackedEpisode packed;
+    entries.reserve(pack.getEpisodeCount());
+    for (size_t i = 0; i < pack.getEpisodeCount(); i++) {
+        if (pack.getEpisodeAt(i, packed) && !indexByNumber.count(packed.number)) {
+            indexByNumber[packed.number] = entries.size();
+            entries.push_back({packed.number, packed.requiredSkillPoints, packed.unlocked, i, nullptr});
+        }
+    }
+    
+    bySkill.resize(entries.size());
+    for (size_t i = 0; i < bySkill.size(); i++) bySkill[i] = i;
+    sort(bySkill.begin(), bySkill.end(), [this](size_t a, size_t b) {
+        return make_pair(entries[a].requiredSkillPoints, entries[a].number) <
+               make_pair(entries[b].requiredSkillPoints, entries[b].number);
+    });
 }
 
-vector<Episode> EpisodeManager::getAvailableEpisodes(int playerSkillPoints) const {
-    vector<Episode> available;
+vector<const Episode*> EpisodeManager::getAvailableEpisodes(int playerSkillPoints) const {
+    vector<const Episode*> available;
     
-    for (const auto& episode : episodes) {
-        if (episode.unlocked && episode.requiredSkillPoints <= playerSkillPoints) {
+    // bySkill is sorted, so everything affordable is a prefix
+    for (size_t index : bySkill) {
+        const CatalogEntry& entry = entries[index];
+        if (entry.requiredSkillPoints > playerSkillPoints) break;
+        if (!entry.unlocked) continue;
+        
+        if (const Episode* episode = materialize(entry)) {
             available.push_back(episode);
         }
     }
@@ -72,87 +125,188 @@ vector<Episode> EpisodeManager::getAvailableEpisodes(int playerSkillPoints) cons
     return available;
 }
 
-Episode EpisodeManager::getEpisode(int episodeNumber) const {
-    for (const auto& episode : episodes) {
-        if (episode.number == episodeNumber) {
-            return episode;
+vector<const Episode*> EpisodeManager::getEpisodesInSkillRange(int minSkillPoints, int maxSkillPoints) const {
+    vector<const Episode*> result;
+    
+    auto first = lower_bound(bySkill.begin(), bySkill.end(), minSkillPoints,
+                             [this](size_t index, int skill) { return entries[index].requiredSkillPoints < skill; });
+    for (auto it = first; it != bySkill.end() && entries[*it].requiredSkillPoints <= maxSkillPoints; ++it) {
+        if (const Episode* episode = materialize(entries[*it])) {
+            result.push_back(episode);
         }
     }
     
-    // Return a default episode if not found
-    return episodes[0];
+    return result;
 }
 
-bool EpisodeManager::unlockEpisode(int episodeNumber, int playerSkillPoints) {
-    for (auto& episode : episodes) {
-        if (episode.number == episodeNumber && episode.requiredSkillPoints <= playerSkillPoints) {
-            episode.unlocked = true;
-            return true;
+const Episode* EpisodeManager::findEpisode(int episodeNumber) const {
+    auto it = indexByNumber.find(episodeNumber);
+    return it != indexByNumber.end() ? materialize(entries[it->second]) : nullptr;
+}
+
+const Episode& EpisodeManager::getEpisode(int episodeNumber) const {
+    if (const Episode* episode = findEpisode(episodeNumber)) {
+        return *episode;
+    }
+    
+    // Unknown number: the easiest episode the catalog can decode, or the
+    // first built-in one if it has none
+    for (size_t index : bySkill) {
+        if (const Episode* episode = materialize(entries[index])) {
+            return *episode;
         }
     }
-    return false;
+    static const Episode fallback = builtInEpisodes().front();
+    return fallback;
+}
+
+bool EpisodeManager::unlockEpisode(int episodeNumber, int playerSkillPoints) {
+    auto it = indexByNumber.find(episodeNumber);
+    if (it == indexByNumber.end()) return false;
+    
+    CatalogEntry& entry = entries[it->second];
+    if (entry.requiredSkillPoints > playerSkillPoints) return false;
+    
+    entry.unlocked = true;
+    if (entry.episode) entry.episode->unlocked = true;
+    return true;
 }
 
 bool EpisodeManager::isEpisodeUnlocked(int episodeNumber) const {
-    for (const auto& episode : episodes) {
-        if (episode.number == episodeNumber) {
-            return episode.unlocked;
+    auto it = indexByNumber.find(episodeNumber);
+    return it != indexByNumber.end() && entries[it->second].unlocked;
+}
+
+const Episode& EpisodeManager::addEpisode(const Episode& episode) {
+    rememberPattern(episode.pattern);
+    
+    auto it = indexByNumber.find(episode.number);
+    if (it != indexByNumber.end()) {
+        // Overwrite the decoded copy in place, so views stay valid and
+        // repeated replacement doesn't grow the deque
+        CatalogEntry& entry = entries[it->second];
+        if (entry.episode) {
+            *entry.episode = episode;
+        } else {
+            loaded.push_back(episode);
+            entry.episode = &loaded.back();
         }
+        removeFromSkillIndex(it->second);
+        entry.requiredSkillPoints = episode.requiredSkillPoints;
+        entry.unlocked = episode.unlocked;
+        entry.packIndex = NOT_IN_PACK;
+        insertEntry(entry);
+        return *entry.episode;
     }
-    return false;
+    
+    loaded.push_back(episode);
+    indexByNumber[episode.number] = entries.size();
+    entries.push_back({episode.number, episode.requiredSkillPoints, episode.unlocked, NOT_IN_PACK, &loaded.back()});
+    insertEntry(entries.back());
+    return loaded.back();
 }
 
-Episode EpisodeManager::generateRandomEpisode(Difficulty difficulty) {
-    Episode randomEpisode;
-    randomEpisode.number = 100 + Random::getInt(1, 999);
-    randomEpisode.title = "Random Challenge";
-    randomEpisode.description = "A randomly generated pattern for endless replayability.";
-    randomEpisode.pattern = generatePatternForDifficulty(difficulty);
-    randomEpisode.recommendedDifficulty = difficulty;
-    randomEpisode.unlocked = true;
-    randomEpisode.requiredSkillPoints = 0;
+const Episode& EpisodeManager::generateRandomEpisode(Difficulty difficulty, int size) {
+    randomSlot.number = RANDOM_EPISODE_NUMBER;
+    randomSlot.title = "Random Challenge";
+    randomSlot.description = "A randomly generated pattern for endless replayability.";
+    randomSlot.pattern = generatePatternForDifficulty(difficulty, size);
+    randomSlot.recommendedDifficulty = difficulty;
+    randomSlot.unlocked = true;
+    randomSlot.requiredSkillPoints = 0;
     
-    return randomEpisode;
+    return randomSlot;
 }
 
-Episode EpisodeManager::createCustomEpisode(const string& title, const PatternGrid& pattern) {
-    Episode customEpisode;
-    customEpisode.number = 1000 + Random::getInt(1, 9999);
-    customEpisode.title = title;
-    customEpisode.description = "Custom created pattern.";
-    customEpisode.pattern = pattern;
-    customEpisode.recommendedDifficulty = Difficulty::NORMAL;
-    customEpisode.unlocked = true;
-    customEpisode.requiredSkillPoints = 0;
+const Episode& EpisodeManager::createCustomEpisode(const string& title, const PatternGrid& pattern) {
+    rememberPattern(pattern);
+    
+    customSlot.number = CUSTOM_EPISODE_NUMBER;
+    customSlot.title = title;
+    customSlot.description = "Custom created pattern.";
+    customSlot.pattern = pattern;
+    customSlot.recommendedDifficulty = Difficulty::NORMAL;
+    customSlot.unlocked = true;
+    customSlot.requiredSkillPoints = 0;
     
-    return customEpisode;
+    return customSlot;
 }
 
-PatternGrid EpisodeManager::generatePatternForDifficulty(Difficulty difficulty) {
-    int size = 4;
-    PatternGrid grid(size);
+void EpisodeManager::insertEntry(const CatalogEntry& entry) {
+    size_t entryIndex = indexByNumber[entry.number];
+    auto key = make_pair(entry.requiredSkillPoints, entry.number);
+    auto pos = lower_bound(bySkill.begin(), bySkill.end(), key, [this](size_t index, const pair<int, int>& k) {
+        return make_pair(entries[index].requiredSkillPoints, entries[index].number) < k;
+    });
+    bySkill.insert(pos, entryIndex);
+}
+
+void EpisodeManager::removeFromSkillIndex(size_t entryIndex) {
+    auto pos = find(bySkill.begin(), bySkill.end(), entryIndex);
+    if (pos != bySkill.end()) bySkill.erase(pos);
+}
+
+const Episode* EpisodeManager::materialize(const CatalogEntry& entry) const {
+    if (entry.episode) return entry.episode;
+    
+    PackedEpisode packed;
+    if (entry.packIndex == NOT_IN_PACK || !pack.getEpisodeAt(entry.packIndex, packed)) {
+        return nullptr;
+    }
     
-    string symbols;
+    Episode episode;
+    episode.number = packed.number;
+    episode.title = string(packed.title);
+    episode.description = string(packed.description);
+    episode.pattern = PatternGrid(packed.gridSize);
+    for (int row = 0; row < packed.gridSize; row++) {
+        for (int col = 0; col < packed.gridSize; col++) {
+            episode.pattern.setCell(row, col, packed.pattern[row * packed.gridSize + col]);
+        }
+    }
+    episode.recommendedDifficulty = packed.recommendedDifficulty;
+    episode.unlocked = entry.unlocked;
+    episode.requiredSkillPoints = packed.requiredSkillPoints;
+    
+    rememberPattern(episode.pattern);
+    loaded.push_back(move(episode));
+    entry.episode = &loaded.back();
+    return entry.episode;
+}
+
+bool EpisodeManager::rememberPattern(const PatternGrid& pattern) const {
+    // Dedup is best effort; an endless run of random episodes starts over
+    // rather than growing the set forever
+    if (knownPatternHashes.size() >= MAX_KNOWN_PATTERNS) {
+        knownPatternHashes.clear();
+    }
+    return knownPatternHashes.insert(pattern.getCanonicalHash()).second;
+}
+
+string EpisodeManager::getSymbolsForDifficulty(Difficulty difficulty) {
     switch (difficulty) {
         case Difficulty::TRAINING:
-            symbols = "AB";
-            break;
-        case Difficulty::NORMAL:
-            symbols = "ABCD";
-            break;
+            return "AB";
         case Difficulty::HARD:
-            symbols = "ABCD123";
-            break;
+            return "ABCD123";
         case Difficulty::EXPERT:
-            symbols = "ABCDEFGH123456";
-            break;
+            return "ABCDEFGH123456";
+        case Difficulty::NORMAL:
+        default:
+            return "ABCD";
     }
+}
+
+PatternGrid EpisodeManager::generatePatternForDifficulty(Difficulty difficulty, int size) {
+    PatternGrid grid(size);
     
-    // Fill grid with random symbols
-    for (int row = 0; row < size; row++) {
-        for (int col = 0; col < size; col++) {
-            char symbol = symbols[Random::getInt(0, symbols.length() - 1)];
-            grid.setCell(row, col, symbol);
+    // Complexity-calibrated pattern, rerolling ones that are a rotation,
+    // reflection or relabeling of one we've already handed out
+    for (int attempt = 0; attempt < MAX_GENERATION_ATTEMPTS; attempt++) {
+        grid = generator.generate(size, difficulty);
+        
+        if (rememberPattern(grid)) {
+            break;
         }
     }
     
@@ -1,8 +1,13 @@
 #pragma once
 #include "../core/PatternGrid.h"
 #include "../data/GameData.h"
+#include "../data/ContentPack.h"
+#include "PatternGenerator.h"
 #include <vector>
 #include <string>
+#include <unordered_set>
+#include <unordered_map>
+#include <deque>
 
 struct Episode {
     int number;
@@ -16,19 +21,63 @@ struct Episode {
 
 class EpisodeManager {
 public:
-    EpisodeManager();
+    // Episodes come from the content pack when it has any, otherwise from the
+    // built-in set; pack episodes are decoded on first access
+    EpisodeManager(const ContentPack& pack = ContentPack::getDefault());
     
-    std::vector<Episode> getAvailableEpisodes(int playerSkillPoints) const;
-    Episode getEpisode(int episodeNumber) const;
+    // Views into the catalog; the pointers stay valid for the manager's lifetime
+    std::vector<const Episode*> getAvailableEpisodes(int playerSkillPoints) const;
+    std::vector<const Episode*> getEpisodesInSkillRange(int minSkillPoints, int maxSkillPoints) const;
+    const Episode* findEpisode(int episodeNumber) const;
+    const Episode& getEpisode(int episodeNumber) const; // Falls back to the easiest episode
     bool unlockEpisode(int episodeNumber, int playerSkillPoints);
     bool isEpisodeUnlocked(int episodeNumber) const;
+    size_t getEpisodeCount() const { return entries.size(); }
     
-    Episode generateRandomEpisode(Difficulty difficulty);
-    Episode createCustomEpisode(const std::string& title, const PatternGrid& pattern);
+    // Adds to the catalog, replacing any episode with the same number
+    const Episode& addEpisode(const Episode& episode);
+    
+    // One-off episodes, kept out of the catalog: each call reuses a single
+    // slot, so the result is only valid until the next call of the same kind
+    const Episode& generateRandomEpisode(Difficulty difficulty, int size = 4);
+    const Episode& createCustomEpisode(const std::string& title, const PatternGrid& pattern);
+    
+    static const int RANDOM_EPISODE_NUMBER;
+    static const int CUSTOM_EPISODE_NUMBER;
+    
+    static std::string getSymbolsForDifficulty(Difficulty difficulty);
 
 private:
-    std::vector<Episode> episodes;
+    // Index record; enough to answer number and skill queries without
+    // decoding the episode itself
+    struct CatalogEntry {
+        int number;
+        int requiredSkillPoints;
+        bool unlocked;
+        size_t packIndex;           // NOT_IN_PACK unless the episode lives in the pack
+        mutable Episode* episode;   // Null until decoded
+    };
+    
+    const ContentPack& pack;
+    mutable std::deque<Episode> loaded; // Deque so addresses stay stable
+    std::vector<CatalogEntry> entries;
+    std::unordered_map<int, size_t> indexByNumber;
+    std::vector<size_t> bySkill; // Entry indices, sorted by (requiredSkillPoints, number)
+    mutable std::unordered_set<uint64_t> knownPatternHashes; // Canonical hashes, for dedup; bounded
+    PatternGenerator generator;
+    Episode randomSlot;
+    Episode customSlot;
+    
+    static const int MAX_GENERATION_ATTEMPTS;
+    static const size_t MAX_KNOWN_PATTERNS;
+    static const size_t NOT_IN_PACK;
     
     void initializeEpisodes();
-    PatternGrid generatePatternForDifficulty(Difficulty difficulty);
+    static std::vector<Episode> builtInEpisodes();
+    void indexPack();
+    void insertEntry(const CatalogEntry& entry);
+    void removeFromSkillIndex(size_t entryIndex);
+    const Episode* materialize(const CatalogEntry& entry) const;
+    bool rememberPattern(const PatternGrid& pattern) const; // False if already known
+    PatternGrid generatePatternForDifficulty(Difficulty difficulty, int size);
 };
\ No newline at end of file
@@ -3,22 +3,28 @@
 #include "../ui/CutsceneManager.h"
 #include "../utils/Random.h"
 #include <iostream>
-#include <cstdlib>
 
 using namespace std;
 
+const char* const GameManager::CURRENT_GAME_SLOT = "Current Game";
+
 GameManager::GameManager() {
     // Initialize random number generator
     Random::initialize();
+    leaderboard.load(Leaderboard::getDefaultPath());
+    
+    // Progress and statistics carry over from the last session's autosave
+    int currentEpisode = 1;
+    if (SaveSystem::saveExists("Auto Save")) {
+        SaveSystem::loadGame("Auto Save", gameData, currentEpisode);
+    }
 }
 
 void GameManager::run() {
-    while (true) {
-        showMainMenu();
-    }
+    while (showMainMenu()) {}
 }
 
-void GameManager::showMainMenu() {
+bool GameManager::showMainMenu() {
     ConsoleUI::clearScreen();
     ConsoleUI::showTitle("🚚 CLEARLINE DISPATCH");
     
@@ -50,17 +56,20 @@ void GameManager::showMainMenu() {
             showHelp();
             break;
         case 6:
+            // Returning rather than exiting lets main() flush the trace
             cout << "Thanks for playing Clearline Dispatch!\n";
-            exit(0);
+            return false;
     }
+    return true;
 }
 
 void GameManager::startNewGame() {
     Difficulty difficulty = selectDifficulty();
-    Episode episode = selectEpisode();
+    const Episode* episode = selectEpisode();
+    if (!episode) return; // Back to the main menu
     
     gameData.setDifficulty(difficulty);
-    playEpisode(episode);
+    playEpisode(*episode);
 }
 
 void GameManager::continueGame() {
@@ -76,10 +85,19 @@ void GameManager::continueGame() {
     string selectedSlot = saveSlots[choice - 1];
     
     if (SaveSystem::saveExists(selectedSlot)) {
+        // A slot holding an episode in progress resumes it where it stopped
+        DispatchGame game(PatternGrid(4), gameData.getDifficulty());
+        game.recordTo(gameData, 1);
+        if (game.loadGameState(selectedSlot)) {
+            ConsoleUI::showMessage("System", "Resuming your last delivery...");
+            runEpisode(game);
+            return;
+        }
+        
         int currentEpisode = 1;
         if (SaveSystem::loadGame(selectedSlot, gameData, currentEpisode)) {
             ConsoleUI::showMessage("System", "Game loaded successfully!");
-            Episode episode = episodeManager.getEpisode(currentEpisode);
+            const Episode& episode = episodeManager.getEpisode(currentEpisode);
             playEpisode(episode);
         } else {
             ConsoleUI::showMessage("System", "Failed to load game.");
@@ -107,6 +125,7 @@ void GameManager::showOptions() {
     vector<string> options = {
         "Change Difficulty (Current: " + difficultyStr + ")",
         gameData.isTutorialEnabled() ? "Disable Tutorial" : "Enable Tutorial",
+        builderAssist ? "Disable Builder Assist" : "Enable Builder Assist (guess garbled instructions)",
         "Back to Main Menu"
     };
     
@@ -124,6 +143,10 @@ void GameManager::showOptions() {
             ConsoleUI::showMessage("System", "Tutorial setting updated.");
             break;
         case 3:
+            builderAssist = !builderAssist;
+            ConsoleUI::showMessage("System", "Builder assist setting updated.");
+            break;
+        case 4:
             return;
     }
     
@@ -142,13 +165,41 @@ void GameManager::showStatistics() {
         {"Current Episode", to_string(gameData.getCurrentEpisode())}
     };
     
+    const GameStatistics& overall = gameData.getStatistics();
+    if (overall.getGamesPlayed() > 0) {
+        stats.push_back({"Median Accuracy", to_string(static_cast<int>(overall.accuracy.distribution.percentile(50))) + "%"});
+        stats.push_back({"90th Pct. Score", to_string(static_cast<int>(overall.score.distribution.percentile(90)))});
+        stats.push_back({"Average Turns", to_string(static_cast<int>(overall.turns.summary.getMean() + 0.5))});
+        stats.push_back({"Median Time", to_string(static_cast<int>(overall.time.distribution.percentile(50))) + "s"});
+        
+        const char* difficultyNames[] = {"Training", "Normal", "Hard", "Expert"};
+        for (int i = 0; i < 4; i++) {
+            const GameStatistics& byDifficulty = gameData.getStatistics(static_cast<Difficulty>(i));
+            if (byDifficulty.getGamesPlayed() == 0) continue;
+            stats.push_back({string(difficultyNames[i]) + " Games",
+                             to_string(byDifficulty.getGamesPlayed()) + " (avg " +
+                             to_string(static_cast<int>(byDifficulty.accuracy.summary.getMean())) + "%)"});
+        }
+    }
+    
     ConsoleUI::showStats(stats);
     
-    vector<string> achievements = gameData.getUnlockedAchievements();
+    vector<LeaderboardEntry> top = leaderboard.getTop(gameData.getDifficulty());
+    if (!top.empty()) {
+        cout << "\nLEADERBOARD (" << leaderboard.getEntryCount(gameData.getDifficulty()) << " results):\n";
+        for (size_t i = 0; i < top.size() && i < 5; i++) {
+            cout << "#" << (i + 1) << "  " << top[i].score << "  " << leaderboard.getPlayerName(top[i].player)
+                 << " (Episode " << top[i].episode << ")\n";
+        }
+    }
+    
+    const AchievementSet& achievements = gameData.getUnlockedAchievements();
     if (!achievements.empty()) {
         cout << "\nACHIEVEMENTS:\n";
-        for (const auto& achievement : achievements) {
-            cout << "🏆 " << achievement << "\n";
+        for (const auto& rule : AchievementRegistry::getDefault().getRules()) {
+            if (achievements.test(rule.id)) {
+                cout << "🏆 " << rule.name << " - " << rule.description << "\n";
+            }
         }
     }
     
@@ -175,22 +226,22 @@ Difficulty GameManager::selectDifficulty() {
     return static_cast<Difficulty>(choice - 1);
 }
 
-Episode GameManager::selectEpisode() {
+const Episode* GameManager::selectEpisode() {
     ConsoleUI::clearScreen();
     ConsoleUI::showTitle("SELECT EPISODE");
     
-    vector<Episode> availableEpisodes = episodeManager.getAvailableEpisodes(gameData.getSkillPoints());
+    vector<const Episode*> availableEpisodes = episodeManager.getAvailableEpisodes(gameData.getSkillPoints());
     
     if (availableEpisodes.empty()) {
         // Fallback to episode 1
-        return episodeManager.getEpisode(1);
+        return &episodeManager.getEpisode(1);
     }
     
     vector<string> episodeOptions;
-    for (const auto& episode : availableEpisodes) {
-        string option = "Episode " + to_string(episode.number) + ": " + episode.title;
-        if (episode.number > 1) {
-            option += " (Requires " + to_string(episode.requiredSkillPoints) + " skill points)";
+    for (const Episode* episode : availableEpisodes) {
+        string option = "Episode " + to_string(episode->number) + ": " + episode->title;
+        if (episode->number > 1) {
+            option += " (Requires " + to_string(episode->requiredSkillPoints) + " skill points)";
         }
         episodeOptions.push_back(option);
     }
@@ -204,11 +255,10 @@ Episode GameManager::selectEpisode() {
         return availableEpisodes[choice - 1];
     } else if (choice == static_cast<int>(availableEpisodes.size()) + 1) {
         // Random challenge
-        return episodeManager.generateRandomEpisode(gameData.getDifficulty());
+        return &episodeManager.generateRandomEpisode(gameData.getDifficulty());
     } else {
         // Back to main menu
-        showMainMenu();
-        return availableEpisodes[0]; // Fallback
+        return nullptr;
     }
 }
 
@@ -216,10 +266,21 @@ void GameManager::playEpisode(const Episode& episode) {
     CutsceneManager::showTransmissionEffect();
     
     DispatchGame game(episode.pattern, gameData.getDifficulty());
+    game.recordTo(gameData, episode.number);
+    runEpisode(game);
+}
+
+void GameManager::runEpisode(DispatchGame& game) {
+    game.setGarbleRecovery(builderAssist);
+    game.setBeliefInference(builderAssist);
+    game.enableJournal(CURRENT_GAME_SLOT);
     game.playEpisode();
     
-    // Check for episode unlocks
-    if (episode.number == gameData.getCurrentEpisode()) {
-        episodeManager.unlockEpisode(episode.number + 1, gameData.getSkillPoints());
-    }
+    leaderboard.submit("Player", game.getEpisodeNumber(), gameData.getDifficulty(), game.calculateMetrics().score);
+    leaderboard.save(Leaderboard::getDefaultPath());
+    
+    // Completing the current episode advances it; unlock it once affordable
+    episodeManager.unlockEpisode(gameData.getCurrentEpisode(), gameData.getSkillPoints());
+    
+    SaveSystem::saveGame("Auto Save", gameData, gameData.getCurrentEpisode());
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "EpisodeManager.h"
 #include "../data/GameData.h"
 #include "../data/SaveSystem.h"
+#include "../data/Leaderboard.h"
 #include <string>
 #include <vector>
 
@@ -14,8 +15,10 @@ public:
 private:
     GameData gameData;
     EpisodeManager episodeManager;
+    Leaderboard leaderboard;
+    bool builderAssist = false; // DispatchGame garble recovery and belief inference
     
-    void showMainMenu();
+    bool showMainMenu(); // False once the player quits
     void startNewGame();
     void continueGame();
     void showOptions();
@@ -23,6 +26,9 @@ private:
     void showHelp();
     
     Difficulty selectDifficulty();
-    Episode selectEpisode();
+    const Episode* selectEpisode(); // Null to go back to the main menu
     void playEpisode(const Episode& episode);
+    void runEpisode(DispatchGame& game); // New or resumed
+    
+    static const char* const CURRENT_GAME_SLOT; // Journaled while an episode is in progress
 };
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "PatternGenerator.h"
+#include "EpisodeManager.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+
+const int PatternGenerator::MAX_ATTEMPTS = 64;
+const double PatternGenerator::DEFAULT_TOLERANCE = 0.08;
+
+PatternGenerator::PatternGenerator(uint64_t seed)
+    : stream(seed), seed(seed), batchesGenerated(0), tolerance(DEFAULT_TOLERANCE) {}
+
+PatternGrid PatternGenerator::generate(int size, Difficulty difficulty) {
+    return generate(size, EpisodeManager::getSymbolsForDifficulty(difficulty), getTargetComplexity(difficulty));
+}
+
+PatternGrid PatternGenerator::generate(int size, const string& symbols, double targetComplexity) {
+    return generateWith(stream, size, symbols, targetComplexity, tolerance);
+}
+
+vector<PatternGrid> PatternGenerator::generateBatch(int count, int size, Difficulty difficulty, int threads,
+                                                    const unordered_set<uint64_t>* exclude) {
+    string symbols = EpisodeManager::getSymbolsForDifficulty(difficulty);
+    double target = getTargetComplexity(difficulty);
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    threads = max(1, min(threads, count));
+    pool.resize(threads); // Started on the first batch, reused by the rest
+
+    vector<PatternGrid> accepted;
+    unordered_set<uint64_t> seen;
+    if (exclude) seen = *exclude;
+
+    // Each round splits what's missing across threads with independent
+    // streams; duplicates are dropped on merge and made up next round
+    for (int round = 0; round < MAX_ATTEMPTS && static_cast<int>(accepted.size()) < count; round++) {
+        int missing = count - static_cast<int>(accepted.size());
+        int workers = min(threads, missing);
+        vector<vector<pair<uint64_t, PatternGrid>>> results(workers);
+        uint64_t batchId = batchesGenerated++;
+
+        auto work = [&, batchId](int worker) {
+            RandomStream rng(seed ^ (batchId * 0x9E3779B97F4A7C15ULL) ^ (uint64_t(worker + 1) << 32));
+            int quota = missing / workers + (worker < missing % workers ? 1 : 0);
+            unordered_set<uint64_t> local;
+            for (int i = 0; i < quota; i++) {
+                PatternGrid grid = generateWith(rng, size, symbols, target, tolerance);
+                uint64_t key = grid.getCanonicalHash();
+                if (local.insert(key).second) {
+                    results[worker].emplace_back(key, move(grid));
+                }
+            }
+        };
+
+        pool.run(workers, workers, [&](int begin, int end) {
+            for (int worker = begin; worker < end; worker++) work(worker);
+        });
+
+        for (auto& batch : results) {
+            for (auto& candidate : batch) {
+                if (static_cast<int>(accepted.size()) < count && seen.insert(candidate.first).second) {
+                    accepted.push_back(move(candidate.second));
+                }
+            }
+        }
+    }
+
+    return accepted;
+}
+
+int PatternGenerator::estimateProgramLength(const PatternGrid& grid) {
+    // Cheapest of a few program shapes the Builder supports: one SET per
+    // cell; FILL per row (or column) plus SETs; and a REPLACE ALL background
+    // followed by per-row (or per-column) fixes
+    int n = grid.getSize();
+    if (n == 0) return 0;
+
+    array<int, 256> global{};
+    for (int row = 0; row < n; row++) {
+        const char* cells = grid.getRowData(row);
+        for (int col = 0; col < n; col++) global[static_cast<unsigned char>(cells[col])]++;
+    }
+
+    int blank = static_cast<unsigned char>('_');
+    int nonBlank = n * n - global[blank];
+    if (nonBlank == 0) return 0;
+
+    int background = 0;
+    for (int s = 0; s < 256; s++) {
+        if (s != blank && global[s] > global[background]) background = s;
+    }
+
+    auto lineCosts = [&](bool byRow, int& fillCost, int& backgroundCost) {
+        fillCost = 0;
+        backgroundCost = 1;
+        array<int, 256> counts;
+        for (int line = 0; line < n; line++) {
+            counts.fill(0);
+            for (int i = 0; i < n; i++) {
+                char c = byRow ? grid.getRowData(line)[i] : grid.getRowData(i)[line];
+                counts[static_cast<unsigned char>(c)]++;
+            }
+            int best = 0;
+            for (int s = 0; s < 256; s++) {
+                if (s != blank) best = max(best, counts[s]);
+            }
+            int lineNonBlank = n - counts[blank];
+            int fillLine = 1 + (n - best);
+            fillCost += min(lineNonBlank, fillLine);
+            backgroundCost += min(n - counts[background], fillLine);
+        }
+    };
+
+    int rowFill, rowBackground, colFill, colBackground;
+    lineCosts(true, rowFill, rowBackground);
+    lineCosts(false, colFill, colBackground);
+
+    return min({nonBlank, rowFill, colFill, rowBackground, colBackground});
+}
+
+double PatternGenerator::estimateComplexity(const PatternGrid& grid) {
+    int cells = grid.getSize() * grid.getSize();
+    return cells > 0 ? static_cast<double>(estimateProgramLength(grid)) / cells : 0.0;
+}
+
+double PatternGenerator::getTargetComplexity(Difficulty difficulty) {
+    switch (difficulty) {
+        case Difficulty::TRAINING:
+            return 0.2;
+        case Difficulty::HARD:
+            return 0.5;
+        case Difficulty::EXPERT:
+            return 0.7;
+        case Difficulty::NORMAL:
+        default:
+            return 0.35;
+    }
+}
+
+PatternGrid PatternGenerator::generateWith(RandomStream& rng, int size, const string& symbols,
+                                           double target, double tolerance) {
+    PatternGrid grid(size);
+    if (size <= 0 || symbols.empty()) return grid;
+
+    // A few random line and block fills for shape, then k single-cell SETs;
+    // adjust k until the measured complexity lands in the band, keeping the
+    // closest candidate as a fallback. Fills alone level off around 0.6,
+    // since each one overwrites most of the last, so they can't carry the
+    // higher targets on their own
+    int cells = size * size;
+    int fills = static_cast<int>(lround((1.0 - target) * size * 2));
+    int edits = max(0, static_cast<int>(lround(target * cells)) - fills);
+    PatternGrid best(size);
+    double bestError = 2.0;
+
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        buildCandidate(rng, grid, symbols, fills, edits);
+        double complexity = estimateComplexity(grid);
+        double error = fabs(complexity - target);
+
+        if (error <= tolerance / 2) return grid;
+        if (error < bestError) {
+            bestError = error;
+            best = grid;
+        }
+
+        // Step by the shortfall in cells; one edit per attempt never gets
+        // there on a large grid
+        int step = max(1, static_cast<int>(lround(error * cells)));
+        if (complexity < target) edits = min(edits + step, cells * 4);
+        else edits = max(0, edits - step);
+    }
+
+    return best;
+}
+
+void PatternGenerator::buildCandidate(RandomStream& rng, PatternGrid& grid, const string& symbols, int fills, int edits) {
+    int size = grid.getSize();
+    int last = static_cast<int>(symbols.length()) - 1;
+    auto symbol = [&]() { return symbols[rng.getInt(0, last)]; };
+
+    grid.clear();
+    grid.replaceAll('_', symbol());
+
+    for (int op = 0; op < fills; op++) {
+        switch (rng.getInt(0, 2)) {
+            case 0:
+                grid.fillRow(rng.getInt(0, size - 1), symbol());
+                break;
+            case 1:
+                grid.fillColumn(rng.getInt(0, size - 1), symbol());
+                break;
+            default: {
+                // Small rectangle, the kind a Dispatcher describes as a block
+                int height = rng.getInt(1, max(1, size / 2));
+                int width = rng.getInt(1, max(1, size / 2));
+                int top = rng.getInt(0, size - height);
+                int left = rng.getInt(0, size - width);
+                char value = symbol();
+                for (int row = top; row < top + height; row++) {
+                    for (int col = left; col < left + width; col++) grid.setCell(row, col, value);
+                }
+                break;
+            }
+        }
+    }
+
+    for (int edit = 0; edit < edits; edit++) {
+        grid.setCell(rng.getInt(0, size - 1), rng.getInt(0, size - 1), symbol());
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "../core/PatternGrid.h"
+#include "../data/GameData.h"
+#include "../utils/Random.h"
+#include "../utils/WorkerPool.h"
+#include <vector>
+#include <string>
+#include <unordered_set>
+
+// Procedural targets calibrated by how hard they are to describe, not just by
+// alphabet size. Complexity is the estimated length of the shortest Builder
+// program for the grid, divided by the number of cells (0 = trivial, 1 = one
+// SET per cell).
+class PatternGenerator {
+public:
+    PatternGenerator(uint64_t seed = 0);
+
+    PatternGrid generate(int size, Difficulty difficulty);
+    PatternGrid generate(int size, const std::string& symbols, double targetComplexity);
+
+    // Distinct up to rotation, reflection and relabeling, also against `exclude`.
+    // threads <= 0 uses every hardware thread; the pool is kept between batches.
+    std::vector<PatternGrid> generateBatch(int count, int size, Difficulty difficulty, int threads = 0,
+                                           const std::unordered_set<uint64_t>* exclude = nullptr);
+
+    void setTolerance(double newTolerance) { tolerance = newTolerance; }
+    double getTolerance() const { return tolerance; }
+
+    static int estimateProgramLength(const PatternGrid& grid);
+    static double estimateComplexity(const PatternGrid& grid);
+    static double getTargetComplexity(Difficulty difficulty);
+
+private:
+    RandomStream stream;
+    uint64_t seed;
+    uint64_t batchesGenerated;
+    double tolerance;
+    WorkerPool pool;
+
+    static const int MAX_ATTEMPTS;
+    static const double DEFAULT_TOLERANCE;
+
+    static PatternGrid generateWith(RandomStream& rng, int size, const std::string& symbols,
+                                    double target, double tolerance);
+    static void buildCandidate(RandomStream& rng, PatternGrid& grid, const std::string& symbols, int fills, int edits);
+};
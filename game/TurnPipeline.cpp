@@ -0,0 +1,194 @@
+#include "TurnPipeline.h"
+#include "../roles/Builder.h"
+#include "../utils/SpscQueue.h"
+#include "../utils/MpscQueue.h"
+#include "../utils/Random.h"
+#include "../utils/ScratchArena.h"
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+struct Envelope {
+    uint32_t game = 0;
+    string text;
+};
+
+const uint32_t END_OF_STREAM = UINT32_MAX;
+
+// Builder-side state of one game; shared by both run modes so they score alike
+struct GameState {
+    Builder builder;
+    int turn = 0;
+    bool done = false;
+};
+
+void playTurn(GameState& state, const PatternGrid& target, const DifficultySettings& settings,
+              string delivered, TurnPipeline::Result& result, size_t game) {
+    ScratchArena::Scope scratch;
+    state.turn++;
+    state.builder.executeInstruction(delivered);
+    result.delivered[game].push_back(move(delivered));
+    result.turnsPlayed++;
+
+    // One message per turn, so the two limits are checked against the same count
+    if (state.turn >= settings.maxTurns || state.turn >= settings.messageLimit ||
+        state.builder.getCurrentGrid() == target) {
+        state.done = true;
+    }
+}
+
+void finish(vector<GameState>& states, const vector<PatternGrid>& targets,
+            const DifficultySettings& settings, TurnPipeline::Result& result) {
+    for (size_t g = 0; g < states.size(); g++) {
+        GameMetrics metrics{};
+        metrics.accuracy = targets[g].calculateAccuracy(states[g].builder.getCurrentGrid());
+        metrics.turnsTaken = states[g].turn;
+        metrics.messagesUsed = states[g].turn;
+        metrics.timeElapsed = chrono::seconds(0);
+        metrics.score = DispatchGame::computeScore(metrics.accuracy, metrics.turnsTaken, metrics.messagesUsed,
+                                                   settings.maxTurns, settings.messageLimit);
+        result.metrics.push_back(metrics);
+        result.grids.push_back(states[g].builder.getCurrentGrid());
+    }
+}
+
+}
+
+TurnPipeline::TurnPipeline(Difficulty difficulty, uint64_t seed)
+    : difficulty(difficulty), settings(DispatchGame::getDifficultySettings(difficulty)), seed(seed),
+      messengerThreads(1), queueCapacity(1024), noise(settings.noiseLevel) {}
+
+uint64_t TurnPipeline::gameSeed(size_t game) const {
+    return seed ^ (static_cast<uint64_t>(game) * 0x9E3779B97F4A7C15ULL);
+}
+
+TurnPipeline::Result TurnPipeline::runSequential(const vector<PatternGrid>& targets,
+                                                 const vector<vector<string>>& scripts) const {
+    size_t games = min(targets.size(), scripts.size());
+    Result result;
+    result.delivered.resize(games);
+    vector<GameState> states(games);
+
+    for (size_t g = 0; g < games; g++) {
+        states[g].builder = Builder(targets[g].getSize());
+        states[g].builder.setActionLogging(false); // Nobody reads it here
+        RandomStream stream(gameSeed(g));
+        for (const string& message : scripts[g]) {
+            if (states[g].done) break;
+            ScratchArena::Scope scratch; // Noise and build share the turn's rewind
+            playTurn(states[g], targets[g], settings, noise.applyNoise(message, stream), result, g);
+        }
+    }
+
+    finish(states, targets, settings, result);
+    return result;
+}
+
+TurnPipeline::Result TurnPipeline::run(const vector<PatternGrid>& targets,
+                                       const vector<vector<string>>& scripts) const {
+    size_t games = min(targets.size(), scripts.size());
+    size_t workers = static_cast<size_t>(messengerThreads);
+    Result result;
+    result.delivered.resize(games);
+    vector<GameState> states(games);
+    for (size_t g = 0; g < games; g++) {
+        states[g].builder = Builder(targets[g].getSize());
+        states[g].builder.setActionLogging(false); // Nobody reads it here
+    }
+
+    // Set by the Builder stage; lets the Dispatcher stop feeding finished games
+    unique_ptr<atomic<bool>[]> finished(new atomic<bool>[games]);
+    for (size_t g = 0; g < games; g++) finished[g].store(false, memory_order_relaxed);
+
+    vector<unique_ptr<SpscQueue<Envelope>>> toMessenger;
+    for (size_t w = 0; w < workers; w++) {
+        toMessenger.push_back(make_unique<SpscQueue<Envelope>>(queueCapacity));
+    }
+    MpscQueue<Envelope> toBuilder(queueCapacity);
+
+    size_t longest = 0;
+    for (size_t g = 0; g < games; g++) longest = max(longest, scripts[g].size());
+    size_t turnLimit = static_cast<size_t>(min(settings.maxTurns, settings.messageLimit));
+
+    // Dispatcher: turn k of every game, then turn k + 1, so consecutive
+    // messages belong to different games and the stages overlap
+    thread dispatcher([&]() {
+        for (size_t turn = 0; turn < min(longest, turnLimit); turn++) {
+            for (size_t g = 0; g < games; g++) {
+                if (turn >= scripts[g].size() || finished[g].load(memory_order_relaxed)) continue;
+                Envelope envelope;
+                envelope.game = static_cast<uint32_t>(g);
+                envelope.text = scripts[g][turn];
+                toMessenger[g % workers]->push(move(envelope));
+            }
+        }
+        for (auto& queue : toMessenger) {
+            Envelope end;
+            end.game = END_OF_STREAM;
+            queue->push(move(end));
+        }
+    });
+
+    // Messengers: worker w owns games g % workers == w and their streams
+    vector<thread> messengers;
+    for (size_t w = 0; w < workers; w++) {
+        messengers.emplace_back([&, w]() {
+            vector<RandomStream> streams;
+            for (size_t g = w; g < games; g += workers) {
+                streams.emplace_back(gameSeed(g));
+            }
+
+            Envelope envelope;
+            while (true) {
+                toMessenger[w]->pop(envelope);
+                if (envelope.game != END_OF_STREAM) {
+                    envelope.text = noise.applyNoise(envelope.text, streams[envelope.game / workers]);
+                    toBuilder.push(move(envelope));
+                    continue;
+                }
+                toBuilder.push(move(envelope));
+                break;
+            }
+        });
+    }
+
+    // Builder, on this thread. Messages for games that already ended were
+    // noised speculatively and are dropped here.
+    size_t ended = 0;
+    Envelope envelope;
+    while (ended < workers) {
+        toBuilder.pop(envelope);
+        if (envelope.game == END_OF_STREAM) {
+            ended++;
+            continue;
+        }
+        GameState& state = states[envelope.game];
+        if (state.done) continue;
+        playTurn(state, targets[envelope.game], settings, move(envelope.text), result, envelope.game);
+        if (state.done) finished[envelope.game].store(true, memory_order_relaxed);
+    }
+
+    dispatcher.join();
+    for (auto& messenger : messengers) messenger.join();
+
+    finish(states, targets, settings, result);
+    return result;
+}
+
+vector<string> TurnPipeline::scriptFor(const PatternGrid& target) {
+    vector<string> script;
+    int size = target.getSize();
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            char value = target.getCell(row, col);
+            if (value == '_') continue;
+            script.push_back("SET(" + to_string(row + 1) + "," + to_string(col + 1) + ")=" + value);
+        }
+    }
+    return script;
+}
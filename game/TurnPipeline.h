@@ -0,0 +1,53 @@
+#pragma once
+#include "../core/PatternGrid.h"
+#include "../core/MessageSystem.h"
+#include "../data/GameData.h"
+#include "DispatchGame.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Simulation mode for DispatchGame's turn: Dispatcher -> Messenger ->
+// Builder as pipeline stages on their own threads, joined by lock-free
+// queues. Because the scripts are known up front, the Dispatcher runs
+// ahead and the Messenger noises message k+1 while the Builder executes
+// message k. With several Messenger workers each owns a fixed subset of
+// games, so every game still sees its messages in order.
+//
+// Like BatchEnvironment, only channel noise is simulated (the Messenger's
+// interactive paraphrasing is not), and each game draws from its own
+// RandomStream, so the threaded run matches runSequential exactly.
+class TurnPipeline {
+public:
+    struct Result {
+        std::vector<GameMetrics> metrics;
+        std::vector<PatternGrid> grids;
+        std::vector<std::vector<std::string>> delivered; // What each Builder actually heard
+        uint64_t turnsPlayed = 0;
+    };
+
+    TurnPipeline(Difficulty difficulty = Difficulty::NORMAL, uint64_t seed = 0);
+
+    // scripts[g] is game g's Dispatcher messages, one per turn. A game ends
+    // like DispatchGame's: turn or message limit, or a completed grid.
+    Result run(const std::vector<PatternGrid>& targets,
+               const std::vector<std::vector<std::string>>& scripts) const;
+    Result runSequential(const std::vector<PatternGrid>& targets,
+                         const std::vector<std::vector<std::string>>& scripts) const;
+
+    void setMessengerThreads(int threads) { messengerThreads = threads < 1 ? 1 : threads; }
+    void setQueueCapacity(size_t capacity) { queueCapacity = capacity; }
+
+    // One SET per wrong cell - a simple scripted Dispatcher
+    static std::vector<std::string> scriptFor(const PatternGrid& target);
+
+private:
+    Difficulty difficulty;
+    DifficultySettings settings;
+    uint64_t seed;
+    int messengerThreads;
+    size_t queueCapacity;
+    MessageNoiseSimulator noise; // Only its const, stream-based path is used
+
+    uint64_t gameSeed(size_t game) const;
+};
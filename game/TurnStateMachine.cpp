@@ -0,0 +1,108 @@
+#include "TurnStateMachine.h"
+
+using namespace std;
+
+TurnStateMachine::TurnStateMachine(DispatchGame& game, EventLoop& loop, InputSource& input,
+                                   function<void()> onFinished)
+    : game(game), loop(loop), input(input), onFinished(move(onFinished)), state(State::IDLE),
+      episodeTimer(EventLoop::INVALID_TIMER), timeouts(0) {}
+
+TurnStateMachine::~TurnStateMachine() {
+    loop.cancelTimer(episodeTimer);
+    if (state != State::IDLE && state != State::FINISHED) input.cancel();
+}
+
+void TurnStateMachine::start() {
+    if (state != State::IDLE) return;
+
+    int64_t remaining = game.getTimeRemainingMs();
+    if (remaining >= 0) {
+        episodeTimer = loop.addTimer(remaining, [this]() {
+            episodeTimer = EventLoop::INVALID_TIMER;
+            if (state == State::FINISHED) return;
+            input.cancel();
+            game.expireTime();
+            finish();
+        });
+    }
+    nextTurn();
+}
+
+void TurnStateMachine::nextTurn() {
+    if (game.isOver()) {
+        finish();
+        return;
+    }
+
+    game.beginTurn();
+    if (!game.needsInstruction()) {
+        relay(game.openingInstruction());
+        return;
+    }
+
+    state = State::AWAITING_INSTRUCTION;
+    input.requestLine("Enter your instructions to Messenger: ", game.getTurnTimeLimitMs(),
+                      [this](InputStatus status, const string& line) { onInstruction(status, line); });
+}
+
+void TurnStateMachine::onInstruction(InputStatus status, const string& line) {
+    switch (status) {
+        case InputStatus::LINE:
+            relay(line);
+            break;
+        case InputStatus::TIMEOUT:
+            timeouts++;
+            game.forfeitTurn();
+            endTurn();
+            break;
+        case InputStatus::CLOSED:
+        default:
+            finish(); // Nobody left to play; score what's on the grid
+            break;
+    }
+}
+
+void TurnStateMachine::relay(const string& instruction) {
+    game.relayInstruction(instruction);
+    pause(&TurnStateMachine::build);
+}
+
+void TurnStateMachine::build() {
+    game.buildRelayed();
+    if (game.isComplete()) {
+        endTurn();
+    } else {
+        pause(&TurnStateMachine::endTurn);
+    }
+}
+
+void TurnStateMachine::endTurn() {
+    // Through the loop, so a long game doesn't recurse and other games get a turn
+    state = State::IDLE;
+    loop.post([this]() {
+        if (state != State::FINISHED) nextTurn();
+    });
+}
+
+void TurnStateMachine::pause(void (TurnStateMachine::*then)()) {
+    if (!game.isInteractive()) {
+        (this->*then)();
+        return;
+    }
+
+    state = State::AWAITING_CONTINUE;
+    // Closed input carries on too; the next instruction request ends the game
+    input.requestLine("Press Enter to continue...", 0, [this, then](InputStatus, const string&) {
+        (this->*then)();
+    });
+}
+
+void TurnStateMachine::finish() {
+    if (state == State::FINISHED) return;
+    state = State::FINISHED;
+    loop.cancelTimer(episodeTimer);
+    episodeTimer = EventLoop::INVALID_TIMER;
+
+    game.finishEpisode();
+    if (onFinished) onFinished();
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "DispatchGame.h"
+#include "../utils/EventLoop.h"
+#include "../ui/AsyncInput.h"
+#include <functional>
+#include <string>
+
+// DispatchGame's turn flow as a state machine on an EventLoop. Nothing
+// blocks: input arrives through InputSource callbacks and the time limits
+// are loop timers, so any number of games can be interleaved on one thread,
+// each with its own InputSource.
+//
+//   AWAITING_INSTRUCTION -> (relay) -> AWAITING_CONTINUE -> (build)
+//     -> AWAITING_CONTINUE -> next turn ... -> FINISHED
+//
+// The AWAITING_CONTINUE pauses ("Press Enter") only happen in interactive
+// games. An instruction that misses the turn time limit forfeits the turn;
+// the episode time limit ends the game wherever it is.
+class TurnStateMachine {
+public:
+    enum class State {
+        IDLE,
+        AWAITING_INSTRUCTION,
+        AWAITING_CONTINUE,
+        FINISHED
+    };
+
+    TurnStateMachine(DispatchGame& game, EventLoop& loop, InputSource& input,
+                     std::function<void()> onFinished = nullptr);
+    ~TurnStateMachine();
+
+    TurnStateMachine(const TurnStateMachine&) = delete;
+    TurnStateMachine& operator=(const TurnStateMachine&) = delete;
+
+    void start();
+    State getState() const { return state; }
+    bool isFinished() const { return state == State::FINISHED; }
+    int getTimeouts() const { return timeouts; }
+
+private:
+    DispatchGame& game;
+    EventLoop& loop;
+    InputSource& input;
+    std::function<void()> onFinished;
+    State state;
+    EventLoop::TimerId episodeTimer;
+    int timeouts;
+
+    void nextTurn();
+    void onInstruction(InputStatus status, const std::string& line);
+    void relay(const std::string& instruction);
+    void build();
+    void endTurn();
+    void pause(void (TurnStateMachine::*then)());
+    void finish();
+};
@@ -1,15 +1,25 @@
 #include "game/GameManager.h"
+#include "ui/TerminalRenderer.h"
+#include "utils/Trace.h"
 #include <iostream>
 
 using namespace std;
 
 int main() {
+    TerminalRenderer::install();
+    
     try {
         GameManager game;
         game.run();
     } catch (const exception& e) {
+        TerminalRenderer::uninstall();
         cerr << "Fatal error: " << e.what() << endl;
         return 1;
     }
+    
+    if (Trace::isCompiledIn()) {
+        Trace::writeChromeJson("dispatch_trace.json");
+        cerr << Trace::formatSummary();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,429 @@
+#include "GameServer.h"
+#include "Socket.h"
+#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+using namespace std;
+
+const int GameServer::MAX_EVENTS = 256;
+const size_t GameServer::READ_CHUNK = 16384;
+const size_t GameServer::MAX_UNJOINED_PER_CONNECTION = 8;
+
+namespace {
+
+// A client that stops reading gets dropped instead of growing our buffers
+const size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+}
+
+GameServer::GameServer(uint64_t seed)
+    : epollFd(epoll_create1(EPOLL_CLOEXEC)), generator(seed), seed(seed), nextSessionId(1), stopping(false) {
+    for (int level = 0; level <= static_cast<int>(NoiseLevel::EXTREME); level++) {
+        noiseByLevel.push_back(make_unique<MessageNoiseSimulator>(static_cast<NoiseLevel>(level)));
+    }
+}
+
+GameServer::~GameServer() {
+    for (const auto& entry : connections) {
+        Socket::closeQuietly(entry.first);
+    }
+    for (int listener : listeners) {
+        Socket::closeQuietly(listener);
+    }
+    for (const auto& path : unixPaths) {
+        unlink(path.c_str());
+    }
+    Socket::closeQuietly(epollFd);
+}
+
+bool GameServer::listenTcp(const string& host, int port) {
+    return addListener(Socket::listenTcp(host, port));
+}
+
+bool GameServer::listenUnix(const string& path) {
+    if (!addListener(Socket::listenUnix(path))) return false;
+    unixPaths.push_back(path);
+    return true;
+}
+
+bool GameServer::addListener(int fd) {
+    if (fd < 0 || epollFd < 0) {
+        Socket::closeQuietly(fd);
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        Socket::closeQuietly(fd);
+        return false;
+    }
+    listeners.push_back(fd);
+    return true;
+}
+
+void GameServer::run() {
+    // The timeout only bounds how long stop() takes to be noticed
+    while (!stopping && poll(200)) {
+    }
+}
+
+bool GameServer::poll(int timeoutMs) {
+    epoll_event events[MAX_EVENTS];
+    int count = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+    if (count < 0) return errno == EINTR;
+
+    for (int i = 0; i < count; i++) {
+        int fd = events[i].data.fd;
+        if (find(listeners.begin(), listeners.end(), fd) != listeners.end()) {
+            acceptClients(fd);
+            continue;
+        }
+
+        auto it = connections.find(fd);
+        if (it == connections.end() || it->second.closing) continue;
+        Connection& connection = it->second;
+
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            readFrom(connection);
+        }
+        if ((events[i].events & EPOLLOUT) && !connection.closing) {
+            flush(connection);
+        }
+    }
+
+    // Closing is deferred to here so a descriptor number can't be reused
+    // while events for its old connection are still in this batch
+    // (closing one can queue more, e.g. a LEFT that fails to send)
+    for (size_t i = 0; i < pendingClose.size(); i++) {
+        closeConnection(pendingClose[i]);
+    }
+    pendingClose.clear();
+
+    stats.openConnections = connections.size();
+    stats.activeSessions = sessions.size();
+    return true;
+}
+
+void GameServer::acceptClients(int listener) {
+    while (true) {
+        int fd = Socket::acceptClient(listener);
+        if (fd < 0) return; // EAGAIN, or out of descriptors until someone leaves
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            Socket::closeQuietly(fd);
+            continue;
+        }
+
+        Connection& connection = connections[fd];
+        connection.fd = fd;
+        stats.connectionsAccepted++;
+    }
+}
+
+void GameServer::readFrom(Connection& connection) {
+    char buffer[READ_CHUNK];
+    bool finished = false;
+    while (true) {
+        ssize_t received = ::read(connection.fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<size_t>(received));
+            if (static_cast<size_t>(received) < sizeof(buffer)) break;
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (received < 0 && errno == EINTR) continue;
+
+        finished = true; // EOF or error; still handle what arrived
+        break;
+    }
+
+    string line;
+    while (connection.input.nextLine(line)) {
+        handleLine(connection, line);
+    }
+    if (finished) {
+        requestClose(connection);
+    } else if (connection.input.overflowed()) {
+        send(connection, Protocol::format("ERROR", "line too long"));
+        requestClose(connection);
+    }
+}
+
+void GameServer::flush(Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = ::send(connection.fd, connection.output.data() + connection.outputSent,
+                              connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.outputSent += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!connection.watchingWrites) {
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.fd = connection.fd;
+                epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+                connection.watchingWrites = true;
+            }
+            return;
+        }
+        requestClose(connection);
+        return;
+    }
+
+    connection.output.clear();
+    connection.outputSent = 0;
+    if (connection.watchingWrites) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = connection.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.watchingWrites = false;
+    }
+}
+
+void GameServer::send(Connection& connection, const string& line) {
+    if (connection.output.size() - connection.outputSent > MAX_PENDING_OUTPUT) {
+        requestClose(connection);
+        return;
+    }
+    connection.output += line;
+
+    // Write straight away; only fall back to EPOLLOUT when the socket is full
+    if (!connection.watchingWrites) {
+        flush(connection);
+    }
+}
+
+void GameServer::sendTo(int fd, const string& line) {
+    auto it = connections.find(fd);
+    if (it != connections.end()) {
+        send(it->second, line);
+    }
+}
+
+void GameServer::broadcast(const GameSession& session, const string& line) {
+    for (Role role : {Role::DISPATCHER, Role::MESSENGER, Role::BUILDER}) {
+        int fd = session.getConnection(role);
+        if (fd >= 0) sendTo(fd, line);
+    }
+}
+
+void GameServer::requestClose(Connection& connection) {
+    if (connection.closing) return;
+    connection.closing = true;
+    pendingClose.push_back(connection.fd);
+}
+
+void GameServer::closeConnection(int fd) {
+    auto it = connections.find(fd);
+    if (it == connections.end()) return;
+
+    GameSession* session = sessionOf(it->second);
+    if (session) {
+        Role role;
+        if (session->leave(fd, role)) {
+            broadcast(*session, Protocol::format("LEFT", Protocol::roleName(role)));
+        }
+        if (session->isEmpty()) {
+            sessions.erase(session->getId());
+        }
+    }
+
+    // Sessions this client created that nobody ever joined would otherwise live forever
+    for (uint32_t id : it->second.created) {
+        auto created = sessions.find(id);
+        if (created != sessions.end() && created->second->isEmpty()) {
+            sessions.erase(created);
+        }
+    }
+
+    // Best effort for anything still queued, e.g. a final ERROR
+    if (it->second.outputSent < it->second.output.size()) {
+        ::send(fd, it->second.output.data() + it->second.outputSent,
+               it->second.output.size() - it->second.outputSent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    Socket::closeQuietly(fd);
+    connections.erase(it);
+}
+
+void GameServer::handleLine(Connection& connection, const string& line) {
+    if (connection.closing || line.empty()) return;
+
+    ProtocolMessage message = Protocol::parse(line);
+    if (message.verb == "CREATE") {
+        handleCreate(connection, message.argument);
+    } else if (message.verb == "JOIN") {
+        handleJoin(connection, message.argument);
+    } else if (message.verb == "QUIT") {
+        requestClose(connection);
+    } else if (message.verb == "SEND" || message.verb == "BUILD") {
+        GameSession* session = sessionOf(connection);
+        if (!session || !session->started) {
+            send(connection, Protocol::format("ERROR", "game has not started"));
+        } else if (message.verb == "SEND") {
+            handleSend(connection, *session, message.argument);
+        } else {
+            handleBuild(connection, *session, message.argument);
+        }
+    } else {
+        send(connection, Protocol::format("ERROR", "unknown command " + message.verb));
+    }
+}
+
+void GameServer::handleCreate(Connection& connection, const string& argument) {
+    Difficulty difficulty;
+    if (!Protocol::parseDifficulty(argument, difficulty)) {
+        send(connection, Protocol::format("ERROR", "unknown difficulty"));
+        return;
+    }
+
+    if (pruneCreated(connection) >= MAX_UNJOINED_PER_CONNECTION) {
+        send(connection, Protocol::format("ERROR", "too many sessions waiting for players"));
+        return;
+    }
+
+    uint32_t id = nextSessionId++;
+    if (nextSessionId == 0) nextSessionId = 1; // 0 means "no session"
+
+    PatternGrid target = generator.generate(4, difficulty);
+    sessions[id] = make_unique<GameSession>(id, difficulty, target, seed ^ (id * 0x9E3779B97F4A7C15ULL));
+    connection.created.push_back(id);
+    stats.sessionsCreated++;
+    send(connection, Protocol::format("CREATED", to_string(id)));
+}
+
+void GameServer::handleJoin(Connection& connection, const string& argument) {
+    istringstream in(argument);
+    uint32_t id = 0;
+    string roleText;
+    Role role;
+    if (!(in >> id >> roleText) || !Protocol::parseRole(roleText, role)) {
+        send(connection, Protocol::format("ERROR", "usage: JOIN <session> <role>"));
+        return;
+    }
+    if (connection.session != 0) {
+        send(connection, Protocol::format("ERROR", "already in a session"));
+        return;
+    }
+
+    auto it = sessions.find(id);
+    if (it == sessions.end()) {
+        send(connection, Protocol::format("ERROR", "no such session"));
+        return;
+    }
+    GameSession& session = *it->second;
+    if (!session.join(role, connection.fd)) {
+        send(connection, Protocol::format("ERROR", "role already taken"));
+        return;
+    }
+
+    connection.session = id;
+    send(connection, Protocol::format("JOINED", to_string(id) + " " + Protocol::roleName(role)));
+
+    if (!session.isFull()) return;
+    if (!session.started) {
+        startSession(session);
+        return;
+    }
+
+    // Rejoining a running game: catch this client up
+    const DifficultySettings& settings = session.getSettings();
+    send(connection, Protocol::format("START", to_string(session.getTarget().getSize()) + " " +
+                                               to_string(settings.maxTurns) + " " + to_string(settings.messageLimit)));
+    if (role == Role::DISPATCHER) {
+        send(connection, Protocol::format("TARGET", session.getTarget().toCompressedString()));
+    }
+    send(connection, Protocol::format("GRID", to_string(session.getTurn()) + " " +
+                                              to_string(static_cast<int>(session.getAccuracy())) + " " +
+                                              session.getGrid().toCompressedString()));
+}
+
+void GameServer::handleSend(Connection& connection, GameSession& session, const string& text) {
+    Role role = roleOf(connection, session);
+    if (role == Role::DISPATCHER) {
+        if (session.getMessagesUsed() >= session.getSettings().messageLimit) {
+            send(connection, Protocol::format("ERROR", "message limit reached"));
+            return;
+        }
+        const MessageNoiseSimulator& noise = *noiseByLevel[static_cast<size_t>(session.getSettings().noiseLevel)];
+        sendTo(session.getConnection(Role::MESSENGER),
+               Protocol::format("MESSAGE", session.relayDispatcherMessage(text, noise)));
+    } else if (role == Role::MESSENGER) {
+        sendTo(session.getConnection(Role::BUILDER), Protocol::format("MESSAGE", text));
+    } else {
+        send(connection, Protocol::format("ERROR", "the builder only sends BUILD"));
+        return;
+    }
+    stats.messagesRouted++;
+}
+
+void GameServer::handleBuild(Connection& connection, GameSession& session, const string& instruction) {
+    if (roleOf(connection, session) != Role::BUILDER) {
+        send(connection, Protocol::format("ERROR", "only the builder can build"));
+        return;
+    }
+
+    session.build(instruction);
+    stats.turnsPlayed++;
+    broadcast(session, Protocol::format("GRID", to_string(session.getTurn()) + " " +
+                                                to_string(static_cast<int>(session.getAccuracy())) + " " +
+                                                session.getGrid().toCompressedString()));
+    if (session.isOver()) {
+        finishSession(session);
+    }
+}
+
+void GameServer::startSession(GameSession& session) {
+    session.started = true;
+    const DifficultySettings& settings = session.getSettings();
+    broadcast(session, Protocol::format("START", to_string(session.getTarget().getSize()) + " " +
+                                                 to_string(settings.maxTurns) + " " + to_string(settings.messageLimit)));
+    sendTo(session.getConnection(Role::DISPATCHER),
+           Protocol::format("TARGET", session.getTarget().toCompressedString()));
+}
+
+void GameServer::finishSession(GameSession& session) {
+    broadcast(session, Protocol::format("END", to_string(session.getScore()) + " " +
+                                               to_string(static_cast<int>(session.getAccuracy()))));
+
+    for (Role role : {Role::DISPATCHER, Role::MESSENGER, Role::BUILDER}) {
+        auto it = connections.find(session.getConnection(role));
+        if (it != connections.end()) it->second.session = 0;
+    }
+    stats.sessionsFinished++;
+    sessions.erase(session.getId()); // Invalidates `session`
+}
+
+GameSession* GameServer::sessionOf(const Connection& connection) {
+    if (connection.session == 0) return nullptr;
+    auto it = sessions.find(connection.session);
+    return it != sessions.end() ? it->second.get() : nullptr;
+}
+
+size_t GameServer::pruneCreated(Connection& connection) {
+    auto& created = connection.created;
+    created.erase(remove_if(created.begin(), created.end(), [this](uint32_t id) {
+        auto it = sessions.find(id);
+        return it == sessions.end() || !it->second->isEmpty();
+    }), created.end());
+    return created.size();
+}
+
+Role GameServer::roleOf(const Connection& connection, const GameSession& session) const {
+    for (Role role : {Role::DISPATCHER, Role::MESSENGER, Role::BUILDER}) {
+        if (session.getConnection(role) == connection.fd) return role;
+    }
+    return Role::BUILDER; // Unreachable for members
+}
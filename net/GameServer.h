@@ -0,0 +1,92 @@
+#pragma once
+#include "GameSession.h"
+#include "Protocol.h"
+#include "../game/PatternGenerator.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+
+struct ServerStats {
+    uint64_t connectionsAccepted = 0;
+    uint64_t sessionsCreated = 0;
+    uint64_t sessionsFinished = 0;
+    uint64_t turnsPlayed = 0;
+    uint64_t messagesRouted = 0;
+    size_t openConnections = 0;
+    size_t activeSessions = 0;
+};
+
+// Hosts many DispatchGame sessions over TCP and/or Unix domain sockets with
+// one epoll loop. Every session lives on this thread, so routing a message
+// between its three clients never takes a lock. Linux only.
+class GameServer {
+public:
+    explicit GameServer(uint64_t seed = 0);
+    ~GameServer();
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    bool listenTcp(const std::string& host, int port);
+    bool listenUnix(const std::string& path);
+
+    void run();                    // Until stop()
+    bool poll(int timeoutMs);      // One round of events; false on epoll failure
+    void stop() { stopping = true; } // Safe from a signal handler
+    bool isStopping() const { return stopping; }
+
+    const ServerStats& getStats() const { return stats; }
+
+private:
+    struct Connection {
+        int fd = -1;
+        LineBuffer input;
+        std::string output;
+        size_t outputSent = 0;
+        bool watchingWrites = false;
+        bool closing = false;
+        uint32_t session = 0; // 0 = not in a session
+        std::vector<uint32_t> created; // Sessions this client created; erased with it while nobody joined
+    };
+
+    static const int MAX_EVENTS;
+    static const size_t READ_CHUNK;
+    static const size_t MAX_UNJOINED_PER_CONNECTION;
+
+    int epollFd;
+    std::vector<int> listeners;
+    std::vector<std::string> unixPaths;
+    std::unordered_map<int, Connection> connections;
+    std::unordered_map<uint32_t, std::unique_ptr<GameSession>> sessions;
+    std::vector<int> pendingClose;
+    std::vector<std::unique_ptr<MessageNoiseSimulator>> noiseByLevel; // Indexed by NoiseLevel
+
+    PatternGenerator generator;
+    uint64_t seed;
+    uint32_t nextSessionId;
+    std::atomic<bool> stopping;
+    ServerStats stats;
+
+    bool addListener(int fd);
+    void acceptClients(int listener);
+    void readFrom(Connection& connection);
+    void flush(Connection& connection);
+    void send(Connection& connection, const std::string& line);
+    void sendTo(int fd, const std::string& line);
+    void broadcast(const GameSession& session, const std::string& line);
+    void requestClose(Connection& connection);
+    void closeConnection(int fd);
+
+    void handleLine(Connection& connection, const std::string& line);
+    void handleCreate(Connection& connection, const std::string& argument);
+    void handleJoin(Connection& connection, const std::string& argument);
+    void handleSend(Connection& connection, GameSession& session, const std::string& text);
+    void handleBuild(Connection& connection, GameSession& session, const std::string& instruction);
+    void startSession(GameSession& session);
+    void finishSession(GameSession& session);
+    GameSession* sessionOf(const Connection& connection);
+    size_t pruneCreated(Connection& connection); // Drops ended or joined sessions; returns those left
+    Role roleOf(const Connection& connection, const GameSession& session) const;
+};
@@ -0,0 +1,59 @@
+#include "GameSession.h"
+
+using namespace std;
+
+GameSession::GameSession(uint32_t id, Difficulty difficulty, const PatternGrid& target, uint64_t seed)
+    : started(false), id(id), difficulty(difficulty), settings(DispatchGame::getDifficultySettings(difficulty)),
+      target(target), builder(target.getSize()), stream(seed), turn(0), messagesUsed(0) {
+    members.fill(-1);
+}
+
+bool GameSession::join(Role role, int connection) {
+    int& slot = members[static_cast<size_t>(role)];
+    if (slot >= 0) return false;
+    slot = connection;
+    return true;
+}
+
+bool GameSession::leave(int connection, Role& role) {
+    for (size_t i = 0; i < members.size(); i++) {
+        if (members[i] == connection) {
+            members[i] = -1;
+            role = static_cast<Role>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GameSession::isFull() const {
+    for (int member : members) {
+        if (member < 0) return false;
+    }
+    return true;
+}
+
+bool GameSession::isEmpty() const {
+    for (int member : members) {
+        if (member >= 0) return false;
+    }
+    return true;
+}
+
+string GameSession::relayDispatcherMessage(const string& text, const MessageNoiseSimulator& noise) {
+    messagesUsed++;
+    return noise.applyNoise(text, stream);
+}
+
+bool GameSession::build(const string& instruction) {
+    turn++;
+    return builder.executeInstruction(instruction);
+}
+
+bool GameSession::isOver() const {
+    return turn >= settings.maxTurns || messagesUsed >= settings.messageLimit || target == builder.getCurrentGrid();
+}
+
+int GameSession::getScore() const {
+    return DispatchGame::computeScore(getAccuracy(), turn, messagesUsed, settings.maxTurns, settings.messageLimit);
+}
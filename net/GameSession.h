@@ -0,0 +1,52 @@
+#pragma once
+#include "../core/PatternGrid.h"
+#include "../core/MessageSystem.h"
+#include "../roles/Builder.h"
+#include "../game/DispatchGame.h"
+#include "../data/GameData.h"
+#include "../utils/Random.h"
+#include <array>
+#include <string>
+#include <cstdint>
+
+// One networked DispatchGame: the same rules and scoring, but each role is
+// a client connection and nothing touches the console. Owned by GameServer.
+class GameSession {
+public:
+    GameSession(uint32_t id, Difficulty difficulty, const PatternGrid& target, uint64_t seed);
+
+    bool join(Role role, int connection); // False if the role is taken
+    bool leave(int connection, Role& role);
+    int getConnection(Role role) const { return members[static_cast<size_t>(role)]; }
+    bool isFull() const;
+    bool isEmpty() const;
+
+    // Dispatcher -> Messenger: counts against the message limit and goes
+    // through the noisy channel with this session's own random stream
+    std::string relayDispatcherMessage(const std::string& text, const MessageNoiseSimulator& noise);
+    bool build(const std::string& instruction); // Plays one turn
+    bool isOver() const;
+
+    uint32_t getId() const { return id; }
+    Difficulty getDifficulty() const { return difficulty; }
+    const DifficultySettings& getSettings() const { return settings; }
+    const PatternGrid& getTarget() const { return target; }
+    const PatternGrid& getGrid() const { return builder.getCurrentGrid(); }
+    int getTurn() const { return turn; }
+    int getMessagesUsed() const { return messagesUsed; }
+    double getAccuracy() const { return target.calculateAccuracy(builder.getCurrentGrid()); }
+    int getScore() const;
+
+    bool started;
+
+private:
+    uint32_t id;
+    Difficulty difficulty;
+    DifficultySettings settings;
+    PatternGrid target;
+    Builder builder;
+    RandomStream stream;
+    std::array<int, 3> members; // Connection per Role, -1 when open
+    int turn;
+    int messagesUsed;
+};
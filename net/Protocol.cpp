@@ -0,0 +1,99 @@
+#include "Protocol.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+const size_t Protocol::MAX_LINE = 4096;
+
+namespace {
+
+string lowercase(string text) {
+    transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return tolower(c); });
+    return text;
+}
+
+}
+
+ProtocolMessage Protocol::parse(const string& line) {
+    ProtocolMessage message;
+    size_t space = line.find(' ');
+    message.verb = line.substr(0, space);
+    if (space != string::npos) {
+        size_t start = line.find_first_not_of(' ', space);
+        if (start != string::npos) message.argument = line.substr(start);
+    }
+    return message;
+}
+
+string Protocol::format(const string& verb, const string& argument) {
+    string line = verb;
+    if (!argument.empty()) {
+        line += ' ';
+        // Keep a relayed message on one line
+        for (char c : argument) {
+            line += (c == '\n' || c == '\r') ? ' ' : c;
+        }
+    }
+    line += '\n';
+    return line;
+}
+
+bool Protocol::parseRole(const string& text, Role& role) {
+    string name = lowercase(text);
+    if (name == "dispatcher") role = Role::DISPATCHER;
+    else if (name == "messenger") role = Role::MESSENGER;
+    else if (name == "builder") role = Role::BUILDER;
+    else return false;
+    return true;
+}
+
+const char* Protocol::roleName(Role role) {
+    switch (role) {
+        case Role::DISPATCHER: return "dispatcher";
+        case Role::MESSENGER: return "messenger";
+        case Role::BUILDER: return "builder";
+    }
+    return "unknown";
+}
+
+bool Protocol::parseDifficulty(const string& text, Difficulty& difficulty) {
+    string name = lowercase(text);
+    if (name == "training") difficulty = Difficulty::TRAINING;
+    else if (name == "normal" || name.empty()) difficulty = Difficulty::NORMAL;
+    else if (name == "hard") difficulty = Difficulty::HARD;
+    else if (name == "expert") difficulty = Difficulty::EXPERT;
+    else return false;
+    return true;
+}
+
+const char* Protocol::difficultyName(Difficulty difficulty) {
+    switch (difficulty) {
+        case Difficulty::TRAINING: return "training";
+        case Difficulty::NORMAL: return "normal";
+        case Difficulty::HARD: return "hard";
+        case Difficulty::EXPERT: return "expert";
+    }
+    return "normal";
+}
+
+bool LineBuffer::nextLine(string& line) {
+    size_t end = buffer.find('\n', consumed);
+    if (end == string::npos) {
+        // Compact once everything buffered has been consumed or half of it is stale
+        if (consumed == buffer.size()) {
+            buffer.clear();
+            consumed = 0;
+        } else if (consumed > buffer.size() / 2) {
+            buffer.erase(0, consumed);
+            consumed = 0;
+        }
+        return false;
+    }
+
+    size_t length = end - consumed;
+    if (length > 0 && buffer[end - 1] == '\r') length--;
+    line.assign(buffer, consumed, length);
+    consumed = end + 1;
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "../data/GameData.h"
+#include <string>
+#include <cstddef>
+
+// Line-oriented text protocol between the server and role clients: one
+// command per '\n'-terminated line, a verb followed by its argument.
+//
+// Client -> server:
+//   CREATE <difficulty>          -> CREATED <session>; a session nobody has
+//                                joined ends when its creator disconnects
+//   JOIN <session> <role>        -> JOINED <session> <role>
+//   SEND <text>                  Dispatcher -> Messenger (noisy), Messenger -> Builder
+//   BUILD <instruction>          Builder only; plays one turn
+//   QUIT
+// Server -> client:
+//   START <size> <maxTurns> <messageLimit>   once all three roles joined
+//   TARGET <cells>               Dispatcher only, row-major
+//   MESSAGE <text>               Relayed from the previous role
+//   GRID <turn> <accuracy> <cells>           To everyone after each turn
+//   END <score> <accuracy>       Session over
+//   LEFT <role> | ERROR <reason>
+struct ProtocolMessage {
+    std::string verb;
+    std::string argument; // Rest of the line, leading spaces trimmed
+};
+
+class Protocol {
+public:
+    static const size_t MAX_LINE; // Longer lines close the connection
+
+    static ProtocolMessage parse(const std::string& line);
+    static std::string format(const std::string& verb, const std::string& argument = "");
+
+    static bool parseRole(const std::string& text, Role& role);
+    static const char* roleName(Role role);
+    static bool parseDifficulty(const std::string& text, Difficulty& difficulty);
+    static const char* difficultyName(Difficulty difficulty);
+};
+
+// Splits a byte stream into lines; handles partial reads
+class LineBuffer {
+public:
+    LineBuffer() : consumed(0) {}
+
+    void append(const char* data, size_t size) { buffer.append(data, size); }
+    bool nextLine(std::string& line);  // Strips the '\n' (and a '\r' before it)
+    bool overflowed() const { return buffer.size() - consumed > Protocol::MAX_LINE; }
+
+private:
+    std::string buffer;
+    size_t consumed;
+};
@@ -0,0 +1,129 @@
+#include "Socket.h"
+#include <cstring>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+namespace {
+
+bool fillTcpAddress(const string& host, int port, sockaddr_in& address) {
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    return inet_pton(AF_INET, host.c_str(), &address.sin_addr) == 1;
+}
+
+bool fillUnixAddress(const string& path, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Turns are one short line each way; don't let Nagle hold them back
+void disableNagle(int fd) {
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+}
+
+int Socket::listenTcp(const string& host, int port, int backlog) {
+    sockaddr_in address;
+    if (!fillTcpAddress(host, port, address)) return -1;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, backlog) != 0) {
+        closeQuietly(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int Socket::listenUnix(const string& path, int backlog) {
+    sockaddr_un address;
+    if (!fillUnixAddress(path, address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    unlink(path.c_str()); // Stale socket from a previous run
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, backlog) != 0) {
+        closeQuietly(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int Socket::connectTcp(const string& host, int port) {
+    sockaddr_in address;
+    if (!fillTcpAddress(host, port, address)) return -1;
+
+    // Connect blocking so callers get a ready socket, then switch modes
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || !setNonBlocking(fd)) {
+        closeQuietly(fd);
+        return -1;
+    }
+    disableNagle(fd);
+    return fd;
+}
+
+int Socket::connectUnix(const string& path) {
+    sockaddr_un address;
+    if (!fillUnixAddress(path, address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || !setNonBlocking(fd)) {
+        closeQuietly(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int Socket::acceptClient(int listener) {
+    int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return -1;
+
+    sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0 && address.ss_family == AF_INET) {
+        disableNagle(fd);
+    }
+    return fd;
+}
+
+bool Socket::setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void Socket::closeQuietly(int fd) {
+    if (fd >= 0) ::close(fd);
+}
+
+int Socket::raiseDescriptorLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return -1;
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return limit.rlim_cur > static_cast<rlim_t>(INT_MAX) ? INT_MAX : static_cast<int>(limit.rlim_cur);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+// Thin POSIX socket helpers for the server and load generator. All
+// returned descriptors are non-blocking; -1 on failure.
+class Socket {
+public:
+    static int listenTcp(const std::string& host, int port, int backlog = 1024);
+    static int listenUnix(const std::string& path, int backlog = 1024);
+    static int connectTcp(const std::string& host, int port);
+    static int connectUnix(const std::string& path);
+    static int acceptClient(int listener);
+
+    static bool setNonBlocking(int fd);
+    static void closeQuietly(int fd);
+
+    // Thousands of sessions need more descriptors than the usual soft limit
+    static int raiseDescriptorLimit();
+};
@@ -0,0 +1,335 @@
+#include "BeamDecoder.h"
+#include "../utils/Utilities.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+    // Messenger::paraphraseMessage always applies these, so undoing them is cheap
+    const pair<const char*, const char*> PARAPHRASES[] = {
+        {"LINE", "ROW"}, {"VERTICAL", "COLUMN"}, {"LAYOUT", "GRID"}, {"ARRANGEMENT", "PATTERN"}
+    };
+    const double PARAPHRASE_LOG_PROB = log(0.9);
+    
+    // Spelled-out coordinates; larger grids go on to "TWENTY-ONE" and so on
+    string spellNumber(int number) {
+        static const char* const SMALL[] = {"ZERO", "ONE", "TWO", "THREE", "FOUR", "FIVE", "SIX", "SEVEN",
+                                            "EIGHT", "NINE", "TEN", "ELEVEN", "TWELVE", "THIRTEEN", "FOURTEEN",
+                                            "FIFTEEN", "SIXTEEN", "SEVENTEEN", "EIGHTEEN", "NINETEEN"};
+        static const char* const TENS[] = {"", "", "TWENTY", "THIRTY", "FORTY", "FIFTY",
+                                           "SIXTY", "SEVENTY", "EIGHTY", "NINETY"};
+        if (number < 20) return SMALL[number];
+        if (number >= 100) return to_string(number);
+        string word = TENS[number / 10];
+        if (number % 10 != 0) word.append("-").append(SMALL[number % 10]);
+        return word;
+    }
+    
+    // Dispatchers write commands; a restored word outside the command
+    // vocabulary (like "HEY" as a cell value) is an unlikely original
+    const char* COMMAND_WORDS[] = {"SET", "PUT", "FILL", "ROW", "COLUMN", "COL", "WITH",
+                                   "REPLACE", "ALL", "CLEAR", "GRID"};
+    const double OUT_OF_VOCABULARY_LOG_PENALTY = log(0.1);
+    
+    bool isCommandVocabulary(const string& upperWord) {
+        if (upperWord.length() <= 1) return true;
+        if (find(begin(COMMAND_WORDS), end(COMMAND_WORDS), upperWord) != end(COMMAND_WORDS)) return true;
+        // Coordinates and SET(r,c)=v forms are digits and punctuation around keywords
+        return upperWord.find_first_of("0123456789(),=") != string::npos;
+    }
+    
+    // A message may simply not contain a usable command
+    const double NO_COMMAND_PROB = 0.05;
+    const double NO_COMMAND_LOG_PROB = log(NO_COMMAND_PROB);
+    // Instructions that change nothing are rarely what the Dispatcher meant
+    const double NO_OP_LOG_PENALTY = log(0.3);
+    // Per changed cell: writing what the Builder already has there is the
+    // likelier reading; overwriting a built symbol with another, less so
+    const double AGREES_WITH_BUILT_LOG_BONUS = log(2.0);
+    const double OVERWRITES_BUILT_LOG_PENALTY = log(0.5);
+    
+    void applyCommand(PatternGrid& grid, const ParsedCommand& command) {
+        switch (command.type) {
+            case ParsedCommand::Type::SET_CELL:
+                grid.setCell(command.row, command.col, command.value);
+                break;
+            case ParsedCommand::Type::FILL_ROW:
+                grid.fillRow(command.row, command.value);
+                break;
+            case ParsedCommand::Type::FILL_COLUMN:
+                grid.fillColumn(command.col, command.value);
+                break;
+            case ParsedCommand::Type::REPLACE_ALL:
+                grid.replaceAll(command.oldValue, command.value);
+                break;
+            case ParsedCommand::Type::CLEAR_GRID:
+                grid.clear();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+BeamDecoder::BeamDecoder(int gridSize, shared_ptr<MessageNoiseSimulator> noiseModel,
+                         int beamWidth, int interpretationsPerMessage)
+    : size(gridSize), beamWidth(max(1, beamWidth)),
+      interpretationsPerMessage(max(1, interpretationsPerMessage)), noiseModel(noiseModel), decodedMessages(0) {
+    for (int number = 1; number <= size; number++) numberWords.push_back(spellNumber(number));
+    reset();
+}
+
+void BeamDecoder::setBeamWidth(int width) {
+    beamWidth = max(1, width);
+    if (static_cast<int>(beam.size()) > beamWidth) beam.resize(beamWidth);
+}
+
+void BeamDecoder::setInterpretationsPerMessage(int count) {
+    interpretationsPerMessage = max(1, count);
+}
+
+void BeamDecoder::reset() {
+    reset(PatternGrid(size));
+}
+
+void BeamDecoder::reset(const PatternGrid& start) {
+    beam.clear();
+    beam.push_back({make_shared<const PatternGrid>(start), nullptr, 0.0});
+    decodedMessages = 0;
+}
+
+int BeamDecoder::recover(Builder& builder, const string& message, const InferenceBuilder* beliefs) {
+    decode(message, &builder.getCurrentGrid(), beliefs);
+    
+    const auto& reading = beam.front().history;
+    if (!reading || reading->message != decodedMessages) return 0;
+    
+    PatternGrid before = builder.getCurrentGrid();
+    ParsedCommand command = reading->command;
+    command.rawCommand = "DECODED";
+    if (!builder.executeParsedCommand(command)) return 0;
+    
+    int changed = 0;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (before.getCell(row, col) != builder.getCurrentGrid().getCell(row, col)) changed++;
+        }
+    }
+    return changed;
+}
+
+vector<Interpretation> BeamDecoder::interpret(const string& message) const {
+    // Restore the message word by word, keeping only the most probable
+    // partial restorations so the search stays linear in message length
+    size_t partialLimit = static_cast<size_t>(interpretationsPerMessage) * 4;
+    vector<pair<string, double>> partials = {{"", 0.0}};
+    
+    istringstream words(message);
+    string word;
+    while (words >> word) {
+        vector<WordOption> options = restoreWord(word);
+        vector<pair<string, double>> extended;
+        extended.reserve(partials.size() * options.size());
+        
+        for (const auto& [text, logProb] : partials) {
+            for (const auto& option : options) {
+                extended.push_back({text.empty() ? option.text : text + " " + option.text,
+                                    logProb + option.logProb});
+            }
+        }
+        
+        size_t keep = min(partialLimit, extended.size());
+        partial_sort(extended.begin(), extended.begin() + keep, extended.end(),
+                     [](const pair<string, double>& a, const pair<string, double>& b) { return a.second > b.second; });
+        extended.resize(keep);
+        partials.swap(extended);
+    }
+    
+    PatternGrid bounds(size);
+    vector<Interpretation> interpretations;
+    for (const auto& [text, logProb] : partials) {
+        ParsedCommand command = CommandParser::parse(text);
+        if (command.type == ParsedCommand::Type::INVALID || !CommandParser::validateCommand(command, bounds)) {
+            continue;
+        }
+        
+        auto existing = find_if(interpretations.begin(), interpretations.end(),
+                                [&](const Interpretation& i) { return sameCommand(i.command, command); });
+        if (existing == interpretations.end()) {
+            interpretations.push_back({command, logProb, text});
+        } else if (logProb > existing->logPrior) {
+            existing->logPrior = logProb;
+            existing->restoredText = text;
+        }
+    }
+    
+    sort(interpretations.begin(), interpretations.end(),
+         [](const Interpretation& a, const Interpretation& b) { return a.logPrior > b.logPrior; });
+    if (static_cast<int>(interpretations.size()) > interpretationsPerMessage) {
+        interpretations.resize(interpretationsPerMessage);
+    }
+    return interpretations;
+}
+
+void BeamDecoder::decode(const string& message, const PatternGrid* built, const InferenceBuilder* beliefs) {
+    decodedMessages++;
+    vector<Interpretation> interpretations = interpret(message);
+    double noCommandLogProb = interpretations.empty() ? 0.0 : NO_COMMAND_LOG_PROB;
+    
+    // Priors only matter relative to each other: normalize them over the
+    // candidates so message length doesn't bias against acting at all
+    if (!interpretations.empty()) {
+        double maxPrior = interpretations.front().logPrior;
+        double total = 0.0;
+        for (const auto& interpretation : interpretations) total += exp(interpretation.logPrior - maxPrior);
+        double logNormalizer = maxPrior + log(total) - log1p(-NO_COMMAND_PROB);
+        for (auto& interpretation : interpretations) interpretation.logPrior -= logNormalizer;
+    }
+    
+    vector<Hypothesis> candidates;
+    candidates.reserve(beam.size() * (interpretations.size() + 1));
+    
+    for (const auto& hypothesis : beam) {
+        candidates.push_back({hypothesis.grid, hypothesis.history, hypothesis.score + noCommandLogProb});
+        
+        for (const auto& interpretation : interpretations) {
+            shared_ptr<const PatternGrid> grid;
+            double fit = scoreAgainst(interpretation.command, *hypothesis.grid, built, beliefs, grid);
+            if (!grid) grid = hypothesis.grid; // No-op: share the parent's grid
+            auto node = make_shared<const CommandNode>(
+                CommandNode{interpretation.command, hypothesis.history, decodedMessages});
+            candidates.push_back({grid, node, hypothesis.score + interpretation.logPrior + fit});
+        }
+    }
+    
+    sort(candidates.begin(), candidates.end(),
+         [](const Hypothesis& a, const Hypothesis& b) { return a.score > b.score; });
+    
+    // Hypotheses that reach the same grid are interchangeable; keep the best
+    vector<Hypothesis> next;
+    for (auto& candidate : candidates) {
+        if (static_cast<int>(next.size()) >= beamWidth) break;
+        bool duplicate = any_of(next.begin(), next.end(), [&](const Hypothesis& h) {
+            return h.grid == candidate.grid || *h.grid == *candidate.grid;
+        });
+        if (!duplicate) next.push_back(move(candidate));
+    }
+    beam.swap(next);
+}
+
+double BeamDecoder::scoreAgainst(const ParsedCommand& command, const PatternGrid& grid, const PatternGrid* built,
+                                 const InferenceBuilder* beliefs, shared_ptr<const PatternGrid>& result) const {
+    PatternGrid updated(grid);
+    applyCommand(updated, command);
+    
+    if (updated == grid) {
+        return NO_OP_LOG_PENALTY; // result stays null; the caller shares the parent's grid
+    }
+    
+    // Averaged over the changed cells, so a FILL isn't favoured over a SET
+    // just for touching more of them
+    double fit = 0.0;
+    int changed = 0;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            char before = grid.getCell(row, col);
+            char after = updated.getCell(row, col);
+            if (before == after) continue;
+            changed++;
+            
+            if (built) {
+                char have = built->getCell(row, col);
+                if (have == after) fit += AGREES_WITH_BUILT_LOG_BONUS;
+                else if (have != '_') fit += OVERWRITES_BUILT_LOG_PENALTY;
+            }
+            if (beliefs) {
+                // How much more the beliefs favour the new value than the old
+                fit += beliefs->getLogProbability(row, col, after) - beliefs->getLogProbability(row, col, before);
+            }
+        }
+    }
+    
+    result = make_shared<const PatternGrid>(move(updated));
+    return fit / changed;
+}
+
+vector<BeamDecoder::WordOption> BeamDecoder::restoreWord(const string& word) const {
+    double forget = noiseModel ? noiseModel->getForgetProbability() : 0.0;
+    double misinterpret = noiseModel ? noiseModel->getMisinterpretProbability() : 0.0;
+    double typo = noiseModel ? noiseModel->getTypoProbability() : 0.0;
+    double survived = max(1e-6, 1.0 - forget);
+    double pKeep = max(1e-6, (1.0 - forget - misinterpret - typo) / survived);
+    double pMisinterpret = max(1e-6, misinterpret / survived);
+    
+    string upper = Utilities::toUpper(word);
+    double keepLogProb = log(pKeep) + (isCommandVocabulary(upper) ? 0.0 : OUT_OF_VOCABULARY_LOG_PENALTY);
+    vector<WordOption> options = {{word, keepLogProb}};
+    
+    for (const auto& [from, to] : PARAPHRASES) {
+        if (upper == from) options.push_back({to, PARAPHRASE_LOG_PROB});
+    }
+    
+    for (int i = 0; i < size; i++) {
+        if (upper == numberWords[i]) options.push_back({to_string(i + 1), log(pMisinterpret)});
+    }
+    
+    if (noiseModel) {
+        for (const auto& [original, variants] : noiseModel->getMisinterpretations()) {
+            int matches = 0;
+            for (const auto& variant : variants) {
+                if (Utilities::toUpper(variant) == upper) matches++;
+            }
+            if (matches > 0) {
+                options.push_back({original, log(pMisinterpret * matches / variants.size())});
+            }
+        }
+    }
+    
+    return options;
+}
+
+const PatternGrid& BeamDecoder::getBestGrid() const {
+    return *beam.front().grid;
+}
+
+vector<ParsedCommand> BeamDecoder::getBestCommands() const {
+    vector<ParsedCommand> commands;
+    for (auto node = beam.front().history; node; node = node->parent) {
+        commands.push_back(node->command);
+    }
+    reverse(commands.begin(), commands.end());
+    return commands;
+}
+
+double BeamDecoder::getBestScore() const {
+    return beam.front().score;
+}
+
+int BeamDecoder::commitTo(Builder& builder) const {
+    const PatternGrid& best = getBestGrid();
+    const PatternGrid& current = builder.getCurrentGrid();
+    int changed = 0;
+    
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (current.getCell(row, col) == best.getCell(row, col)) continue;
+            
+            ParsedCommand cmd;
+            cmd.type = ParsedCommand::Type::SET_CELL;
+            cmd.row = row;
+            cmd.col = col;
+            cmd.value = best.getCell(row, col);
+            cmd.rawCommand = "DECODED";
+            if (builder.executeParsedCommand(cmd)) changed++;
+        }
+    }
+    
+    return changed;
+}
+
+bool BeamDecoder::sameCommand(const ParsedCommand& a, const ParsedCommand& b) {
+    return a.type == b.type && a.row == b.row && a.col == b.col &&
+           a.value == b.value && a.oldValue == b.oldValue;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "../core/PatternGrid.h"
+#include "../core/CommandParser.h"
+#include "../core/MessageSystem.h"
+#include "Builder.h"
+#include "InferenceBuilder.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+struct Interpretation {
+    ParsedCommand command;
+    double logPrior;   // How likely the channel turned this command into the message
+    std::string restoredText;
+};
+
+// Decodes garbled Messenger output by enumerating the most likely commands
+// each message could have started as, scoring them against every hypothesis
+// grid, the cells already built and (optionally) an InferenceBuilder's
+// beliefs, and keeping the best beamWidth hypotheses across turns. Hypothesis
+// grids are shared copy-on-write, so an interpretation that doesn't change a
+// grid costs nothing.
+class BeamDecoder {
+public:
+    BeamDecoder(int gridSize, std::shared_ptr<MessageNoiseSimulator> noiseModel,
+                int beamWidth = 4, int interpretationsPerMessage = 8);
+    
+    // Latency/accuracy tradeoff: cost per message is beamWidth * interpretations
+    void setBeamWidth(int width);
+    int getBeamWidth() const { return beamWidth; }
+    void setInterpretationsPerMessage(int count);
+    int getInterpretationsPerMessage() const { return interpretationsPerMessage; }
+    
+    std::vector<Interpretation> interpret(const std::string& message) const;
+    // built is the grid the Builder actually has after this message
+    void decode(const std::string& message, const PatternGrid* built = nullptr,
+                const InferenceBuilder* beliefs = nullptr);
+    void reset();
+    void reset(const PatternGrid& start); // Hypotheses start from this grid instead of an empty one
+    
+    // For a message Builder could not parse: decodes it into the beam, which
+    // keeps its hypotheses from earlier messages, and executes the best
+    // hypothesis's reading of it. Returns cells changed (0 when the best
+    // reading is that the message held no command).
+    int recover(Builder& builder, const std::string& message, const InferenceBuilder* beliefs = nullptr);
+    
+    const PatternGrid& getBestGrid() const;
+    std::vector<ParsedCommand> getBestCommands() const;
+    double getBestScore() const;
+    size_t getHypothesisCount() const { return beam.size(); }
+    
+    // Writes the best hypothesis grid into a Builder; returns cells changed
+    int commitTo(Builder& builder) const;
+
+private:
+    struct CommandNode {
+        ParsedCommand command;
+        std::shared_ptr<const CommandNode> parent;
+        int message; // Which decoded message it was read from
+    };
+    
+    struct Hypothesis {
+        std::shared_ptr<const PatternGrid> grid;
+        std::shared_ptr<const CommandNode> history; // Newest command first
+        double score;
+    };
+    
+    struct WordOption {
+        std::string text;
+        double logProb;
+    };
+    
+    int size;
+    int beamWidth;
+    int interpretationsPerMessage;
+    std::shared_ptr<MessageNoiseSimulator> noiseModel;
+    std::vector<Hypothesis> beam;
+    std::vector<std::string> numberWords; // numberWords[i] spells i + 1, for every coordinate
+    int decodedMessages;
+    
+    std::vector<WordOption> restoreWord(const std::string& word) const;
+    double scoreAgainst(const ParsedCommand& command, const PatternGrid& grid, const PatternGrid* built,
+                        const InferenceBuilder* beliefs, std::shared_ptr<const PatternGrid>& result) const;
+    
+    static bool sameCommand(const ParsedCommand& a, const ParsedCommand& b);
+};
@@ -1,26 +1,58 @@
 #include "Builder.h"
 #include "../utils/Utilities.h"
-#include <sstream>
+#include "../utils/Trace.h"
+#include <algorithm>
 
 using namespace std;
 
-Builder::Builder(int gridSize) : currentGrid(gridSize) {}
+namespace {
+    bool startsWithIgnoreCase(string_view text, string_view prefix) {
+        if (text.size() < prefix.size()) return false;
+        for (size_t i = 0; i < prefix.size(); i++) {
+            if (toupper(static_cast<unsigned char>(text[i])) != prefix[i]) return false;
+        }
+        return true;
+    }
+    
+    // What undo replays; the text stays behind, since copying it would
+    // allocate for every command
+    ParsedCommand replayable(const ParsedCommand& command) {
+        ParsedCommand entry;
+        entry.type = command.type;
+        entry.row = command.row;
+        entry.col = command.col;
+        entry.value = command.value;
+        entry.oldValue = command.oldValue;
+        return entry;
+    }
+}
+
+Builder::Builder(int gridSize) : currentGrid(gridSize), loggingActions(true) {}
 
 bool Builder::executeInstruction(const string& instruction) {
-    receivedInstructions.push_back(instruction);
+    string_view header = Utilities::trimView(instruction);
+    if (startsWithIgnoreCase(header, "QUADTREE")) {
+        return executeQuadtreeDescription(instruction);
+    }
+    if (startsWithIgnoreCase(header, "RECTANGLES")) {
+        return executeRectangleDescription(instruction);
+    }
+    
+    receivedInstructions.append(instruction);
     lastError.clear();
     
-    ParsedCommand command = CommandParser::parse(instruction);
+    CommandParser::parseInto(instruction, parsed);
+    const ParsedCommand& command = parsed;
     
     if (command.type == ParsedCommand::Type::INVALID) {
-        lastError = "Invalid command format: " + instruction;
-        logAction("ERROR: " + lastError);
+        lastError.assign("Invalid command format: ").append(instruction); // Reuses the buffer
+        logError();
         return false;
     }
     
     if (!CommandParser::validateCommand(command, currentGrid)) {
         lastError = "Invalid coordinates or parameters";
-        logAction("ERROR: " + lastError);
+        logError();
         return false;
     }
     
@@ -28,34 +60,28 @@ bool Builder::executeInstruction(const string& instruction) {
 }
 
 bool Builder::executeParsedCommand(const ParsedCommand& command) {
-    commandHistory.push_back(command);
+    TRACE_SCOPE("Builder::executeParsedCommand");
+    commandHistory.push_back(replayable(command));
     
     switch(command.type) {
         case ParsedCommand::Type::SET_CELL:
             currentGrid.setCell(command.row, command.col, command.value);
-            logAction("SET(" + to_string(command.row + 1) + "," + 
-                     to_string(command.col + 1) + ") = " + command.value);
             break;
             
         case ParsedCommand::Type::FILL_ROW:
             currentGrid.fillRow(command.row, command.value);
-            logAction("FILL ROW " + to_string(command.row + 1) + " WITH " + command.value);
             break;
             
         case ParsedCommand::Type::FILL_COLUMN:
             currentGrid.fillColumn(command.col, command.value);
-            logAction("FILL COLUMN " + to_string(command.col + 1) + " WITH " + command.value);
             break;
             
         case ParsedCommand::Type::REPLACE_ALL:
             currentGrid.replaceAll(command.oldValue, command.value);
-            logAction("REPLACE ALL " + string(1, command.oldValue) + 
-                     " WITH " + command.value);
             break;
             
         case ParsedCommand::Type::CLEAR_GRID:
             currentGrid.clear();
-            logAction("CLEAR GRID");
             break;
             
         default:
@@ -63,6 +89,110 @@ bool Builder::executeParsedCommand(const ParsedCommand& command) {
             return false;
     }
     
+    logCommand(command);
+    return true;
+}
+
+bool Builder::executeQuadtreeDescription(const string& description) {
+    receivedInstructions.append(description);
+    lastError.clear();
+    
+    size_t pos = 0;
+    if (!parseEncodingHeader(description, "QUADTREE", pos)) {
+        logError();
+        return false;
+    }
+    
+    int size = currentGrid.getSize();
+    PatternGrid decoded(size);
+    if (!decodeQuadtreeRegion(description, pos, decoded, 0, 0, size, size) ||
+        !Utilities::trim(description.substr(pos)).empty()) {
+        lastError = "Malformed quadtree description";
+        logError();
+        return false;
+    }
+    
+    applyDecodedGrid(decoded, "QUADTREE");
+    return true;
+}
+
+bool Builder::executeRectangleDescription(const string& description) {
+    receivedInstructions.append(description);
+    lastError.clear();
+    
+    size_t pos = 0;
+    if (!parseEncodingHeader(description, "RECTANGLES", pos)) {
+        logError();
+        return false;
+    }
+    
+    int size = currentGrid.getSize();
+    PatternGrid decoded(size);
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> entries(scratch.resource());
+    Utilities::splitInto(string_view(description).substr(pos), ';', entries);
+    ScratchVector<string_view> fields(scratch.resource());
+    bool sawBase = false;
+    
+    for (string_view rawEntry : entries) {
+        string_view entry = Utilities::trimView(rawEntry);
+        if (entry.empty()) continue;
+        
+        // symbol, coords, dims
+        fields.clear();
+        Utilities::splitWordsInto(entry, fields);
+        fields.resize(3);
+        string_view symbol = fields[0];
+        string_view coords = fields[1];
+        string_view dims = fields[2];
+        
+        if (!sawBase) {
+            if (!startsWithIgnoreCase(symbol, "BASE") || symbol.size() != 4 || coords.empty()) break;
+            for (int row = 0; row < size; row++) {
+                decoded.fillRow(row, static_cast<char>(toupper(static_cast<unsigned char>(coords[0]))));
+            }
+            sawBase = true;
+            continue;
+        }
+        
+        size_t comma = coords.find(',');
+        size_t cross = dims.find_first_of("xX");
+        int row, col, height, width;
+        if (symbol.length() != 1 || comma == string_view::npos || cross == string_view::npos ||
+            !Utilities::parseInt(coords.substr(0, comma), row) ||
+            !Utilities::parseInt(coords.substr(comma + 1), col) ||
+            !Utilities::parseInt(dims.substr(0, cross), height) ||
+            !Utilities::parseInt(dims.substr(cross + 1), width)) {
+            lastError = "Malformed rectangle: " + string(entry);
+            logError();
+            return false;
+        }
+        row -= 1;
+        col -= 1;
+        
+        if (row < 0 || col < 0 || height < 1 || width < 1 ||
+            row + height > size || col + width > size) {
+            lastError = "Rectangle out of bounds: " + string(entry);
+            logError();
+            return false;
+        }
+        
+        // Symbols are case-insensitive, as in the quadtree decoder
+        char value = static_cast<char>(toupper(static_cast<unsigned char>(symbol[0])));
+        for (int r = row; r < row + height; r++) {
+            for (int c = col; c < col + width; c++) {
+                decoded.setCell(r, c, value);
+            }
+        }
+    }
+    
+    if (!sawBase) {
+        lastError = "Rectangle description is missing its base symbol";
+        logError();
+        return false;
+    }
+    
+    applyDecodedGrid(decoded, "RECTANGLES");
     return true;
 }
 
@@ -70,10 +200,27 @@ void Builder::reset() {
     currentGrid.clear();
     receivedInstructions.clear();
     actionLog.clear();
+    loggedErrors.clear();
     commandHistory.clear();
     lastError.clear();
 }
 
+void Builder::reserveHistory(int instructions, size_t instructionBytes) {
+    size_t count = static_cast<size_t>(max(instructions, 0));
+    receivedInstructions.reserve(count, count * instructionBytes);
+    commandHistory.reserve(count);
+    actionLog.reserve(count);
+    loggedErrors.reserve(count, count * (instructionBytes + 32)); // Room for the message's prefix
+    parsed.rawCommand.reserve(instructionBytes);
+    lastError.reserve(instructionBytes + 32);
+}
+
+void Builder::restoreGrid(const PatternGrid& grid) {
+    currentGrid = grid;
+    commandHistory.clear();
+    logAction(ActionRecord::Kind::RESTORE);
+}
+
 void Builder::undoLastCommand() {
     if (commandHistory.empty()) {
         lastError = "No commands to undo";
@@ -90,7 +237,7 @@ void Builder::undoLastCommand() {
         executeParsedCommand(cmd);
     }
     
-    logAction("UNDO last command");
+    logAction(ActionRecord::Kind::UNDO);
 }
 
 string Builder::getGridDisplay() const {
@@ -98,20 +245,22 @@ string Builder::getGridDisplay() const {
 }
 
 string Builder::getGridStateDescription() const {
-    stringstream ss;
     int size = currentGrid.getSize();
+    string description = "Current grid state: ";
+    description.reserve(description.size() + size * (2 * size + 12));
     
-    ss << "Current grid state: ";
     for (int row = 0; row < size; row++) {
-        ss << "Row " << (row + 1) << ": ";
+        description += "Row ";
+        description += to_string(row + 1);
+        description += ": ";
         for (int col = 0; col < size; col++) {
-            ss << currentGrid.getCell(row, col);
-            if (col < size - 1) ss << " ";
+            description += currentGrid.getCell(row, col);
+            if (col < size - 1) description += ' ';
         }
-        if (row < size - 1) ss << " | ";
+        if (row < size - 1) description += " | ";
     }
     
-    return ss.str();
+    return description;
 }
 
 bool Builder::detectProbableErrors(const PatternGrid& targetHint) {
@@ -168,24 +317,187 @@ vector<string> Builder::getSuggestedCorrections() const {
     return suggestions;
 }
 
-void Builder::logAction(const string& action) {
-    actionLog.push_back(action);
+vector<string> Builder::getActionLog() const {
+    vector<string> log;
+    log.reserve(actionLog.size());
+    for (const auto& record : actionLog) {
+        log.push_back(formatAction(record, loggedErrors));
+    }
+    return log;
+}
+
+void Builder::logAction(ActionRecord::Kind kind) {
+    if (!loggingActions) return;
+    ActionRecord record{};
+    record.kind = kind;
+    actionLog.push_back(record);
+}
+
+void Builder::logCommand(const ParsedCommand& command) {
+    if (!loggingActions) return;
+    ActionRecord record{};
+    record.kind = ActionRecord::Kind::COMMAND;
+    record.command = command.type;
+    record.row = command.row;
+    record.col = command.col;
+    record.value = command.value;
+    record.oldValue = command.oldValue;
+    actionLog.push_back(record);
+}
+
+void Builder::logDecode(const char* label, int changed) {
+    if (!loggingActions) return;
+    ActionRecord record{};
+    record.kind = ActionRecord::Kind::DECODE;
+    record.row = changed;
+    record.label = label;
+    actionLog.push_back(record);
+}
+
+void Builder::logError() {
+    if (!loggingActions) return;
+    ActionRecord record{};
+    record.kind = ActionRecord::Kind::ERROR;
+    record.row = static_cast<int>(loggedErrors.size());
+    loggedErrors.append(lastError);
+    actionLog.push_back(record);
+}
+
+string Builder::formatAction(const ActionRecord& record, const MessageLog& errors) {
+    switch (record.kind) {
+        case ActionRecord::Kind::COMMAND:
+            switch (record.command) {
+                case ParsedCommand::Type::SET_CELL:
+                    return "SET(" + to_string(record.row + 1) + "," + to_string(record.col + 1) + ") = " + record.value;
+                case ParsedCommand::Type::FILL_ROW:
+                    return "FILL ROW " + to_string(record.row + 1) + " WITH " + record.value;
+                case ParsedCommand::Type::FILL_COLUMN:
+                    return "FILL COLUMN " + to_string(record.col + 1) + " WITH " + record.value;
+                case ParsedCommand::Type::REPLACE_ALL:
+                    return "REPLACE ALL " + string(1, record.oldValue) + " WITH " + record.value;
+                case ParsedCommand::Type::CLEAR_GRID:
+                    return "CLEAR GRID";
+                default:
+                    return "UNKNOWN COMMAND";
+            }
+        case ActionRecord::Kind::DECODE:
+            return string("DECODE ") + record.label + " (" + to_string(record.row) + " cells changed)";
+        case ActionRecord::Kind::RESTORE:
+            return "RESTORE GRID";
+        case ActionRecord::Kind::UNDO:
+            return "UNDO last command";
+        case ActionRecord::Kind::ERROR:
+        default:
+            return string("ERROR: ").append(errors[record.row]);
+    }
+}
+
+bool Builder::parseEncodingHeader(const string& description, const string& keyword, size_t& bodyStart) {
+    // Header: "<Keyword> NxN:" - the encoded size must match our grid
+    string upper = Utilities::toUpper(description);
+    size_t keywordPos = upper.find(keyword);
+    size_t colonPos = upper.find(':');
+    if (keywordPos == string::npos || colonPos == string::npos || colonPos < keywordPos) {
+        lastError = "Missing " + keyword + " header";
+        return false;
+    }
+    
+    string sizeStr = Utilities::trim(upper.substr(keywordPos + keyword.length(),
+                                                  colonPos - keywordPos - keyword.length()));
+    size_t cross = sizeStr.find('X');
+    try {
+        int rows = stoi(sizeStr.substr(0, cross));
+        int cols = cross == string::npos ? rows : stoi(sizeStr.substr(cross + 1));
+        if (rows != currentGrid.getSize() || cols != currentGrid.getSize()) {
+            lastError = "Encoded grid size does not match builder grid";
+            return false;
+        }
+    } catch (const exception&) {
+        lastError = "Invalid grid size in " + keyword + " header";
+        return false;
+    }
+    
+    bodyStart = colonPos + 1;
+    while (bodyStart < description.length() && isspace(static_cast<unsigned char>(description[bodyStart]))) {
+        bodyStart++;
+    }
+    return true;
+}
+
+bool Builder::decodeQuadtreeRegion(const string& data, size_t& pos, PatternGrid& grid,
+                                   int row, int col, int height, int width) const {
+    // Mirrors Dispatcher::encodeQuadtreeRegion
+    if (pos >= data.length()) return false;
+    
+    char token = data[pos++];
+    if (token != '*') {
+        char value = static_cast<char>(toupper(static_cast<unsigned char>(token)));
+        for (int r = row; r < row + height; r++) {
+            for (int c = col; c < col + width; c++) {
+                grid.setCell(r, c, value);
+            }
+        }
+        return true;
+    }
+    
+    if (height == 1 && width == 1) return false;
+    
+    int topHeight = (height + 1) / 2;
+    int leftWidth = (width + 1) / 2;
+    int bottomHeight = height - topHeight;
+    int rightWidth = width - leftWidth;
+    
+    if (!decodeQuadtreeRegion(data, pos, grid, row, col, topHeight, leftWidth)) return false;
+    if (rightWidth > 0 &&
+        !decodeQuadtreeRegion(data, pos, grid, row, col + leftWidth, topHeight, rightWidth)) return false;
+    if (bottomHeight > 0) {
+        if (!decodeQuadtreeRegion(data, pos, grid, row + topHeight, col, bottomHeight, leftWidth)) return false;
+        if (rightWidth > 0 &&
+            !decodeQuadtreeRegion(data, pos, grid, row + topHeight, col + leftWidth,
+                                  bottomHeight, rightWidth)) return false;
+    }
+    return true;
+}
+
+void Builder::applyDecodedGrid(const PatternGrid& decoded, const char* label) {
+    // Record per-cell SETs so undo/replay still works from commandHistory
+    int size = currentGrid.getSize();
+    int changed = 0;
+    
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            char value = decoded.getCell(row, col);
+            if (currentGrid.getCell(row, col) == value) continue;
+            
+            ParsedCommand cmd;
+            cmd.type = ParsedCommand::Type::SET_CELL;
+            cmd.row = row;
+            cmd.col = col;
+            cmd.value = value;
+            commandHistory.push_back(cmd);
+            currentGrid.setCell(row, col, value);
+            changed++;
+        }
+    }
+    
+    logDecode(label, changed);
 }
 
 string Builder::formatGridForDisplay() const {
-    stringstream ss;
     int size = currentGrid.getSize();
+    string display;
+    display.reserve(size * (2 * size + 4));
     
     // Create a visual grid display
     for (int row = 0; row < size; row++) {
-        ss << "[ ";
+        display += "[ ";
         for (int col = 0; col < size; col++) {
-            ss << currentGrid.getCell(row, col);
-            if (col < size - 1) ss << " ";
+            display += currentGrid.getCell(row, col);
+            if (col < size - 1) display += ' ';
         }
-        ss << " ]";
-        if (row < size - 1) ss << "\n";
+        display += " ]";
+        if (row < size - 1) display += '\n';
     }
     
-    return ss.str();
+    return display;
 }
\ No newline at end of file
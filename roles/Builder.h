@@ -1,8 +1,10 @@
 #pragma once
 #include "../core/PatternGrid.h"
 #include "../core/CommandParser.h"
+#include "../utils/MessageLog.h"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 class Builder {
 public:
@@ -12,9 +14,16 @@ public:
     bool executeInstruction(const std::string& instruction);
     bool executeParsedCommand(const ParsedCommand& command);
     
+    // Decoders for Dispatcher's quadtree and rectangle-cover encodings
+    bool executeQuadtreeDescription(const std::string& description);
+    bool executeRectangleDescription(const std::string& description);
+    
     // State management
     void reset();
     void undoLastCommand();
+    void restoreGrid(const PatternGrid& grid); // From a saved game
+    // Room for an episode's instructions, so executing one stays off the heap
+    void reserveHistory(int instructions, size_t instructionBytes);
     
     // Information
     const PatternGrid& getCurrentGrid() const { return currentGrid; }
@@ -22,8 +31,10 @@ public:
     std::string getGridStateDescription() const;
     
     // History and feedback
-    const std::vector<std::string>& getActionLog() const { return actionLog; }
-    const std::vector<std::string>& getReceivedInstructions() const { return receivedInstructions; }
+    std::vector<std::string> getActionLog() const; // Formatted on each call
+    void setActionLogging(bool enabled) { loggingActions = enabled; } // Off for simulations nobody reads
+    bool isActionLogging() const { return loggingActions; }
+    std::vector<std::string> getReceivedInstructions() const { return receivedInstructions.toVector(); }
     std::string getLastError() const { return lastError; }
     
     // Intelligence
@@ -31,12 +42,36 @@ public:
     std::vector<std::string> getSuggestedCorrections() const;
 
 private:
+    // A log entry as recorded; turned into text only when the log is read
+    struct ActionRecord {
+        enum class Kind : uint8_t { COMMAND, DECODE, RESTORE, UNDO, ERROR };
+        
+        Kind kind;
+        ParsedCommand::Type command; // COMMAND
+        int row;                     // COMMAND; cells changed for DECODE, loggedErrors index for ERROR
+        int col;                     // COMMAND
+        char value;                  // COMMAND
+        char oldValue;               // COMMAND
+        const char* label;           // DECODE
+    };
+    
     PatternGrid currentGrid;
-    std::vector<std::string> receivedInstructions;
-    std::vector<std::string> actionLog;
-    std::vector<ParsedCommand> commandHistory;
+    MessageLog receivedInstructions;
+    std::vector<ActionRecord> actionLog;
+    MessageLog loggedErrors;
+    std::vector<ParsedCommand> commandHistory; // Without rawCommand
+    ParsedCommand parsed; // executeInstruction's, reused
     std::string lastError;
+    bool loggingActions;
     
-    void logAction(const std::string& action);
+    void logAction(ActionRecord::Kind kind);
+    void logCommand(const ParsedCommand& command);
+    void logDecode(const char* label, int changed);
+    void logError(); // Records lastError
+    static std::string formatAction(const ActionRecord& record, const MessageLog& errors);
+    bool parseEncodingHeader(const std::string& description, const std::string& keyword, size_t& bodyStart);
+    bool decodeQuadtreeRegion(const std::string& data, size_t& pos, PatternGrid& grid,
+                              int row, int col, int height, int width) const;
+    void applyDecodedGrid(const PatternGrid& decoded, const char* label);
     std::string formatGridForDisplay() const;
 };
\ No newline at end of file
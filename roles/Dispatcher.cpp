@@ -5,18 +5,21 @@
 
 using namespace std;
 
-Dispatcher::Dispatcher(const PatternGrid& target) : targetPattern(target) {}
+unordered_map<uint64_t, Dispatcher::SharedEntry> Dispatcher::globalCache;
+mutex Dispatcher::globalCacheMutex;
+atomic<size_t> Dispatcher::globalHits(0);
+atomic<size_t> Dispatcher::globalMisses(0);
+
+Dispatcher::Dispatcher(const PatternGrid& target)
+    : targetPattern(target), patternReport(PatternAnalyzer::analyze(target)),
+      cacheHits(0), sharedCacheHits(0), cacheMisses(0) {}
 
 string Dispatcher::createInitialDescription() {
     return describeByRows();
 }
 
 string Dispatcher::createDetailedAnalysis() {
-    stringstream ss;
-    ss << describeByRows() << " ";
-    ss << findAndDescribePatterns();
-    
-    string message = ss.str();
+    string message = getEncoding(Strategy::ROWS) + " " + getEncoding(Strategy::PATTERNS);
     logMessage(message);
     return message;
 }
@@ -45,6 +48,76 @@ string Dispatcher::useRunLengthEncoding() {
     return describeUsingRLE();
 }
 
+string Dispatcher::useQuadtreeStrategy() {
+    return describeByQuadtree();
+}
+
+string Dispatcher::useRectangleCoverStrategy() {
+    return describeByRectangles();
+}
+
+string Dispatcher::useSmallestEncoding() {
+    // Only encodings Builder can decode; rows and RLE text are for people
+    const Strategy candidates[] = {
+        Strategy::QUADTREE, Strategy::RECTANGLES
+    };
+    
+    const string* best = &getEncoding(candidates[0]);
+    for (Strategy strategy : candidates) {
+        const string& encoding = getEncoding(strategy);
+        if (encoding.length() < best->length()) best = &encoding;
+    }
+    
+    string message = *best;
+    logMessage(message);
+    return message;
+}
+
+const string& Dispatcher::getEncoding(Strategy strategy) {
+    size_t index = static_cast<size_t>(strategy);
+    if (encodingCache[index]) {
+        cacheHits++;
+        return *encodingCache[index];
+    }
+    
+    {
+        lock_guard<mutex> lock(globalCacheMutex);
+        auto it = globalCache.find(targetPattern.getHash());
+        if (it != globalCache.end() && it->second.encodings[index] && it->second.target == targetPattern) {
+            encodingCache[index] = it->second.encodings[index];
+            sharedCacheHits++;
+            globalHits++;
+            return *encodingCache[index];
+        }
+    }
+    
+    encodingCache[index] = encode(strategy);
+    cacheMisses++;
+    globalMisses++;
+    
+    lock_guard<mutex> lock(globalCacheMutex);
+    auto it = globalCache.find(targetPattern.getHash());
+    if (it == globalCache.end() || !(it->second.target == targetPattern)) {
+        if (globalCache.size() >= MAX_GLOBAL_CACHE_ENTRIES) {
+            globalCache.clear();
+        }
+        it = globalCache.insert_or_assign(targetPattern.getHash(), SharedEntry{targetPattern, {}}).first;
+    }
+    it->second.encodings[index] = encodingCache[index];
+    return *encodingCache[index];
+}
+
+Dispatcher::CacheStats Dispatcher::getGlobalCacheStats() {
+    return {0, globalHits.load(), globalMisses.load()};
+}
+
+void Dispatcher::clearGlobalCache() {
+    lock_guard<mutex> lock(globalCacheMutex);
+    globalCache.clear();
+    globalHits = 0;
+    globalMisses = 0;
+}
+
 string Dispatcher::createCustomDescription(const std::string& playerInput) {
     // For now, just use row major as default for custom input
     string message = "Custom: " + playerInput;
@@ -53,27 +126,41 @@ string Dispatcher::createCustomDescription(const std::string& playerInput) {
 }
 
 string Dispatcher::getPatternAnalysis() const {
-    return targetPattern.detectPatterns();
+    return patternReport.primaryPattern();
 }
 
 vector<string> Dispatcher::getHintSuggestions() const {
     vector<string> hints;
-    int size = targetPattern.getSize();
+    const PatternReport& report = patternReport;
+    int size = report.size;
     
     // Check for patterns to suggest optimal strategies
-    string patterns = targetPattern.detectPatterns();
-    if (patterns.find("Full row") != string::npos) {
+    if (!report.fullRows.empty()) {
         hints.push_back("Use FILL ROW commands for complete rows");
     }
-    if (patterns.find("Full column") != string::npos) {
+    if (!report.fullColumns.empty()) {
         hints.push_back("Use FILL COLUMN commands for complete columns");
     }
+    if (!report.repeatedRows.empty()) {
+        const auto& group = report.repeatedRows[0];
+        hints.push_back("Row " + to_string(group[1] + 1) + " is identical to row " +
+                        to_string(group[0] + 1) + " - say so instead of repeating it");
+    }
+    if (report.checkerboard) {
+        hints.push_back(string("Checkerboard of ") + report.checkerSymbols[0] + " and " +
+                        report.checkerSymbols[1] + " - describe the alternation, not the cells");
+    }
+    if (report.hasSymmetry()) {
+        hints.push_back("The pattern is symmetric - describe one half and the mirror");
+    }
+    if (!report.uniformRectangles.empty() && report.uniformRectangles.size() <= static_cast<size_t>(size)) {
+        hints.push_back("Large uniform blocks - try the rectangle encoding");
+    }
     
-    // Count symbols to suggest REPLACE commands
-    for (char sym = 'A'; sym <= 'D'; sym++) {
-        int count = targetPattern.countSymbol(sym);
-        if (count > 6) {
-            hints.push_back("Many " + string(1, sym) + " symbols - consider using REPLACE if needed");
+    // Dominant symbols suggest filling everything first, then fixing the rest
+    for (const auto& [symbol, count] : report.symbolCounts) {
+        if (count * 8 > size * size * 3) {
+            hints.push_back("Many " + string(1, symbol) + " symbols - consider using REPLACE if needed");
         }
     }
     
@@ -96,11 +183,17 @@ double Dispatcher::evaluateStrategyEffectiveness(const std::string& strategy) co
     if (strategy.find("column") != string::npos) score += 0.1;
     
     // Adjust based on actual grid patterns
-    string patterns = targetPattern.detectPatterns();
-    if (patterns.find("Full row") != string::npos && strategy.find("row") != string::npos) {
+    if (!patternReport.fullRows.empty() && strategy.find("row") != string::npos) {
         score += 0.3;
     }
-    if (patterns.find("Full column") != string::npos && strategy.find("column") != string::npos) {
+    if (!patternReport.fullColumns.empty() && strategy.find("column") != string::npos) {
+        score += 0.3;
+    }
+    if (patternReport.hasSymmetry() && strategy.find("quadrant") != string::npos) {
+        score += 0.2;
+    }
+    if (patternReport.uniformRectangles.size() > 0 &&
+        (strategy.find("quadtree") != string::npos || strategy.find("rectangle") != string::npos)) {
         score += 0.3;
     }
     
@@ -108,6 +201,53 @@ double Dispatcher::evaluateStrategyEffectiveness(const std::string& strategy) co
 }
 
 string Dispatcher::describeByRows() {
+    return describeWith(Strategy::ROWS);
+}
+
+string Dispatcher::describeByColumns() {
+    return describeWith(Strategy::COLUMNS);
+}
+
+string Dispatcher::describeByQuadrants() {
+    return describeWith(Strategy::QUADRANTS);
+}
+
+string Dispatcher::describeUsingRLE() {
+    return describeWith(Strategy::RLE);
+}
+
+string Dispatcher::describeByQuadtree() {
+    return describeWith(Strategy::QUADTREE);
+}
+
+string Dispatcher::describeByRectangles() {
+    return describeWith(Strategy::RECTANGLES);
+}
+
+string Dispatcher::findAndDescribePatterns() {
+    return describeWith(Strategy::PATTERNS);
+}
+
+string Dispatcher::describeWith(Strategy strategy) {
+    string message = getEncoding(strategy);
+    logMessage(message);
+    return message;
+}
+
+string Dispatcher::encode(Strategy strategy) const {
+    switch (strategy) {
+        case Strategy::ROWS: return encodeRows();
+        case Strategy::COLUMNS: return encodeColumns();
+        case Strategy::QUADRANTS: return encodeQuadrants();
+        case Strategy::RLE: return encodeRLE();
+        case Strategy::QUADTREE: return encodeQuadtree();
+        case Strategy::RECTANGLES: return encodeRectangles();
+        case Strategy::PATTERNS: return encodePatterns();
+        default: return "";
+    }
+}
+
+string Dispatcher::encodeRows() const {
     stringstream ss;
     int size = targetPattern.getSize();
     
@@ -121,12 +261,10 @@ string Dispatcher::describeByRows() {
         if (row < size - 1) ss << ". ";
     }
     
-    string message = ss.str();
-    logMessage(message);
-    return message;
+    return ss.str();
 }
 
-string Dispatcher::describeByColumns() {
+string Dispatcher::encodeColumns() const {
     stringstream ss;
     int size = targetPattern.getSize();
     
@@ -140,12 +278,10 @@ string Dispatcher::describeByColumns() {
         if (col < size - 1) ss << ". ";
     }
     
-    string message = ss.str();
-    logMessage(message);
-    return message;
+    return ss.str();
 }
 
-string Dispatcher::describeByQuadrants() {
+string Dispatcher::encodeQuadrants() const {
     stringstream ss;
     int size = targetPattern.getSize();
     int half = size / 2;
@@ -179,12 +315,10 @@ string Dispatcher::describeByQuadrants() {
         }
     }
     
-    string message = ss.str();
-    logMessage(message);
-    return message;
+    return ss.str();
 }
 
-string Dispatcher::describeUsingRLE() {
+string Dispatcher::encodeRLE() const {
     stringstream ss;
     int size = targetPattern.getSize();
     
@@ -208,9 +342,67 @@ string Dispatcher::describeUsingRLE() {
         if (row < size - 1) ss << "/";
     }
     
-    string message = ss.str();
-    logMessage(message);
-    return message;
+    return ss.str();
+}
+
+// Quadtree format: "Quadtree NxN: <node>" where a node is either a single
+// symbol (uniform region) or '*' followed by its children in TL, TR, BL, BR
+// order. Regions split at ceil(h/2) and ceil(w/2); empty halves are skipped.
+string Dispatcher::encodeQuadtree() const {
+    int size = targetPattern.getSize();
+    string result = "Quadtree " + to_string(size) + "x" + to_string(size) + ": ";
+    encodeQuadtreeRegion(0, 0, size, size, result);
+    return result;
+}
+
+void Dispatcher::encodeQuadtreeRegion(int row, int col, int height, int width, string& out) const {
+    char first = targetPattern.getCell(row, col);
+    bool uniform = true;
+    for (int r = row; r < row + height && uniform; r++) {
+        for (int c = col; c < col + width; c++) {
+            if (targetPattern.getCell(r, c) != first) {
+                uniform = false;
+                break;
+            }
+        }
+    }
+    
+    if (uniform) {
+        out += first;
+        return;
+    }
+    
+    int topHeight = (height + 1) / 2;
+    int leftWidth = (width + 1) / 2;
+    int bottomHeight = height - topHeight;
+    int rightWidth = width - leftWidth;
+    
+    out += '*';
+    encodeQuadtreeRegion(row, col, topHeight, leftWidth, out);
+    if (rightWidth > 0) encodeQuadtreeRegion(row, col + leftWidth, topHeight, rightWidth, out);
+    if (bottomHeight > 0) {
+        encodeQuadtreeRegion(row + topHeight, col, bottomHeight, leftWidth, out);
+        if (rightWidth > 0) {
+            encodeQuadtreeRegion(row + topHeight, col + leftWidth, bottomHeight, rightWidth, out);
+        }
+    }
+}
+
+// Rectangle cover format: "Rectangles NxN: base X; S r,c HxW; ..." where the
+// base symbol fills the grid and each entry paints a uniform rectangle
+// (1-based top-left corner). Rectangles are grown greedily, row-major.
+string Dispatcher::encodeRectangles() const {
+    int size = targetPattern.getSize();
+    char base = patternReport.dominantSymbol();
+    
+    stringstream ss;
+    ss << "Rectangles " << size << "x" << size << ": base " << base;
+    for (const auto& rect : PatternAnalyzer::coverWithRectangles(targetPattern, base)) {
+        ss << "; " << rect.symbol << " " << (rect.row + 1) << "," << (rect.col + 1)
+           << " " << rect.height << "x" << rect.width;
+    }
+    
+    return ss.str();
 }
 
 string Dispatcher::getTargetDescription() const {
@@ -223,23 +415,18 @@ string Dispatcher::getTargetDescription() const {
     return ss.str();
 }
 
-string Dispatcher::findAndDescribePatterns() {
+string Dispatcher::encodePatterns() const {
     stringstream ss;
     
-    ss << "Pattern analysis: " << targetPattern.detectPatterns() << ". ";
+    ss << "Pattern analysis: " << patternReport.primaryPattern() << ". ";
     
     // Add symbol counts
     ss << "Symbol counts: ";
-    for (char sym = 'A'; sym <= 'D'; sym++) {
-        int count = targetPattern.countSymbol(sym);
-        if (count > 0) {
-            ss << sym << ":" << count << " ";
-        }
+    for (const auto& [symbol, count] : patternReport.symbolCounts) {
+        ss << symbol << ":" << count << " ";
     }
     
-    string message = ss.str();
-    logMessage(message);
-    return message;
+    return ss.str();
 }
 
 void Dispatcher::logMessage(const std::string& message) {
@@ -1,11 +1,34 @@
 #pragma once
 #include "../core/PatternGrid.h"
+#include "../core/PatternAnalyzer.h"
 #include <vector>
 #include <string>
 #include <memory>
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
 
 class Dispatcher {
 public:
+    enum class Strategy {
+        ROWS,
+        COLUMNS,
+        QUADRANTS,
+        RLE,
+        QUADTREE,
+        RECTANGLES,
+        PATTERNS,
+        COUNT
+    };
+    
+    struct CacheStats {
+        size_t hits;        // Served from this dispatcher's own cache
+        size_t sharedHits;  // Served from the cross-episode global cache
+        size_t misses;      // Had to be encoded
+    };
+    
     Dispatcher(const PatternGrid& target);
     
     // Communication strategies
@@ -19,12 +42,16 @@ public:
     std::string useColumnMajorStrategy(); 
     std::string useQuadrantStrategy();
     std::string useRunLengthEncoding();
+    std::string useQuadtreeStrategy();
+    std::string useRectangleCoverStrategy();
+    std::string useSmallestEncoding(); // Shortest encoding Builder can decode (quadtree or rectangles)
     
     // Interactive
     std::string createCustomDescription(const std::string& playerInput);
     
     // Analysis tools
     std::string getPatternAnalysis() const;
+    const PatternReport& getPatternReport() const { return patternReport; }
     std::vector<std::string> getHintSuggestions() const;
     
     // Getters
@@ -37,16 +64,57 @@ public:
     
     // Strategy scoring
     double evaluateStrategyEffectiveness(const std::string& strategy) const;
+    
+    // Encoding cache (targetPattern is immutable, so encodings never go stale)
+    const std::string& getEncoding(Strategy strategy);
+    CacheStats getCacheStats() const { return {cacheHits, sharedCacheHits, cacheMisses}; }
+    static CacheStats getGlobalCacheStats();
+    static void clearGlobalCache();
 
 private:
+    static constexpr size_t STRATEGY_COUNT = static_cast<size_t>(Strategy::COUNT);
+    static constexpr size_t MAX_GLOBAL_CACHE_ENTRIES = 4096;
+    using EncodingSet = std::array<std::optional<std::string>, STRATEGY_COUNT>;
+    
+    struct SharedEntry {
+        PatternGrid target; // Guards against hash collisions
+        EncodingSet encodings;
+    };
+    
     PatternGrid targetPattern;
+    PatternReport patternReport;
     std::vector<std::string> sentMessages;
     
+    EncodingSet encodingCache;
+    size_t cacheHits;
+    size_t sharedCacheHits;
+    size_t cacheMisses;
+    
+    static std::unordered_map<uint64_t, SharedEntry> globalCache;
+    static std::mutex globalCacheMutex;
+    static std::atomic<size_t> globalHits;
+    static std::atomic<size_t> globalMisses;
+    
     std::string describeByRows();
     std::string describeByColumns();
     std::string describeByQuadrants();
     std::string describeUsingRLE();
+    std::string describeByQuadtree();
+    std::string describeByRectangles();
     std::string findAndDescribePatterns();
     
+    std::string describeWith(Strategy strategy);
+    std::string encode(Strategy strategy) const;
+    
+    // Pure encoders (no logging)
+    std::string encodeRows() const;
+    std::string encodeColumns() const;
+    std::string encodeQuadrants() const;
+    std::string encodePatterns() const;
+    std::string encodeRLE() const;
+    std::string encodeQuadtree() const;
+    std::string encodeRectangles() const;
+    void encodeQuadtreeRegion(int row, int col, int height, int width, std::string& out) const;
+    
     void logMessage(const std::string& message);
 };
\ No newline at end of file
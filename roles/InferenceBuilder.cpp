@@ -0,0 +1,333 @@
+#include "InferenceBuilder.h"
+#include "../core/CommandParser.h"
+#include "../utils/Utilities.h"
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+
+using namespace std;
+
+const string InferenceBuilder::DEFAULT_ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+
+namespace {
+    // Probability mass for tokens the model can't otherwise explain (garbled
+    // words, static); keeps a single odd token from zeroing out a symbol
+    const float NOISE_FLOOR = 0.002f;
+    
+    const char* NUMBER_WORDS[] = {"ZERO", "ONE", "TWO", "THREE", "FOUR", "FIVE",
+                                  "SIX", "SEVEN", "EIGHT", "NINE"};
+}
+
+InferenceBuilder::InferenceBuilder(int gridSize, shared_ptr<MessageNoiseSimulator> noiseModel,
+                                   const string& alphabet)
+    : size(gridSize), cellCount(gridSize * gridSize), alphabet(alphabet),
+      noiseModel(noiseModel), observationCount(0) {
+    fill(begin(symbolIndex), end(symbolIndex), -1);
+    for (size_t i = 0; i < alphabet.size(); i++) {
+        symbolIndex[static_cast<unsigned char>(alphabet[i])] = static_cast<int>(i);
+    }
+    reset();
+}
+
+void InferenceBuilder::reset() {
+    logPosterior.assign(alphabet.size() * cellCount, 0.0f);
+    observationCount = 0;
+}
+
+int InferenceBuilder::observe(const string& message) {
+    int used = 0;
+    
+    for (const auto& segment : splitSegments(message)) {
+        vector<string> tokens = tokenize(segment);
+        
+        // Line descriptions: "<ROW|LINE|COLUMN...> <n> <symbols...>"
+        bool handled = false;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            int index = parseIndex(tokens[i]);
+            if (index < 1 || index > size) continue;
+            
+            // The technical Messenger says "row vector 3" / "column vector 3"
+            const string& keyword = (tokens[i - 1] == "VECTOR" && i >= 2) ? tokens[i - 2] : tokens[i - 1];
+            bool isRow = isRowKeyword(keyword);
+            if (!isRow && !isColumnKeyword(keyword)) continue;
+            
+            vector<string> symbols(tokens.begin() + i + 1, tokens.end());
+            used += observeLine(isRow, index - 1, symbols);
+            handled = true;
+            break;
+        }
+        
+        // "2: A B C D" - the line keyword was forgotten; rows are by far the
+        // most common description, so assume one
+        if (!handled && tokens.size() > 1 && parseIndex(tokens[0]) >= 1 && parseIndex(tokens[0]) <= size &&
+            segment.find(':') != string::npos) {
+            vector<string> symbols(tokens.begin() + 1, tokens.end());
+            used += observeLine(true, parseIndex(tokens[0]) - 1, symbols);
+            handled = true;
+        }
+        
+        if (!handled) {
+            used += observeCommand(segment);
+        }
+    }
+    
+    observationCount += used;
+    return used;
+}
+
+int InferenceBuilder::observeLine(bool isRow, int index, const vector<string>& symbolTokens) {
+    // Keep only tokens that carry evidence about some symbol
+    vector<const vector<float>*> evidence;
+    for (const auto& token : symbolTokens) {
+        const vector<float>* likelihood = getTokenLikelihood(token);
+        if (likelihood) evidence.push_back(likelihood);
+    }
+    
+    int count = static_cast<int>(evidence.size());
+    if (count == 0 || count > size) return 0;
+    
+    // With k forgotten words, token i may belong to any of cells i..i+k, so
+    // its evidence is spread evenly across those candidates
+    int slack = size - count;
+    float weight = 1.0f / (slack + 1);
+    
+    for (int i = 0; i < count; i++) {
+        for (int offset = 0; offset <= slack; offset++) {
+            int pos = i + offset;
+            int cell = isRow ? index * size + pos : pos * size + index;
+            applyEvidence(cell, *evidence[i], weight);
+        }
+    }
+    
+    return count;
+}
+
+int InferenceBuilder::observeCommand(const string& segment) {
+    ParsedCommand cmd = CommandParser::parse(segment);
+    if (cmd.type == ParsedCommand::Type::INVALID) return 0;
+    
+    PatternGrid bounds(size);
+    if (!CommandParser::validateCommand(cmd, bounds)) return 0;
+    
+    const vector<float>* likelihood = getTokenLikelihood(string(1, cmd.value));
+    if (!likelihood) return 0;
+    
+    switch (cmd.type) {
+        case ParsedCommand::Type::SET_CELL:
+            applyEvidence(cmd.row * size + cmd.col, *likelihood, 1.0f);
+            return 1;
+        case ParsedCommand::Type::FILL_ROW:
+            for (int col = 0; col < size; col++) applyEvidence(cmd.row * size + col, *likelihood, 1.0f);
+            return size;
+        case ParsedCommand::Type::FILL_COLUMN:
+            for (int row = 0; row < size; row++) applyEvidence(row * size + cmd.col, *likelihood, 1.0f);
+            return size;
+        default:
+            // REPLACE/CLEAR depend on the builder's state rather than the target
+            return 0;
+    }
+}
+
+void InferenceBuilder::applyEvidence(int cell, const vector<float>& logLikelihood, float weight) {
+    // Each symbol plane is contiguous, so this touches one float per plane
+    size_t symbols = alphabet.size();
+    for (size_t s = 0; s < symbols; s++) {
+        logPosterior[s * cellCount + cell] += weight * logLikelihood[s];
+    }
+}
+
+const vector<float>* InferenceBuilder::getTokenLikelihood(const string& token) {
+    auto it = likelihoodCache.find(token);
+    if (it == likelihoodCache.end()) {
+        it = likelihoodCache.emplace(token, buildTokenLikelihood(token)).first;
+    }
+    return it->second.empty() ? nullptr : &it->second;
+}
+
+vector<float> InferenceBuilder::buildTokenLikelihood(const string& token) const {
+    // P(token | symbol) for a word that survived the channel (wasn't forgotten):
+    //   kept as-is       (1 - f - m) / (1 - f)   single chars are immune to typos
+    //   misinterpreted    m / (1 - f), spread over that symbol's confusions
+    double forget = noiseModel ? noiseModel->getForgetProbability() : 0.0;
+    double misinterpret = noiseModel ? noiseModel->getMisinterpretProbability() : 0.0;
+    double survived = max(1e-6, 1.0 - forget);
+    double pKeep = (1.0 - forget - misinterpret) / survived;
+    double pMisinterpret = misinterpret / survived;
+    
+    static const map<string, vector<string>, less<>> noConfusions;
+    const auto& confusions = noiseModel ? noiseModel->getMisinterpretations() : noConfusions;
+    vector<float> logLikelihood(alphabet.size());
+    bool informative = false;
+    
+    for (size_t s = 0; s < alphabet.size(); s++) {
+        string symbol(1, alphabet[s]);
+        double likelihood = 0.0;
+        
+        if (token == symbol) likelihood += pKeep;
+        
+        auto it = confusions.find(symbol);
+        if (it != confusions.end()) {
+            int matches = 0;
+            for (const auto& variant : it->second) {
+                if (Utilities::toUpper(variant) == token) matches++;
+            }
+            likelihood += pMisinterpret * matches / it->second.size();
+        } else if (alphabet[s] >= '1' && alphabet[s] <= '4') {
+            if (token == NUMBER_WORDS[alphabet[s] - '0']) likelihood += pMisinterpret;
+        } else if (token == symbol) {
+            likelihood += pMisinterpret; // Falls through to a typo, which leaves 1-char words intact
+        }
+        
+        informative = informative || likelihood > 0.0;
+        logLikelihood[s] = static_cast<float>(log(likelihood + NOISE_FLOOR));
+    }
+    
+    return informative ? logLikelihood : vector<float>();
+}
+
+PatternGrid InferenceBuilder::getMapGrid() const {
+    PatternGrid grid(size);
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            grid.setCell(row, col, getMapSymbol(row, col));
+        }
+    }
+    return grid;
+}
+
+char InferenceBuilder::getMapSymbol(int row, int col) const {
+    int cell = row * size + col;
+    size_t best = 0;
+    for (size_t s = 1; s < alphabet.size(); s++) {
+        if (logPosterior[s * cellCount + cell] > logPosterior[best * cellCount + cell]) best = s;
+    }
+    
+    // No evidence yet: every symbol ties, so report an empty cell
+    if (logPosterior[best * cellCount + cell] == 0.0f && symbolIndex[static_cast<unsigned char>('_')] >= 0) {
+        bool allZero = true;
+        for (size_t s = 0; s < alphabet.size() && allZero; s++) {
+            allZero = logPosterior[s * cellCount + cell] == 0.0f;
+        }
+        if (allZero) return '_';
+    }
+    return alphabet[best];
+}
+
+double InferenceBuilder::getConfidence(int row, int col) const {
+    int cell = row * size + col;
+    float maxLog = logPosterior[cell];
+    for (size_t s = 1; s < alphabet.size(); s++) {
+        maxLog = max(maxLog, logPosterior[s * cellCount + cell]);
+    }
+    
+    double total = 0.0;
+    for (size_t s = 0; s < alphabet.size(); s++) {
+        total += exp(static_cast<double>(logPosterior[s * cellCount + cell] - maxLog));
+    }
+    return 1.0 / total;
+}
+
+double InferenceBuilder::getLogProbability(int row, int col, char symbol) const {
+    int index = symbolIndex[static_cast<unsigned char>(symbol)];
+    if (index < 0 || row < 0 || row >= size || col < 0 || col >= size) return log(NOISE_FLOOR);
+    
+    int cell = row * size + col;
+    float maxLog = logPosterior[cell];
+    for (size_t s = 1; s < alphabet.size(); s++) {
+        maxLog = max(maxLog, logPosterior[s * cellCount + cell]);
+    }
+    
+    double total = 0.0;
+    for (size_t s = 0; s < alphabet.size(); s++) {
+        total += exp(static_cast<double>(logPosterior[s * cellCount + cell] - maxLog));
+    }
+    return logPosterior[index * cellCount + cell] - maxLog - log(total);
+}
+
+double InferenceBuilder::getMeanConfidence() const {
+    double total = 0.0;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            total += getConfidence(row, col);
+        }
+    }
+    return cellCount > 0 ? total / cellCount : 0.0;
+}
+
+int InferenceBuilder::commitTo(Builder& builder, double minConfidence) const {
+    const PatternGrid& current = builder.getCurrentGrid();
+    int changed = 0;
+    
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            char symbol = getMapSymbol(row, col);
+            if (current.getCell(row, col) == symbol || getConfidence(row, col) < minConfidence) continue;
+            
+            ParsedCommand cmd;
+            cmd.type = ParsedCommand::Type::SET_CELL;
+            cmd.row = row;
+            cmd.col = col;
+            cmd.value = symbol;
+            cmd.rawCommand = "INFERRED";
+            if (builder.executeParsedCommand(cmd)) changed++;
+        }
+    }
+    
+    return changed;
+}
+
+vector<string> InferenceBuilder::splitSegments(const string& message) {
+    vector<string> segments;
+    string current;
+    for (char c : message) {
+        if (c == '.' || c == '\n' || c == '|' || c == ';') {
+            if (!Utilities::trim(current).empty()) segments.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!Utilities::trim(current).empty()) segments.push_back(current);
+    return segments;
+}
+
+vector<string> InferenceBuilder::tokenize(const string& segment) {
+    // Uppercased words with surrounding punctuation stripped; '_' is a symbol
+    vector<string> tokens;
+    string current;
+    for (char c : segment) {
+        if (isalnum(static_cast<unsigned char>(c)) || c == '_') {
+            current += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        } else if (!current.empty()) {
+            tokens.push_back(current);
+            current.clear();
+        }
+    }
+    if (!current.empty()) tokens.push_back(current);
+    return tokens;
+}
+
+int InferenceBuilder::parseIndex(const string& token) {
+    if (!token.empty() && all_of(token.begin(), token.end(), ::isdigit) && token.size() < 6) {
+        return stoi(token);
+    }
+    for (int i = 1; i < 10; i++) {
+        if (token == NUMBER_WORDS[i]) return i;
+    }
+    static const char* ORDINALS[] = {"", "FIRST", "SECOND", "THIRD", "FOURTH"};
+    for (int i = 1; i <= 4; i++) {
+        if (token == ORDINALS[i]) return i;
+    }
+    return -1;
+}
+
+bool InferenceBuilder::isRowKeyword(const string& token) {
+    // Includes the Messenger's paraphrases and the noise dictionary's confusions
+    static const char* KEYWORDS[] = {"ROW", "LINE", "TIER", "SEQUENCE", "ARRAY"};
+    return find(begin(KEYWORDS), end(KEYWORDS), token) != end(KEYWORDS);
+}
+
+bool InferenceBuilder::isColumnKeyword(const string& token) {
+    static const char* KEYWORDS[] = {"COLUMN", "VERTICAL", "COLLUM", "COMLUMN", "PILE", "STACK", "COL"};
+    return find(begin(KEYWORDS), end(KEYWORDS), token) != end(KEYWORDS);
+}
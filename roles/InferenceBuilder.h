@@ -0,0 +1,65 @@
+#pragma once
+#include "../core/PatternGrid.h"
+#include "../core/MessageSystem.h"
+#include "Builder.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+// Builder agent that treats each relayed message as noisy evidence about the
+// target grid. It keeps a log-probability per (symbol, cell), updates it with
+// a likelihood model inverted from MessageNoiseSimulator's forget,
+// misinterpret and typo rates, and commits the maximum a posteriori grid.
+class InferenceBuilder {
+public:
+    static const std::string DEFAULT_ALPHABET;
+    
+    InferenceBuilder(int gridSize, std::shared_ptr<MessageNoiseSimulator> noiseModel,
+                     const std::string& alphabet = DEFAULT_ALPHABET);
+    
+    // Belief updates
+    int observe(const std::string& message); // Returns the number of cell observations used
+    void reset();
+    
+    // Inference
+    PatternGrid getMapGrid() const;
+    char getMapSymbol(int row, int col) const;
+    double getConfidence(int row, int col) const; // Posterior of the MAP symbol
+    double getLogProbability(int row, int col, char symbol) const;
+    double getMeanConfidence() const;
+    
+    // Writes the MAP grid into a Builder as SET commands; cells below
+    // minConfidence are left alone. Returns the number of cells changed.
+    int commitTo(Builder& builder, double minConfidence = 0.5) const;
+    
+    int getObservationCount() const { return observationCount; }
+    int getGridSize() const { return size; }
+
+private:
+    int size;
+    int cellCount;
+    std::string alphabet;
+    std::shared_ptr<MessageNoiseSimulator> noiseModel;
+    
+    // Structure-of-arrays: logPosterior[symbol * cellCount + cell]
+    std::vector<float> logPosterior;
+    int symbolIndex[256];
+    int observationCount;
+    
+    // Per-token log-likelihood over the alphabet, built on first use
+    std::unordered_map<std::string, std::vector<float>> likelihoodCache;
+    
+    const std::vector<float>* getTokenLikelihood(const std::string& token);
+    std::vector<float> buildTokenLikelihood(const std::string& token) const;
+    void applyEvidence(int cell, const std::vector<float>& logLikelihood, float weight);
+    
+    int observeLine(bool isRow, int index, const std::vector<std::string>& symbolTokens);
+    int observeCommand(const std::string& segment);
+    
+    static std::vector<std::string> splitSegments(const std::string& message);
+    static std::vector<std::string> tokenize(const std::string& segment);
+    static int parseIndex(const std::string& token);
+    static bool isRowKeyword(const std::string& token);
+    static bool isColumnKeyword(const std::string& token);
+};
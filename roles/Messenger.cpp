@@ -1,6 +1,7 @@
 #include "Messenger.h"
 #include "../utils/Utilities.h"
 #include "../utils/Random.h"
+#include "../utils/Trace.h"
 #include <sstream>
 #include <algorithm>
 #include <random>
@@ -9,34 +10,31 @@ using namespace std;
 
 // Define the constant that's declared in the header
 const int Messenger::MAX_HISTORY = 10;
+const int Messenger::MAX_LINE_LENGTH = 50;
 
 Messenger::Messenger(shared_ptr<MessageNoiseSimulator> simulator, int maxLines, bool canAsk)
     : noiseSimulator(simulator), maxLinesPerTurn(maxLines), canAskForRepeat(canAsk),
       currentBandwidth(100), maxBandwidth(100), detailOriented(false), rushed(false), technical(false) {}
 
-string Messenger::processMessage(const string& message) {
-    receivedMessages.push_back(message);
-    messageHistory.push_back(message);
-    
-    // Keep history within limits
-    if (messageHistory.size() > MAX_HISTORY) {
-        messageHistory.erase(messageHistory.begin());
-    }
-    
-    string processed = applyNoiseAndParaphrase(message);
-    sentMessages.push_back(processed);
-    return processed;
+const string& Messenger::processMessage(const string& message) {
+    TRACE_SCOPE("Messenger::processMessage");
+    receivedMessages.append(message);
+    applyNoiseAndParaphrase(message);
+    sentMessages.append(relay);
+    return relay;
 }
 
 string Messenger::processWithContext(const string& message, const string& context) {
-    receivedMessages.push_back(message);
+    receivedMessages.append(message);
     
     string noisyMessage = noiseSimulator->applyStrategicNoise(message, context);
-    string paraphrased = paraphraseMessage(noisyMessage);
-    string personalityApplied = applyPersonality(paraphrased);
-    string limited = enforceLineLimit(personalityApplied);
+    string paraphrased;
+    paraphraseMessage(noisyMessage, paraphrased);
+    applyPersonality(paraphrased);
+    string limited;
+    enforceLineLimit(paraphrased, limited);
     
-    sentMessages.push_back(limited);
+    sentMessages.append(limited);
     return limited;
 }
 
@@ -44,12 +42,12 @@ string Messenger::applyMemoryRecall(const string& currentMessage, int turnsAgo)
     // Remove unused parameter warning by marking it as unused
     (void)currentMessage; // This prevents the unused parameter warning
     
-    if (turnsAgo <= 0 || turnsAgo > static_cast<int>(messageHistory.size())) {
+    size_t remembered = min(receivedMessages.size(), static_cast<size_t>(MAX_HISTORY));
+    if (turnsAgo <= 0 || turnsAgo > static_cast<int>(remembered)) {
         return "I don't remember that far back.";
     }
     
-    size_t index = messageHistory.size() - turnsAgo;
-    string recalledMessage = messageHistory[index];
+    string recalledMessage(receivedMessages[receivedMessages.size() - turnsAgo]);
     
     // Apply memory decay based on how long ago it was
     string decayed = noiseSimulator->applyMemoryDecay(recalledMessage, turnsAgo);
@@ -79,16 +77,14 @@ string Messenger::summarizeMultipleMessages(const vector<string>& messages) {
 }
 
 string Messenger::requestClarification(const string& unclearPart) {
-    vector<string> clarificationRequests = {
-        "Can you repeat the part about " + unclearPart + "?",
-        "I didn't catch the " + unclearPart + " clearly.",
-        "Could you clarify " + unclearPart + "?",
-        "The " + unclearPart + " was unclear, please repeat.",
-        "Say again about " + unclearPart + "?"
-    };
-    
-    int index = Random::getInt(0, static_cast<int>(clarificationRequests.size()) - 1);
-    return clarificationRequests[index];
+    // Pick first, then build only the chosen wording
+    switch (Random::getInt(0, 4)) {
+        case 0: return "Can you repeat the part about " + unclearPart + "?";
+        case 1: return "I didn't catch the " + unclearPart + " clearly.";
+        case 2: return "Could you clarify " + unclearPart + "?";
+        case 3: return "The " + unclearPart + " was unclear, please repeat.";
+        default: return "Say again about " + unclearPart + "?";
+    }
 }
 
 bool Messenger::canSendMessage(int proposedLength) const {
@@ -98,7 +94,7 @@ bool Messenger::canSendMessage(int proposedLength) const {
 }
 
 vector<string> Messenger::chunkMessage(const string& message) {
-    return MessageFormatter::splitByBandwidth(message, maxLinesPerTurn, 50);
+    return MessageFormatter::splitByBandwidth(message, maxLinesPerTurn, MAX_LINE_LENGTH);
 }
 
 void Messenger::setPersonalityTraits(bool isDetailOriented, bool isRushed, bool isTechnical) {
@@ -107,27 +103,33 @@ void Messenger::setPersonalityTraits(bool isDetailOriented, bool isRushed, bool
     technical = isTechnical;
 }
 
-string Messenger::applyNoiseAndParaphrase(const string& message) {
-    string noisyMessage = noiseSimulator->applyNoise(message);
-    string paraphrased = paraphraseMessage(noisyMessage);
-    string personalityApplied = applyPersonality(paraphrased);
-    return enforceLineLimit(personalityApplied);
+void Messenger::applyNoiseAndParaphrase(const string& message) {
+    // Each step reads one buffer and writes the other, so both keep their capacity
+    noiseSimulator->applyNoiseInto(message, staging);
+    paraphraseMessage(staging, relay);
+    applyPersonality(relay);
+    enforceLineLimit(relay, staging);
+    relay.swap(staging);
 }
 
-string Messenger::paraphraseMessage(const string& message) {
-    vector<string> sentences;
-    stringstream ss(message);
-    string sentence;
+void Messenger::paraphraseMessage(string_view message, string& out) {
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> pieces(scratch.resource());
+    Utilities::splitInto(message, '.', pieces);
     
     // Split into sentences
-    while (getline(ss, sentence, '.')) {
-        sentence = Utilities::trim(sentence);
+    ScratchVector<string_view> sentences(scratch.resource());
+    for (string_view piece : pieces) {
+        string_view sentence = Utilities::trimView(piece);
         if (!sentence.empty()) {
             sentences.push_back(sentence);
         }
     }
     
-    if (sentences.empty()) return message;
+    if (sentences.empty()) {
+        out.assign(message);
+        return;
+    }
     
     // Occasionally reorder sentences - create local random generator
     static std::random_device rd;
@@ -138,84 +140,102 @@ string Messenger::paraphraseMessage(const string& message) {
     }
     
     // Reconstruct with paraphrasing
-    stringstream result;
+    out.clear();
+    out.reserve(message.length() + message.length() / 2);
+    ScratchString paraphrased(scratch.resource());
     for (size_t i = 0; i < sentences.size(); i++) {
         // Simple paraphrasing by replacing common phrases
-        string paraphrased = sentences[i];
+        paraphrased.assign(sentences[i].begin(), sentences[i].end());
         
         // Replace common instruction phrases with synonyms
-        paraphrased = Utilities::replaceAll(paraphrased, "row", "line");
-        paraphrased = Utilities::replaceAll(paraphrased, "column", "vertical");
-        paraphrased = Utilities::replaceAll(paraphrased, "grid", "layout");
-        paraphrased = Utilities::replaceAll(paraphrased, "pattern", "arrangement");
+        Utilities::replaceAllInPlace(paraphrased, "row", "line");
+        Utilities::replaceAllInPlace(paraphrased, "column", "vertical");
+        Utilities::replaceAllInPlace(paraphrased, "grid", "layout");
+        Utilities::replaceAllInPlace(paraphrased, "pattern", "arrangement");
         
-        result << paraphrased;
-        if (i < sentences.size() - 1) result << ". ";
+        out += paraphrased;
+        if (i < sentences.size() - 1) out += ". ";
     }
-    
-    return result.str();
 }
 
-string Messenger::enforceLineLimit(const string& message) {
-    vector<string> lines = chunkMessage(message);
-    
-    stringstream result;
-    size_t maxLines = min(lines.size(), static_cast<size_t>(maxLinesPerTurn));
-    for (size_t i = 0; i < maxLines; i++) {
-        result << lines[i];
-        if (i < maxLines - 1) {
-            result << "\n";
+void Messenger::enforceLineLimit(string_view message, string& out) const {
+    ScratchArena::Scope scratch;
+    ScratchVector<string_view> lines(scratch.resource());
+    bool cut = MessageFormatter::splitByBandwidthInto(message, maxLinesPerTurn, MAX_LINE_LENGTH, lines);
+    
+    out.clear();
+    out.reserve(message.length() + 3);
+    for (size_t i = 0; i < lines.size(); i++) {
+        out += lines[i];
+        if (i < lines.size() - 1) {
+            out += '\n';
         }
     }
-    
-    return result.str();
+    if (cut) out += "...";
 }
 
-string Messenger::applyPersonality(const string& message) {
-    string result = message;
-    
+void Messenger::applyPersonality(string& message) {
     if (rushed) {
         // Shorten message, add rushed indicators
         if (message.length() > 100) {
-            result = message.substr(0, 100) + "... hurry!";
+            message.resize(100);
+            message += "... hurry!";
         }
         // Add rushed phrases
-        vector<string> rushedPhrases = {"Quick: ", "Fast: ", "Rush: "};
+        static const char* const rushedPhrases[] = {"Quick: ", "Fast: ", "Rush: "};
         if (Random::getBool(0.3)) {
-            int index = Random::getInt(0, static_cast<int>(rushedPhrases.size()) - 1);
-            result = rushedPhrases[index] + result;
+            int index = Random::getInt(0, 2);
+            message.insert(0, rushedPhrases[index]);
         }
     }
     
     if (detailOriented && !rushed) {
         // Add more detail and confirmation
-        vector<string> detailPhrases = {"Confirming: ", "Detailed: ", "Noting: "};
+        static const char* const detailPhrases[] = {"Confirming: ", "Detailed: ", "Noting: "};
         if (Random::getBool(0.4)) {
-            int index = Random::getInt(0, static_cast<int>(detailPhrases.size()) - 1);
-            result = detailPhrases[index] + result;
+            int index = Random::getInt(0, 2);
+            message.insert(0, detailPhrases[index]);
         }
     }
     
     if (technical) {
         // Use more technical language
-        result = Utilities::replaceAll(result, "line", "row vector");
-        result = Utilities::replaceAll(result, "vertical", "column vector");
-        result = Utilities::replaceAll(result, "layout", "matrix configuration");
+        Utilities::replaceAllInPlace(message, "line", "row vector");
+        Utilities::replaceAllInPlace(message, "vertical", "column vector");
+        Utilities::replaceAllInPlace(message, "layout", "matrix configuration");
     }
-    
-    return result;
 }
 
 // Getters implementation
 // Remove or fix line 20 - it appears to be a comment or misplaced code
 // async a message configuration; // This line seems invalid
 
-const std::vector<std::string>& Messenger::getSentMessages() const {
-    return sentMessages;
+void Messenger::restoreHistory(const vector<string>& received, const vector<string>& sent) {
+    receivedMessages.assign(received);
+    sentMessages.assign(sent);
+}
+
+void Messenger::reserveHistory(int messages) {
+    size_t count = static_cast<size_t>(max(messages, 0));
+    receivedMessages.reserve(count, count * getMaxRelayLength());
+    sentMessages.reserve(count, count * getMaxRelayLength());
+    
+    // Paraphrasing can outgrow the line limit before it is applied
+    relay.reserve(2 * getMaxRelayLength());
+    staging.reserve(2 * getMaxRelayLength());
+}
+
+size_t Messenger::getMaxRelayLength() const {
+    // Full lines joined by newlines, then "..." on a cut
+    return static_cast<size_t>(maxLinesPerTurn) * (MAX_LINE_LENGTH + 1) + 2;
+}
+
+vector<string> Messenger::getSentMessages() const {
+    return sentMessages.toVector();
 }
 
-const std::vector<std::string>& Messenger::getReceivedMessages() const {
-    return receivedMessages;
+vector<string> Messenger::getReceivedMessages() const {
+    return receivedMessages.toVector();
 }
 
 int Messenger::getBandwidthUsed() const {
@@ -1,5 +1,6 @@
 #pragma once
 #include "../core/MessageSystem.h"
+#include "../utils/MessageLog.h"
 #include <vector>
 #include <string>
 #include <memory>
@@ -9,8 +10,8 @@ public:
     Messenger(std::shared_ptr<MessageNoiseSimulator> simulator, 
               int maxLines = 2, bool canAsk = true);
     
-    // Core message processing
-    std::string processMessage(const std::string& message);
+    // Core message processing. The relay is valid until the next call.
+    const std::string& processMessage(const std::string& message);
     std::string processWithContext(const std::string& message, const std::string& context);
     
     // Advanced features
@@ -26,20 +27,26 @@ public:
     bool canStillAsk() const { return canAskForRepeat; }
     void useRepeatAsk() { canAskForRepeat = false; }
     void resetBandwidth() { currentBandwidth = maxBandwidth; }
+    void restoreHistory(const std::vector<std::string>& received, const std::vector<std::string>& sent);
+    // Room for this many messages each way, so a turn's processMessage stays
+    // off the heap; instructions longer than a relay can be still spill
+    void reserveHistory(int messages);
+    size_t getMaxRelayLength() const; // Longest relay the line limit lets through
     
     // Personality traits (affects message style)
     void setPersonalityTraits(bool isDetailOriented, bool isRushed, bool isTechnical);
 
     // Getters
-    const std::vector<std::string>& getSentMessages() const;
-    const std::vector<std::string>& getReceivedMessages() const;
+    std::vector<std::string> getSentMessages() const;
+    std::vector<std::string> getReceivedMessages() const;
     int getBandwidthUsed() const;
     
 private:
     std::shared_ptr<MessageNoiseSimulator> noiseSimulator;
-    std::vector<std::string> receivedMessages;
-    std::vector<std::string> sentMessages;
-    std::vector<std::string> messageHistory;
+    MessageLog receivedMessages;
+    MessageLog sentMessages;
+    std::string relay;   // processMessage's result
+    std::string staging; // The pipeline's other buffer; the two swap
     
     int maxLinesPerTurn;
     bool canAskForRepeat;
@@ -51,10 +58,11 @@ private:
     bool rushed;
     bool technical;
     
-    static const int MAX_HISTORY;
+    static const int MAX_HISTORY; // How far back applyMemoryRecall reaches
+    static const int MAX_LINE_LENGTH;
     
-    std::string applyNoiseAndParaphrase(const std::string& message);
-    std::string paraphraseMessage(const std::string& message);
-    std::string enforceLineLimit(const std::string& message);
-    std::string applyPersonality(const std::string& message);
+    void applyNoiseAndParaphrase(const std::string& message); // Into relay
+    void paraphraseMessage(std::string_view message, std::string& out);
+    void enforceLineLimit(std::string_view message, std::string& out) const;
+    void applyPersonality(std::string& message);
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "Check.h"
+#include "../bench/AllocationCounter.h"
+#include "../game/DispatchGame.h"
+#include "../roles/Messenger.h"
+#include "../utils/ScratchArena.h"
+#include <memory>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+const string INSTRUCTIONS[] = {
+    "FILL ROW 1 WITH A", "SET(2,3)=B. Then check the grid", "FILL COLUMN 4 WITH C", "REPLACE ALL A WITH D"
+};
+
+void playHeadlessTurn(DispatchGame& game, int turn) {
+    ScratchArena::Scope scratch; // As playTurn does
+    game.beginTurn();
+    game.relayInstruction(INSTRUCTIONS[turn % 4]);
+    game.buildRelayed();
+}
+
+}
+
+CHECK_CASE(headlessTurnDoesNotAllocate) {
+    DispatchGame game(PatternGrid(4));
+    game.setInteractive(false);
+
+    // The first turns size the reused buffers
+    const int warmup = 4;
+    for (int turn = 0; turn < warmup; turn++) playHeadlessTurn(game, turn);
+
+    AllocationCounter::Scope counted;
+    for (int turn = warmup; turn < 16; turn++) playHeadlessTurn(game, turn); // Inside the message limit
+    CHECK(counted.getCount() == 0);
+}
+
+CHECK_CASE(messengerProcessMessageDoesNotAllocate) {
+    Messenger messenger(make_shared<MessageNoiseSimulator>(NoiseLevel::EXTREME));
+    messenger.reserveHistory(64);
+    for (const string& instruction : INSTRUCTIONS) messenger.processMessage(instruction);
+
+    AllocationCounter::Scope counted;
+    for (int message = 0; message < 32; message++) {
+        ScratchArena::Scope scratch;
+        messenger.processMessage(INSTRUCTIONS[message % 4]);
+    }
+    CHECK(counted.getCount() == 0);
+}
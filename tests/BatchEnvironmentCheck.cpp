@@ -0,0 +1,63 @@
+#include "Check.h"
+#include "../game/BatchEnvironment.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Steps two copies of the same batch, one per thread count, and compares them
+bool sameAfterSteps(int threadsA, int threadsB) {
+    BatchEnvironment a(4, Difficulty::NORMAL, 99);
+    BatchEnvironment b(4, Difficulty::NORMAL, 99);
+    a.setThreadCount(threadsA);
+    b.setThreadCount(threadsB);
+    a.reset(512);
+    b.reset(512);
+
+    const string actions[] = {"FILL ROW 1 WITH A", "SET(2,3)=B", "FILL COLUMN 4 WITH C", "REPLACE ALL A WITH D"};
+    for (const string& action : actions) {
+        vector<string> messages(512, action);
+        const BatchStepResult& stepA = a.step(messages);
+        const BatchStepResult& stepB = b.step(messages);
+        if (stepA.rewards != stepB.rewards || stepA.delivered != stepB.delivered) return false;
+    }
+    return a.getGrids() == b.getGrids();
+}
+
+}
+
+CHECK_CASE(batchEnvironmentRejectsWrongSizedTargets) {
+    BatchEnvironment env(4);
+    env.reset(2);
+
+    CHECK(!env.reset(vector<PatternGrid>{PatternGrid(4), PatternGrid(5)}));
+    CHECK(env.size() == 2); // Unchanged
+
+    CHECK(env.reset(vector<PatternGrid>{PatternGrid(4), PatternGrid(4), PatternGrid(4)}));
+    CHECK(env.size() == 3);
+}
+
+CHECK_CASE(batchEnvironmentSolvesGivenTargets) {
+    PatternGrid target(4);
+    for (int row = 0; row < 4; row++) target.fillRow(row, 'A');
+
+    BatchEnvironment env(4);
+    env.setNoiseEnabled(false);
+    CHECK(env.reset(vector<PatternGrid>(3, target)));
+
+    for (int row = 1; row <= 4; row++) {
+        env.step(vector<string>(3, "FILL ROW " + to_string(row) + " WITH A"));
+    }
+    CHECK(env.allDone());
+    for (int i = 0; i < env.size(); i++) {
+        CHECK(env.calculateMetrics(i).accuracy == 100.0);
+        CHECK(env.getTurn(i) == 4);
+    }
+}
+
+CHECK_CASE(batchEnvironmentIsIndependentOfThreadCount) {
+    CHECK(sameAfterSteps(1, 4));
+    CHECK(sameAfterSteps(3, 8)); // Uneven chunks
+}
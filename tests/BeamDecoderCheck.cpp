@@ -0,0 +1,93 @@
+#include "Check.h"
+#include "../roles/BeamDecoder.h"
+#include "../roles/Builder.h"
+#include "../game/DispatchGame.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+shared_ptr<MessageNoiseSimulator> mediumNoise() {
+    return make_shared<MessageNoiseSimulator>(NoiseLevel::MEDIUM);
+}
+
+}
+
+CHECK_CASE(beamDecoderNoOpCommandKeepsParentGrid) {
+    // CLEAR on an empty grid changes nothing; the hypothesis must still have a grid
+    BeamDecoder decoder(4, mediumNoise());
+    decoder.decode("CLEAR");
+    decoder.decode("CLEAR");
+    CHECK(decoder.getBestGrid() == PatternGrid(4));
+
+    decoder.decode("FILL ROW 1 WITH A");
+    decoder.decode("FILL ROW 1 WITH A");
+    CHECK(decoder.getBestGrid().getCell(0, 0) == 'A');
+    CHECK(decoder.getBestGrid().getCell(0, 3) == 'A');
+}
+
+CHECK_CASE(beamDecoderRecoversParaphrasedCommand) {
+    // The Messenger's paraphrase turns "row" into "line", which Builder can't parse
+    Builder builder(4);
+    CHECK(!builder.executeInstruction("FILL LINE 2 WITH B"));
+
+    BeamDecoder decoder(4, mediumNoise());
+    CHECK(decoder.recover(builder, "FILL LINE 2 WITH B") == 4);
+    for (int col = 0; col < 4; col++) {
+        CHECK(builder.getCurrentGrid().getCell(1, col) == 'B');
+    }
+}
+
+CHECK_CASE(beamDecoderLeavesUnreadableMessagesAlone) {
+    Builder builder(4);
+    builder.executeInstruction("FILL ROW 1 WITH A");
+    PatternGrid before = builder.getCurrentGrid();
+
+    BeamDecoder decoder(4, mediumNoise());
+    CHECK(decoder.recover(builder, "nothing useful here") == 0);
+    CHECK(builder.getCurrentGrid() == before);
+}
+
+CHECK_CASE(garbleRecoveryIsOffByDefault) {
+    DispatchGame game(PatternGrid(4));
+    CHECK(!game.isGarbleRecoveryEnabled());
+    game.setGarbleRecovery(true);
+    CHECK(game.isGarbleRecoveryEnabled());
+    game.setGarbleRecovery(false);
+    CHECK(!game.isGarbleRecoveryEnabled());
+}
+
+CHECK_CASE(beamDecoderKeepsHypothesesAcrossMessages) {
+    Builder builder(4);
+    BeamDecoder decoder(4, mediumNoise());
+    CHECK(decoder.recover(builder, "FILL LINE 1 WITH A") == 4);
+    CHECK(decoder.recover(builder, "FILL LINE 3 WITH C") == 4);
+
+    vector<ParsedCommand> commands = decoder.getBestCommands();
+    CHECK(commands.size() == 2);
+    CHECK(decoder.getBestGrid() == builder.getCurrentGrid());
+}
+
+CHECK_CASE(beamDecoderRanksReadingsByBuiltCells) {
+    // At HIGH noise a lone "B" is nearly as often a misheard "A" as a "B"
+    auto highNoise = make_shared<MessageNoiseSimulator>(NoiseLevel::HIGH);
+    PatternGrid built(4);
+    built.setCell(0, 0, 'A');
+
+    BeamDecoder blind(4, highNoise);
+    blind.decode("PUT 1,1 B");
+    CHECK(blind.getBestCommands().back().value == 'B');
+
+    BeamDecoder informed(4, highNoise);
+    informed.decode("PUT 1,1 B", &built);
+    CHECK(informed.getBestCommands().back().value == 'A');
+}
+
+CHECK_CASE(beamDecoderReadsSpelledCoordinatesOnLargeGrids) {
+    Builder builder(8);
+    BeamDecoder decoder(8, mediumNoise());
+    CHECK(decoder.recover(builder, "FILL LINE SEVEN WITH D") == 8);
+    CHECK(builder.getCurrentGrid().getCell(6, 7) == 'D');
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+// Minimal self-checking harness behind `make check`. Each tests/*.cpp file
+// defines its cases with CHECK_CASE; CHECK records a failure and carries on,
+// so one run reports every broken expectation.
+namespace Check {
+    using Case = void (*)();
+
+    bool registerCase(const char* name, Case run);
+    void fail(const char* file, int line, const char* expression);
+}
+
+#define CHECK(expression) ((expression) ? (void)0 : Check::fail(__FILE__, __LINE__, #expression))
+
+#define CHECK_CASE(name) \
+    static void name(); \
+    static const bool name##Registered = Check::registerCase(#name, name); \
+    static void name()
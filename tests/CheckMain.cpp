@@ -0,0 +1,54 @@
+#include "Check.h"
+#include <iostream>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+struct Registered {
+    const char* name;
+    Check::Case run;
+};
+
+// Function-local so registration from other files' static initializers is safe
+vector<Registered>& registry() {
+    static vector<Registered> cases;
+    return cases;
+}
+
+int failures = 0;
+
+}
+
+bool Check::registerCase(const char* name, Case run) {
+    registry().push_back({name, run});
+    return true;
+}
+
+void Check::fail(const char* file, int line, const char* expression) {
+    failures++;
+    cerr << file << ":" << line << ": CHECK(" << expression << ") failed\n";
+}
+
+int main(int argc, char* argv[]) {
+    string filter = argc > 1 ? argv[1] : "";
+
+    int run = 0;
+    int failedCases = 0;
+    for (const auto& check : registry()) {
+        if (!filter.empty() && string(check.name).find(filter) == string::npos) continue;
+
+        int before = failures;
+        check.run();
+        run++;
+        if (failures != before) {
+            failedCases++;
+            cerr << "FAILED " << check.name << "\n";
+        }
+    }
+
+    cout << run - failedCases << "/" << run << " checks passed\n";
+    return failedCases == 0 ? 0 : 1;
+}
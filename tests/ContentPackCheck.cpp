@@ -0,0 +1,37 @@
+#include "Check.h"
+#include "../data/ContentPack.h"
+#include <filesystem>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+PackedEpisode episode(int number, string_view pattern) {
+    PackedEpisode packed;
+    packed.number = number;
+    packed.title = "Title";
+    packed.description = "Description";
+    packed.pattern = pattern;
+    packed.gridSize = 2;
+    return packed;
+}
+
+}
+
+CHECK_CASE(contentPackRejectsRepeatedEpisodeNumbers) {
+    string path = (filesystem::temp_directory_path() / "dispatch_check.pack").string();
+    CHECK(ContentPack::write(path, {episode(1, "ABCD"), episode(2, "AABB")}, {}));
+
+    // Refused, and the pack already there is left whole
+    CHECK(!ContentPack::write(path, {episode(3, "ABCD"), episode(3, "DCBA")}, {}));
+    ContentPack pack;
+    CHECK(pack.open(path));
+    CHECK(pack.getEpisodeCount() == 2);
+    PackedEpisode found;
+    CHECK(pack.findEpisode(2, found) && found.pattern == "AABB");
+    pack.close();
+
+    CHECK(!filesystem::exists(path + ".tmp"));
+    filesystem::remove(path);
+}
@@ -0,0 +1,106 @@
+#include "Check.h"
+#include "../game/DispatchGame.h"
+#include "../data/SaveSystem.h"
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Plays nothing; a headless game records its result when it finishes
+void finishHeadless(GameData& data, int episodeNumber, Difficulty difficulty = Difficulty::NORMAL) {
+    DispatchGame game(PatternGrid(4), difficulty);
+    game.setInteractive(false);
+    game.recordTo(data, episodeNumber);
+    game.finishEpisode();
+}
+
+}
+
+CHECK_CASE(dispatchGameRecordsToPlayerData) {
+    GameData data;
+    finishHeadless(data, 1);
+    finishHeadless(data, 2);
+    CHECK(data.getTotalGamesPlayed() == 2);
+    CHECK(data.getCurrentEpisode() == 3);
+
+    finishHeadless(data, 437); // Random challenge: counted, but the story stays put
+    CHECK(data.getTotalGamesPlayed() == 3);
+    CHECK(data.getCurrentEpisode() == 3);
+}
+
+CHECK_CASE(dispatchGameFilesStatisticsUnderItsDifficulty) {
+    GameData data;
+    finishHeadless(data, 1, Difficulty::HARD);
+    finishHeadless(data, 2, Difficulty::EXPERT);
+    CHECK(data.getStatistics(Difficulty::HARD).getGamesPlayed() == 1);
+    CHECK(data.getStatistics(Difficulty::EXPERT).getGamesPlayed() == 1);
+    CHECK(data.getStatistics(Difficulty::NORMAL).getGamesPlayed() == 0);
+    CHECK(data.getStatistics().getGamesPlayed() == 2);
+}
+
+CHECK_CASE(dispatchGameUnlocksAchievementsOnPlayerData) {
+    const AchievementRegistry& registry = AchievementRegistry::getDefault();
+    int firstContact = registry.findByName("First Contact");
+    int veteran = registry.findByName("Veteran Dispatcher");
+    CHECK(firstContact >= 0 && veteran >= 0);
+
+    GameData data;
+    for (int game = 1; game <= 50; game++) {
+        DispatchGame episode(PatternGrid(4));
+        episode.setInteractive(false);
+        episode.recordTo(data, game);
+        episode.finishEpisode();
+
+        CHECK(data.hasAchievement(firstContact));
+        CHECK(data.hasAchievement(veteran) == (game == 50));
+    }
+
+    // Already unlocked, so a later game reports nothing new for it
+    GameMetrics metrics;
+    vector<AchievementId> unlocked = data.addCompletedEpisode(51, metrics);
+    CHECK(find(unlocked.begin(), unlocked.end(), static_cast<AchievementId>(firstContact)) == unlocked.end());
+}
+
+CHECK_CASE(dispatchGameResumesFromJournalAndDiscardsItWhenDone) {
+    string previousDirectory = SaveSystem::getSaveDirectory();
+    string directory = (filesystem::temp_directory_path() / "dispatch_checks_saves").string();
+    SaveSystem::setSaveDirectory(directory);
+
+    PatternGrid target(4);
+    target.fillRow(0, 'A');
+    GameData data;
+    PatternGrid builtBefore;
+    {
+        DispatchGame game(target, Difficulty::HARD);
+        game.setInteractive(false);
+        game.recordTo(data, 2);
+        game.enableJournal("Check Slot");
+        game.beginTurn();
+        game.relayInstruction("FILL ROW 1 WITH A");
+        game.buildRelayed();
+        builtBefore = game.getBuilderGrid();
+    } // Left unfinished, as if the player quit
+
+    GameData resumedData;
+    DispatchGame resumed(PatternGrid(4));
+    resumed.setInteractive(false);
+    resumed.recordTo(resumedData, 1);
+    CHECK(resumed.loadGameState("Check Slot"));
+    CHECK(resumed.getTargetPattern() == target);
+    CHECK(resumed.getBuilderGrid() == builtBefore);
+    CHECK(resumed.getEpisodeNumber() == 2);
+    CHECK(resumedData.getDifficulty() == Difficulty::HARD);
+
+    resumed.enableJournal("Check Slot");
+    resumed.finishEpisode();
+    CHECK(!SaveSystem::saveExists("Check Slot"));
+    CHECK(!filesystem::exists(SaveJournal::getJournalPath("Check Slot")));
+    CHECK(resumedData.getTotalGamesPlayed() == 1);
+
+    error_code ec;
+    filesystem::remove_all(directory, ec);
+    SaveSystem::setSaveDirectory(previousDirectory);
+}
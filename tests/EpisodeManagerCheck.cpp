@@ -0,0 +1,68 @@
+#include "Check.h"
+#include "../game/EpisodeManager.h"
+#include "../data/ContentPack.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+CHECK_CASE(episodeManagerFallsBackForUnknownNumbers) {
+    ContentPack none;
+    EpisodeManager manager(none);
+    CHECK(manager.getEpisode(424242).number == 1);
+
+    // A pack's episodes replace the built-in set, fallback included
+    PackedEpisode packed;
+    packed.number = 7;
+    packed.title = "Packed";
+    packed.pattern = "ABBA";
+    packed.gridSize = 2;
+    packed.requiredSkillPoints = 5;
+
+    string path = "episode_manager_check.pack";
+    CHECK(ContentPack::write(path, {packed}, {}));
+    ContentPack pack;
+    CHECK(pack.open(path));
+    EpisodeManager fromPack(pack);
+    CHECK(fromPack.getEpisode(1).number == 7);
+    pack.close();
+    remove(path.c_str());
+}
+
+CHECK_CASE(episodeManagerKeepsOneOffEpisodesOutOfTheCatalog) {
+    ContentPack none;
+    EpisodeManager manager(none);
+    vector<const Episode*> before = manager.getAvailableEpisodes(1000);
+
+    const Episode* slot = nullptr;
+    for (int i = 0; i < 100; i++) {
+        const Episode& random = manager.generateRandomEpisode(Difficulty::TRAINING);
+        CHECK(random.number == EpisodeManager::RANDOM_EPISODE_NUMBER);
+        CHECK(!slot || slot == &random);
+        slot = &random;
+    }
+    const Episode& custom = manager.createCustomEpisode("Mine", PatternGrid(4));
+    CHECK(custom.number == EpisodeManager::CUSTOM_EPISODE_NUMBER);
+    CHECK(custom.title == "Mine");
+
+    CHECK(manager.getAvailableEpisodes(1000) == before);
+    CHECK(manager.getEpisodeCount() == 3);
+    CHECK(!manager.findEpisode(EpisodeManager::RANDOM_EPISODE_NUMBER));
+    CHECK(!manager.findEpisode(EpisodeManager::CUSTOM_EPISODE_NUMBER));
+}
+
+CHECK_CASE(episodeManagerReplacesEpisodesInPlace) {
+    ContentPack none;
+    EpisodeManager manager(none);
+    const Episode* first = &manager.getEpisode(2);
+
+    Episode replacement = *first;
+    replacement.title = "Split Channels, Revised";
+    replacement.requiredSkillPoints = 0;
+    replacement.unlocked = true;
+    CHECK(&manager.addEpisode(replacement) == first);
+    CHECK(first->title == "Split Channels, Revised");
+    CHECK(manager.getEpisodeCount() == 3);
+    CHECK(manager.getAvailableEpisodes(0).size() == 2);
+}
@@ -0,0 +1,96 @@
+#include "Check.h"
+#include "../roles/InferenceBuilder.h"
+#include "../roles/Builder.h"
+#include "../roles/Dispatcher.h"
+#include "../game/DispatchGame.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+PatternGrid target() {
+    return PatternGrid({{'A', 'B', 'C', 'D'}, {'A', 'A', 'D', 'D'}, {'C', 'B', 'B', 'A'}, {'D', 'C', 'C', 'C'}});
+}
+
+// What a Dispatcher sends: the row description, then a cell at a time
+vector<string> dispatcherMessages(const PatternGrid& grid, int turns) {
+    Dispatcher dispatcher(grid);
+    vector<string> messages;
+    for (int turn = 0; turn < turns; turn++) {
+        if (turn % 2 == 0) {
+            messages.push_back(dispatcher.useRowMajorStrategy());
+        } else {
+            int cell = (turn / 2) % 16;
+            int row = cell / 4;
+            int col = cell % 4;
+            messages.push_back("PUT " + to_string(row + 1) + "," + to_string(col + 1) + " " + grid.getCell(row, col));
+        }
+    }
+    return messages;
+}
+
+// Mean accuracy over seeded episodes: {plain Builder, InferenceBuilder}
+pair<double, double> compare(NoiseLevel level, int turns) {
+    auto noise = make_shared<MessageNoiseSimulator>(level);
+    PatternGrid goal = target();
+    vector<string> messages = dispatcherMessages(goal, turns);
+
+    double plainTotal = 0;
+    double inferredTotal = 0;
+    const int episodes = 20;
+    for (int episode = 0; episode < episodes; episode++) {
+        RandomStream stream(1000 + episode);
+        Builder plain(4);
+        Builder assisted(4);
+        InferenceBuilder inference(4, noise);
+        for (const string& message : messages) {
+            string relayed = noise->applyNoise(message, stream);
+            plain.executeInstruction(relayed);
+            inference.observe(relayed);
+            if (!assisted.executeInstruction(relayed)) inference.commitTo(assisted);
+        }
+        plainTotal += plain.getCurrentGrid().calculateAccuracy(goal);
+        inferredTotal += assisted.getCurrentGrid().calculateAccuracy(goal);
+    }
+    return {plainTotal / episodes, inferredTotal / episodes};
+}
+
+}
+
+CHECK_CASE(inferenceBuilderBeatsExactParsingUnderHeavyNoise) {
+    // Ten messages: all an EXPERT episode allows
+    pair<double, double> high = compare(NoiseLevel::HIGH, 10);
+    CHECK(high.second > high.first + 25.0);
+
+    pair<double, double> extreme = compare(NoiseLevel::EXTREME, 10);
+    CHECK(extreme.second > extreme.first + 5.0);
+}
+
+CHECK_CASE(beliefInferenceBuildsFromDescriptions) {
+    // The Builder can't parse a row description; with inference on it is still
+    // evidence. The game's channel isn't seeded, so judge the mean of a few
+    const int games = 8;
+    double assistedTotal = 0;
+    for (int i = 0; i < games; i++) {
+        DispatchGame plain(target(), Difficulty::TRAINING);
+        DispatchGame assisted(target(), Difficulty::TRAINING);
+        plain.setInteractive(false);
+        assisted.setInteractive(false);
+        assisted.setBeliefInference(true);
+        CHECK(assisted.isBeliefInferenceEnabled());
+
+        for (int turn = 0; turn < 5; turn++) {
+            for (DispatchGame* game : {&plain, &assisted}) {
+                game->beginTurn();
+                game->relayInstruction(game->openingInstruction());
+                game->buildRelayed();
+            }
+        }
+        CHECK(plain.getAccuracy() == 0.0);
+        assistedTotal += assisted.getAccuracy();
+    }
+    CHECK(assistedTotal / games > 50.0);
+}
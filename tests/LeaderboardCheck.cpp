@@ -0,0 +1,18 @@
+#include "Check.h"
+#include "../data/Leaderboard.h"
+#include <vector>
+
+using namespace std;
+
+CHECK_CASE(leaderboardWithoutTopListsStillRanks) {
+    TopScores none(0);
+    CHECK(!none.qualifies(1000));
+    CHECK(!none.offer({1000, 0, 1, Difficulty::NORMAL, 0}));
+
+    Leaderboard leaderboard(0);
+    uint32_t player = leaderboard.addPlayer("Player");
+    leaderboard.submitBatch(player, 1, Difficulty::NORMAL, {300, 500, 400}, {1, 1, 0});
+    CHECK(leaderboard.getEntryCount(Difficulty::NORMAL) == 2);
+    CHECK(leaderboard.getRank(450, Difficulty::NORMAL) == 2);
+    CHECK(leaderboard.getTop(Difficulty::NORMAL).empty());
+}
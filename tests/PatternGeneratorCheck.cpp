@@ -0,0 +1,43 @@
+#include "Check.h"
+#include "../game/PatternGenerator.h"
+#include "../game/EpisodeManager.h"
+#include "../data/ContentPack.h"
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+CHECK_CASE(patternGeneratorHitsTargetComplexityAtEverySize) {
+    PatternGenerator generator(7);
+    for (int size : {4, 8, 16, 64}) {
+        for (Difficulty difficulty : {Difficulty::TRAINING, Difficulty::NORMAL, Difficulty::HARD, Difficulty::EXPERT}) {
+            double target = PatternGenerator::getTargetComplexity(difficulty);
+            for (int i = 0; i < 8; i++) {
+                PatternGrid grid = generator.generate(size, difficulty);
+                CHECK(grid.getSize() == size);
+                CHECK(fabs(PatternGenerator::estimateComplexity(grid) - target) <= generator.getTolerance());
+            }
+        }
+    }
+}
+
+CHECK_CASE(patternGeneratorBatchIsDistinctUpToSymmetry) {
+    PatternGenerator generator(11);
+    unordered_set<uint64_t> exclude;
+    for (int round = 0; round < 3; round++) {
+        vector<PatternGrid> batch = generator.generateBatch(200, 8, Difficulty::HARD, 4, &exclude);
+        CHECK(batch.size() == 200);
+        for (const PatternGrid& grid : batch) {
+            CHECK(exclude.insert(grid.getCanonicalHash()).second);
+            CHECK(fabs(PatternGenerator::estimateComplexity(grid) - 0.5) <= generator.getTolerance());
+        }
+    }
+}
+
+CHECK_CASE(episodeManagerGeneratesAtTheRequestedSize) {
+    ContentPack none;
+    EpisodeManager manager(none);
+    CHECK(manager.generateRandomEpisode(Difficulty::EXPERT, 16).pattern.getSize() == 16);
+    CHECK(manager.generateRandomEpisode(Difficulty::NORMAL).pattern.getSize() == 4);
+}
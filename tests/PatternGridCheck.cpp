@@ -0,0 +1,41 @@
+#include "Check.h"
+#include "../core/PatternGrid.h"
+#include <set>
+
+using namespace std;
+
+CHECK_CASE(canonicalFormIgnoresSymmetryAndSymbolNames) {
+    PatternGrid grid(4);
+    grid.fillRow(0, 'A');
+    grid.setCell(2, 1, 'B');
+
+    PatternGrid renamed(4);
+    renamed.fillColumn(3, 'X'); // Row 1 turned clockwise, with other symbols
+    renamed.setCell(1, 1, 'Y');
+    CHECK(grid.getCanonicalHash() == renamed.getCanonicalHash());
+
+    PatternGrid full(4);
+    for (int row = 0; row < 4; row++) full.fillRow(row, 'A');
+    CHECK(PatternGrid(4).getCanonicalHash() != full.getCanonicalHash()); // Empty isn't a symbol
+}
+
+CHECK_CASE(canonicalFormLabelsEverySymbolDistinctly) {
+    // Every byte value but '_' once, and one empty cell
+    PatternGrid grid(16);
+    int symbol = 0;
+    for (int row = 0; row < 16; row++) {
+        for (int col = 0; col < 16; col++) {
+            if (row == 15 && col == 15) break;
+            if (symbol == '_') symbol++;
+            grid.setCell(row, col, static_cast<char>(symbol++));
+        }
+    }
+
+    PatternGrid canonical = grid.canonicalForm();
+    set<char> labels;
+    for (int row = 0; row < 16; row++) {
+        for (int col = 0; col < 16; col++) labels.insert(canonical.getCell(row, col));
+    }
+    CHECK(labels.size() == 256);
+    CHECK(canonical.countSymbol('_') == 1);
+}
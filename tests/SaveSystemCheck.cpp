@@ -0,0 +1,37 @@
+#include "Check.h"
+#include "../data/SaveSystem.h"
+#include <filesystem>
+#include <string>
+
+using namespace std;
+
+CHECK_CASE(saveSystemRoundTripsProgress) {
+    string previousDirectory = SaveSystem::getSaveDirectory();
+    string directory = (filesystem::temp_directory_path() / "dispatch_checks_saves").string();
+    SaveSystem::setSaveDirectory(directory);
+
+    GameData data;
+    data.setDifficulty(Difficulty::EXPERT);
+    GameMetrics metrics{};
+    metrics.accuracy = 100.0;
+    metrics.turnsTaken = 4;
+    metrics.score = 1200;
+    data.addCompletedEpisode(1, metrics);
+    CHECK(SaveSystem::saveGame("Round Trip", data, 2));
+
+    GameData loaded;
+    int episode = 0;
+    CHECK(SaveSystem::loadGame("Round Trip", loaded, episode));
+    CHECK(episode == 2);
+    CHECK(loaded.getDifficulty() == Difficulty::EXPERT);
+    CHECK(loaded.getSkillPoints() == data.getSkillPoints());
+    CHECK(loaded.getCurrentEpisode() == 2);
+    CHECK(loaded.getUnlockedAchievements().getWords() == data.getUnlockedAchievements().getWords());
+    CHECK(!loaded.getUnlockedAchievements().empty());
+    CHECK(loaded.getStatistics(Difficulty::EXPERT).getGamesPlayed() == 1);
+    CHECK(loaded.getHighestScore() == 1200);
+
+    error_code ec;
+    filesystem::remove_all(directory, ec);
+    SaveSystem::setSaveDirectory(previousDirectory);
+}
@@ -0,0 +1,75 @@
+#include "Check.h"
+#include "../game/TurnStateMachine.h"
+#include "../game/PatternGenerator.h"
+#include "../ui/AsyncInput.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Turn limit 1s, replies after 1.5s, episode limit 3s: the opening
+// description is relayed at once, the next two instructions time out, and
+// the episode limit ends the game during the third wait
+const int TURN_LIMIT_SECONDS = 1;
+const int EPISODE_LIMIT_SECONDS = 3;
+const int64_t REPLY_DELAY_MS = 1500;
+
+struct SlowGame {
+    DispatchGame game;
+    ScriptedInput input;
+    TurnStateMachine machine;
+    int finishedCalls = 0;
+
+    SlowGame(EventLoop& loop, const PatternGrid& target)
+        : game(target, Difficulty::NORMAL),
+          input(loop, vector<string>(8, "FILL ROW 1 WITH A"), REPLY_DELAY_MS),
+          machine(game, loop, input, [this]() { finishedCalls++; }) {
+        game.setInteractive(false);
+        game.setTimeLimits(TURN_LIMIT_SECONDS, EPISODE_LIMIT_SECONDS);
+    }
+};
+
+}
+
+CHECK_CASE(turnStateMachineTimesOutSlowInstructions) {
+    EventLoop loop;
+    PatternGenerator generator(3);
+    SlowGame slow(loop, generator.generate(8, Difficulty::EXPERT));
+
+    int64_t started = EventLoop::nowMs();
+    slow.machine.start();
+    loop.run();
+
+    CHECK(slow.machine.isFinished());
+    CHECK(slow.finishedCalls == 1);
+    CHECK(slow.machine.getTimeouts() == 2);
+    CHECK(!slow.game.isComplete());
+    CHECK(loop.pendingTimers() == 0);
+    CHECK(EventLoop::nowMs() - started < (EPISODE_LIMIT_SECONDS + 1) * 1000);
+}
+
+CHECK_CASE(turnStateMachineInterleavesGamesOnOneLoop) {
+    const int GAMES = 16;
+    EventLoop loop;
+    PatternGenerator generator(5);
+    vector<unique_ptr<SlowGame>> games;
+    for (int i = 0; i < GAMES; i++) {
+        games.push_back(make_unique<SlowGame>(loop, generator.generate(8, Difficulty::EXPERT)));
+    }
+
+    // All share one thread, so the whole run takes one episode limit, not sixteen
+    int64_t started = EventLoop::nowMs();
+    for (auto& slow : games) slow->machine.start();
+    loop.run();
+
+    for (auto& slow : games) {
+        CHECK(slow->machine.isFinished());
+        CHECK(slow->finishedCalls == 1);
+        CHECK(slow->machine.getTimeouts() == 2);
+    }
+    CHECK(loop.pendingTimers() == 0);
+    CHECK(EventLoop::nowMs() - started < (EPISODE_LIMIT_SECONDS + 1) * 1000);
+}
@@ -0,0 +1,81 @@
+#include "../net/GameServer.h"
+#include "../net/Socket.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+
+GameServer* activeServer = nullptr;
+
+void handleSignal(int) {
+    if (activeServer) activeServer->stop();
+}
+
+void printUsage() {
+    cout << "Usage: dispatch_server [--tcp HOST:PORT] [--unix PATH] [--seed N] [--quiet]\n"
+         << "Defaults to --tcp 127.0.0.1:7777. See net/Protocol.h for the wire protocol.\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    string tcpAddress;
+    string unixPath;
+    uint64_t seed = static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--tcp" && i + 1 < argc) tcpAddress = argv[++i];
+        else if (arg == "--unix" && i + 1 < argc) unixPath = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--quiet") quiet = true;
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (tcpAddress.empty() && unixPath.empty()) tcpAddress = "127.0.0.1:7777";
+
+    int descriptors = Socket::raiseDescriptorLimit();
+    GameServer server(seed);
+
+    if (!tcpAddress.empty()) {
+        size_t colon = tcpAddress.rfind(':');
+        if (colon == string::npos || !server.listenTcp(tcpAddress.substr(0, colon), atoi(tcpAddress.c_str() + colon + 1))) {
+            cerr << "Could not listen on " << tcpAddress << "\n";
+            return 1;
+        }
+        cout << "Listening on tcp://" << tcpAddress << "\n";
+    }
+    if (!unixPath.empty()) {
+        if (!server.listenUnix(unixPath)) {
+            cerr << "Could not listen on " << unixPath << "\n";
+            return 1;
+        }
+        cout << "Listening on unix://" << unixPath << "\n";
+    }
+    cout << "Descriptor limit: " << descriptors << " (about " << descriptors / 3 << " sessions)\n";
+
+    activeServer = &server;
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    auto lastReport = chrono::steady_clock::now();
+    while (!server.isStopping() && server.poll(200)) {
+        if (!quiet && chrono::steady_clock::now() - lastReport >= chrono::seconds(5)) {
+            const ServerStats& stats = server.getStats();
+            cout << "connections " << stats.openConnections << "  sessions " << stats.activeSessions
+                 << "  finished " << stats.sessionsFinished << "  turns " << stats.turnsPlayed << "\n";
+            lastReport = chrono::steady_clock::now();
+        }
+    }
+
+    activeServer = nullptr;
+    return 0;
+}
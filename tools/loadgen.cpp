@@ -0,0 +1,260 @@
+#include "../net/Protocol.h"
+#include "../net/Socket.h"
+#include "../data/StreamingStats.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+using namespace std;
+using namespace chrono;
+
+// Drives many three-client sessions against dispatch_server with scripted
+// roles: the Dispatcher sends SET commands for the first wrong cell, the
+// Messenger relays verbatim, the Builder builds what it hears. Reports turn
+// latency (Dispatcher SEND to GRID) and throughput.
+
+namespace {
+
+struct Options {
+    string tcpAddress;
+    string unixPath;
+    int sessions = 100;
+    int rounds = 1;
+    int timeoutSeconds = 60;
+    string difficulty = "normal";
+};
+
+struct Bot {
+    array<int, 3> fds{{-1, -1, -1}}; // Indexed by Role
+    array<LineBuffer, 3> inputs;
+    string target;
+    string grid;
+    int maxTurns = 0;
+    int messageLimit = 0;
+    int turn = 0;
+    int messagesSent = 0;
+    int roundsLeft = 0;
+    bool finished = false;
+    steady_clock::time_point sentAt;
+};
+
+struct Totals {
+    uint64_t turns = 0;
+    uint64_t games = 0;
+    uint64_t perfect = 0;
+    uint64_t errors = 0;
+    RunningStats scores;
+    LogHistogram latencyMicros;
+};
+
+bool writeLine(int fd, const string& line) {
+    size_t written = 0;
+    while (written < line.size()) {
+        ssize_t n = ::send(fd, line.data() + written, line.size() - written, MSG_NOSIGNAL);
+        if (n > 0) {
+            written += static_cast<size_t>(n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            continue; // Lines are tiny; the server drains them quickly
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int connectTo(const Options& options) {
+    if (!options.unixPath.empty()) return Socket::connectUnix(options.unixPath);
+    size_t colon = options.tcpAddress.rfind(':');
+    if (colon == string::npos) return -1;
+    return Socket::connectTcp(options.tcpAddress.substr(0, colon), atoi(options.tcpAddress.c_str() + colon + 1));
+}
+
+void sendNextInstruction(Bot& bot) {
+    if (bot.grid == bot.target || bot.turn >= bot.maxTurns || bot.messagesSent >= bot.messageLimit) {
+        return; // END is on its way
+    }
+
+    int size = 1;
+    while (size * size < static_cast<int>(bot.target.size())) size++;
+    for (size_t i = 0; i < bot.target.size(); i++) {
+        if (bot.grid[i] != bot.target[i]) {
+            string command = "SET(" + to_string(i / size + 1) + "," + to_string(i % size + 1) + ")=" + bot.target[i];
+            bot.messagesSent++;
+            bot.sentAt = steady_clock::now();
+            writeLine(bot.fds[static_cast<size_t>(Role::DISPATCHER)], Protocol::format("SEND", command));
+            return;
+        }
+    }
+}
+
+void handleLine(Bot& bot, Role role, const string& line, const Options& options, Totals& totals) {
+    ProtocolMessage message = Protocol::parse(line);
+    int dispatcher = bot.fds[static_cast<size_t>(Role::DISPATCHER)];
+
+    if (message.verb == "CREATED") {
+        for (Role member : {Role::DISPATCHER, Role::MESSENGER, Role::BUILDER}) {
+            writeLine(bot.fds[static_cast<size_t>(member)],
+                      Protocol::format("JOIN", message.argument + " " + Protocol::roleName(member)));
+        }
+    } else if (message.verb == "START") {
+        if (role == Role::DISPATCHER) {
+            int size = 0;
+            sscanf(message.argument.c_str(), "%d %d %d", &size, &bot.maxTurns, &bot.messageLimit);
+            bot.turn = 0;
+            bot.messagesSent = 0;
+        }
+    } else if (message.verb == "TARGET") {
+        bot.target = message.argument;
+        bot.grid.assign(bot.target.size(), '_');
+        sendNextInstruction(bot);
+    } else if (message.verb == "MESSAGE") {
+        if (role == Role::MESSENGER) {
+            writeLine(bot.fds[static_cast<size_t>(Role::MESSENGER)], Protocol::format("SEND", message.argument));
+        } else if (role == Role::BUILDER) {
+            writeLine(bot.fds[static_cast<size_t>(Role::BUILDER)], Protocol::format("BUILD", message.argument));
+        }
+    } else if (message.verb == "GRID" && role == Role::DISPATCHER) {
+        auto latency = duration_cast<microseconds>(steady_clock::now() - bot.sentAt).count();
+        totals.latencyMicros.add(static_cast<double>(latency));
+        totals.turns++;
+
+        int accuracy = 0;
+        char cells[256] = {0};
+        if (sscanf(message.argument.c_str(), "%d %d %255s", &bot.turn, &accuracy, cells) == 3) {
+            bot.grid = cells;
+        }
+        sendNextInstruction(bot);
+    } else if (message.verb == "END" && role == Role::DISPATCHER) {
+        int score = 0;
+        int accuracy = 0;
+        sscanf(message.argument.c_str(), "%d %d", &score, &accuracy);
+        totals.games++;
+        totals.scores.add(score);
+        if (accuracy == 100) totals.perfect++;
+
+        if (--bot.roundsLeft > 0) {
+            writeLine(dispatcher, Protocol::format("CREATE", options.difficulty));
+        } else {
+            bot.finished = true;
+        }
+    } else if (message.verb == "ERROR" || message.verb == "LEFT") {
+        totals.errors++;
+    }
+}
+
+void printUsage() {
+    cout << "Usage: dispatch_loadgen [--tcp HOST:PORT | --unix PATH] [--sessions N] [--rounds N]\n"
+         << "                        [--difficulty training|normal|hard|expert] [--timeout SECONDS]\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--tcp" && i + 1 < argc) options.tcpAddress = argv[++i];
+        else if (arg == "--unix" && i + 1 < argc) options.unixPath = argv[++i];
+        else if (arg == "--sessions" && i + 1 < argc) options.sessions = max(1, atoi(argv[++i]));
+        else if (arg == "--rounds" && i + 1 < argc) options.rounds = max(1, atoi(argv[++i]));
+        else if (arg == "--difficulty" && i + 1 < argc) options.difficulty = argv[++i];
+        else if (arg == "--timeout" && i + 1 < argc) options.timeoutSeconds = max(1, atoi(argv[++i]));
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.tcpAddress.empty() && options.unixPath.empty()) options.tcpAddress = "127.0.0.1:7777";
+
+    Socket::raiseDescriptorLimit();
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    vector<Bot> bots(options.sessions);
+
+    // epoll data packs (bot index, role) so lookups need no map
+    for (int b = 0; b < options.sessions; b++) {
+        Bot& bot = bots[b];
+        bot.roundsLeft = options.rounds;
+        for (int role = 0; role < 3; role++) {
+            int fd = connectTo(options);
+            if (fd < 0) {
+                cerr << "Connection " << (b * 3 + role) << " failed; is dispatch_server running?\n";
+                return 1;
+            }
+            bot.fds[role] = fd;
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = (static_cast<uint64_t>(b) << 2) | static_cast<uint64_t>(role);
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    auto start = steady_clock::now();
+    for (Bot& bot : bots) {
+        writeLine(bot.fds[static_cast<size_t>(Role::DISPATCHER)], Protocol::format("CREATE", options.difficulty));
+    }
+
+    Totals totals;
+    int remaining = options.sessions;
+    auto deadline = start + seconds(options.timeoutSeconds);
+    vector<epoll_event> events(1024);
+    char buffer[16384];
+    string line;
+
+    while (remaining > 0 && steady_clock::now() < deadline) {
+        int count = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 100);
+        if (count < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < count; i++) {
+            Bot& bot = bots[events[i].data.u64 >> 2];
+            Role role = static_cast<Role>(events[i].data.u64 & 3);
+            size_t slot = static_cast<size_t>(role);
+
+            ssize_t received = ::read(bot.fds[slot], buffer, sizeof(buffer));
+            if (received <= 0) {
+                if (received == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, bot.fds[slot], nullptr);
+                    if (!bot.finished) {
+                        bot.finished = true;
+                        remaining--;
+                        totals.errors++;
+                    }
+                }
+                continue;
+            }
+
+            bot.inputs[slot].append(buffer, static_cast<size_t>(received));
+            bool wasFinished = bot.finished;
+            while (bot.inputs[slot].nextLine(line)) {
+                handleLine(bot, role, line, options, totals);
+            }
+            if (bot.finished && !wasFinished) remaining--;
+        }
+    }
+
+    double elapsed = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    for (Bot& bot : bots) {
+        for (int fd : bot.fds) Socket::closeQuietly(fd);
+    }
+    Socket::closeQuietly(epollFd);
+
+    cout << fixed << setprecision(1);
+    cout << "sessions      " << options.sessions << " x " << options.rounds << " rounds"
+         << (remaining > 0 ? "  (" + to_string(remaining) + " timed out)" : string()) << "\n";
+    cout << "games         " << totals.games << "  (" << totals.perfect << " perfect, mean score "
+         << totals.scores.getMean() << ")\n";
+    cout << "turns         " << totals.turns << " in " << elapsed << "s  = "
+         << (elapsed > 0 ? totals.turns / elapsed : 0.0) << " turns/s\n";
+    cout << "turn latency  p50 " << totals.latencyMicros.percentile(50) << "us  p90 "
+         << totals.latencyMicros.percentile(90) << "us  p99 " << totals.latencyMicros.percentile(99)
+         << "us  max " << totals.latencyMicros.percentile(100) << "us\n";
+    cout << "errors        " << totals.errors << "\n";
+    return remaining > 0 ? 2 : 0;
+}
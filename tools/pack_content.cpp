@@ -0,0 +1,275 @@
+#include "../data/ContentPack.h"
+#include "../game/EpisodeManager.h"
+#include "../ui/CutsceneManager.h"
+#include "../utils/Utilities.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <climits>
+
+using namespace std;
+
+// Writes content.pack: the built-in episodes and cutscenes, then anything in
+// the source files given, which replaces built-ins with the same number or key.
+// Giving a number or key twice across the sources is an error.
+//
+//   dispatch_pack [-o content.pack] [source.txt ...]
+//
+// Source files hold blocks closed by "end"; '#' lines are comments:
+//
+//   episode 4                        cutscene episode4_intro
+//   title Night Shift                title EPISODE 4 - NIGHT SHIFT
+//   description Two crews.           delay 60
+//   difficulty hard                  lines
+//   skill 40                         Text shown one line at a time,
+//   unlocked no                      blank lines included.
+//   pattern ABCD ABCD DCBA DCBA      end
+//   end
+
+namespace {
+
+struct Content {
+    map<int, PackedEpisode> episodes;
+    map<string, PackedCutscene> cutscenes;
+    deque<string> text; // Owns what the packed views point at
+    set<int> sourcedEpisodes; // Read from source files so far
+    set<string> sourcedCutscenes;
+};
+
+string_view keep(Content& content, string text) {
+    content.text.push_back(move(text));
+    return content.text.back();
+}
+
+bool parseDifficulty(const string& text, Difficulty& difficulty) {
+    string name = Utilities::toLower(text);
+    if (name == "training") difficulty = Difficulty::TRAINING;
+    else if (name == "normal") difficulty = Difficulty::NORMAL;
+    else if (name == "hard") difficulty = Difficulty::HARD;
+    else if (name == "expert") difficulty = Difficulty::EXPERT;
+    else return false;
+    return true;
+}
+
+void addBuiltIns(Content& content) {
+    ContentPack none; // Never opened, so the manager falls back to its built-in set
+    EpisodeManager episodes(none);
+    for (const Episode* episode : episodes.getEpisodesInSkillRange(INT_MIN, INT_MAX)) {
+        string pattern;
+        for (int row = 0; row < episode->pattern.getSize(); row++) {
+            for (int col = 0; col < episode->pattern.getSize(); col++) {
+                pattern += episode->pattern.getCell(row, col);
+            }
+        }
+
+        PackedEpisode packed;
+        packed.number = episode->number;
+        packed.title = keep(content, episode->title);
+        packed.description = keep(content, episode->description);
+        packed.pattern = keep(content, pattern);
+        packed.gridSize = episode->pattern.getSize();
+        packed.recommendedDifficulty = episode->recommendedDifficulty;
+        packed.unlocked = episode->unlocked;
+        packed.requiredSkillPoints = episode->requiredSkillPoints;
+        content.episodes[packed.number] = packed;
+    }
+
+    for (const string& key : CutsceneManager::getBuiltInKeys()) {
+        Cutscene cutscene;
+        if (!CutsceneManager::getBuiltIn(key, cutscene)) continue;
+
+        PackedCutscene packed;
+        packed.key = keep(content, key);
+        packed.title = keep(content, cutscene.title);
+        packed.lines = keep(content, Utilities::join(cutscene.lines, "\n"));
+        packed.lineDelayMs = cutscene.lineDelayMs;
+        content.cutscenes[key] = packed;
+    }
+}
+
+class SourceReader {
+public:
+    SourceReader(const string& path, Content& content) : path(path), content(content), lineNumber(0) {}
+
+    bool read() {
+        ifstream in(path);
+        if (!in) return fail("cannot open");
+
+        string line;
+        while (next(in, line)) {
+            string trimmed = Utilities::trim(line);
+            if (trimmed.empty() || trimmed[0] == '#') continue;
+
+            string keyword;
+            string value;
+            split(trimmed, keyword, value);
+            if (keyword == "episode") {
+                if (!readEpisode(in, value)) return false;
+            } else if (keyword == "cutscene") {
+                if (!readCutscene(in, value)) return false;
+            } else {
+                return fail("expected 'episode' or 'cutscene', got '" + keyword + "'");
+            }
+        }
+        return true;
+    }
+
+private:
+    string path;
+    Content& content;
+    int lineNumber;
+
+    bool next(istream& in, string& line) {
+        if (!getline(in, line)) return false;
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return true;
+    }
+
+    static void split(const string& line, string& keyword, string& value) {
+        size_t space = line.find(' ');
+        keyword = Utilities::toLower(line.substr(0, space));
+        value = space == string::npos ? "" : Utilities::trim(line.substr(space + 1));
+    }
+
+    bool fail(const string& message) {
+        cerr << path;
+        if (lineNumber > 0) cerr << ":" << lineNumber;
+        cerr << ": " << message << "\n";
+        return false;
+    }
+
+    bool readEpisode(istream& in, const string& number) {
+        PackedEpisode episode;
+        if (!Utilities::parseInt(number, episode.number)) return fail("bad episode number '" + number + "'");
+
+        string line;
+        while (next(in, line)) {
+            string trimmed = Utilities::trim(line);
+            if (trimmed.empty() || trimmed[0] == '#') continue;
+
+            string keyword;
+            string value;
+            split(trimmed, keyword, value);
+            if (keyword == "end") {
+                if (episode.gridSize == 0) return fail("episode " + number + " has no pattern");
+                if (!content.sourcedEpisodes.insert(episode.number).second) {
+                    return fail("episode " + number + " is defined twice");
+                }
+                content.episodes[episode.number] = episode;
+                return true;
+            } else if (keyword == "title") {
+                episode.title = keep(content, value);
+            } else if (keyword == "description") {
+                episode.description = keep(content, value);
+            } else if (keyword == "difficulty") {
+                if (!parseDifficulty(value, episode.recommendedDifficulty)) return fail("bad difficulty '" + value + "'");
+            } else if (keyword == "skill") {
+                if (!Utilities::parseInt(value, episode.requiredSkillPoints)) return fail("bad skill '" + value + "'");
+            } else if (keyword == "unlocked") {
+                episode.unlocked = Utilities::toLower(value) == "yes";
+            } else if (keyword == "pattern") {
+                vector<string> rows;
+                for (const string& row : Utilities::split(Utilities::toUpper(value), ' ')) {
+                    if (!row.empty()) rows.push_back(row);
+                }
+                string cells;
+                for (const string& row : rows) {
+                    if (row.size() != rows.size()) return fail("pattern must be square");
+                    cells += row;
+                }
+                if (rows.empty()) return fail("empty pattern");
+                episode.pattern = keep(content, cells);
+                episode.gridSize = static_cast<int>(rows.size());
+            } else {
+                return fail("unknown episode field '" + keyword + "'");
+            }
+        }
+        return fail("episode " + number + " is missing 'end'");
+    }
+
+    bool readCutscene(istream& in, const string& key) {
+        if (key.empty()) return fail("cutscene needs a key");
+
+        PackedCutscene cutscene;
+        cutscene.key = keep(content, key);
+
+        string line;
+        while (next(in, line)) {
+            string trimmed = Utilities::trim(line);
+            if (trimmed.empty() || trimmed[0] == '#') continue;
+
+            string keyword;
+            string value;
+            split(trimmed, keyword, value);
+            if (keyword == "end") {
+                return fail("cutscene " + key + " has no lines");
+            } else if (keyword == "title") {
+                cutscene.title = keep(content, value);
+            } else if (keyword == "delay") {
+                if (!Utilities::parseInt(value, cutscene.lineDelayMs)) return fail("bad delay '" + value + "'");
+            } else if (keyword == "lines") {
+                // Verbatim up to "end", which also closes the cutscene
+                vector<string> lines;
+                while (next(in, line) && Utilities::trim(line) != "end") {
+                    lines.push_back(line);
+                }
+                cutscene.lines = keep(content, Utilities::join(lines, "\n"));
+                if (!content.sourcedCutscenes.insert(key).second) return fail("cutscene " + key + " is defined twice");
+                content.cutscenes[key] = cutscene;
+                return true;
+            } else {
+                return fail("unknown cutscene field '" + keyword + "'");
+            }
+        }
+        return fail("cutscene " + key + " is missing 'end'");
+    }
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    string output = "content.pack";
+    vector<string> sources;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            cout << "Usage: " << argv[0] << " [-o content.pack] [source.txt ...]\n";
+            return 0;
+        } else {
+            sources.push_back(arg);
+        }
+    }
+
+    Content content;
+    addBuiltIns(content);
+    for (const string& source : sources) {
+        if (!SourceReader(source, content).read()) return 1;
+    }
+
+    vector<PackedEpisode> episodes;
+    for (const auto& entry : content.episodes) episodes.push_back(entry.second);
+    vector<PackedCutscene> cutscenes;
+    for (const auto& entry : content.cutscenes) cutscenes.push_back(entry.second);
+
+    if (!ContentPack::write(output, episodes, cutscenes)) {
+        cerr << "Failed to write " << output << "\n";
+        return 1;
+    }
+
+    // Read it back the way the game will
+    ContentPack pack;
+    if (!pack.open(output)) {
+        cerr << output << ": " << pack.getLastError() << "\n";
+        return 1;
+    }
+    cout << "Wrote " << output << ": " << pack.getEpisodeCount() << " episodes, "
+         << pack.getCutsceneCount() << " cutscenes\n";
+    return 0;
+}
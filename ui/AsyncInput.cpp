@@ -0,0 +1,153 @@
+#include "AsyncInput.h"
+#include "TerminalRenderer.h"
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+ConsoleInput::ConsoleInput(EventLoop& loop, int fd)
+    : loop(loop), fd(fd), blocking(true), watching(false), closed(false), timer(EventLoop::INVALID_TIMER) {
+#ifndef _WIN32
+    // Piped stdin is read ahead by cin's buffers, where poll can't see it
+    // and timeouts mean little anyway, so it stays on getline
+    blocking = fd == STDIN_FILENO && !isatty(fd);
+#endif
+}
+
+ConsoleInput::~ConsoleInput() {
+    cancel();
+}
+
+void ConsoleInput::requestLine(const string& prompt, int64_t timeoutMs, Handler handler) {
+    cancel();
+    cout << prompt << flush;
+    pending = move(handler);
+
+    if (blocking) {
+        loop.post([this]() {
+            if (!pending) return;
+            string line;
+            if (getline(cin, line)) {
+                complete(InputStatus::LINE, line);
+            } else {
+                complete(InputStatus::CLOSED, "");
+            }
+        });
+        return;
+    }
+
+    if (timeoutMs > 0) {
+        timer = loop.addTimer(timeoutMs, [this]() {
+            timer = EventLoop::INVALID_TIMER;
+            cout << "\n";
+            complete(InputStatus::TIMEOUT, "");
+        });
+    }
+
+    if (!lines.empty() || closed) {
+        loop.post([this]() { deliver(); });
+    } else {
+        // Only watched while a request waits, so an idle loop can return
+        watching = loop.watchReadable(fd, [this]() { onReadable(); });
+    }
+}
+
+void ConsoleInput::cancel() {
+    loop.cancelTimer(timer);
+    timer = EventLoop::INVALID_TIMER;
+    if (watching) loop.unwatch(fd);
+    watching = false;
+    pending = nullptr;
+}
+
+void ConsoleInput::onReadable() {
+#ifndef _WIN32
+    char buffer[4096];
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    if (count <= 0) {
+        closed = true;
+    } else {
+        partial.append(buffer, static_cast<size_t>(count));
+    }
+#endif
+
+    size_t newline;
+    while ((newline = partial.find('\n')) != string::npos) {
+        string line = partial.substr(0, newline);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        lines.push_back(move(line));
+        partial.erase(0, newline + 1);
+    }
+    if (closed && !partial.empty()) {
+        lines.push_back(move(partial));
+        partial.clear();
+    }
+
+    deliver();
+}
+
+void ConsoleInput::deliver() {
+    if (!pending) return;
+    if (!lines.empty()) {
+        string line = move(lines.front());
+        lines.pop_front();
+        TerminalRenderer::noteEcho(line + "\n");
+        complete(InputStatus::LINE, line);
+    } else if (closed) {
+        complete(InputStatus::CLOSED, "");
+    }
+}
+
+void ConsoleInput::complete(InputStatus status, const string& line) {
+    if (!pending) return;
+    Handler handler = move(pending);
+    cancel();
+    handler(status, line);
+}
+
+ScriptedInput::ScriptedInput(EventLoop& loop, vector<string> script, int64_t delayMs)
+    : loop(loop), script(move(script)), next(0), delayMs(delayMs),
+      replyTimer(EventLoop::INVALID_TIMER), timeoutTimer(EventLoop::INVALID_TIMER) {}
+
+ScriptedInput::~ScriptedInput() {
+    cancel();
+}
+
+void ScriptedInput::requestLine(const string& prompt, int64_t timeoutMs, Handler handler) {
+    (void)prompt;
+    cancel();
+
+    if (next >= script.size()) {
+        replyTimer = loop.addTimer(0, [this, handler]() {
+            replyTimer = EventLoop::INVALID_TIMER;
+            finish(InputStatus::CLOSED, "", handler);
+        });
+        return;
+    }
+
+    // A reply that misses the deadline isn't consumed; the next request gets it
+    replyTimer = loop.addTimer(delayMs, [this, handler]() {
+        replyTimer = EventLoop::INVALID_TIMER;
+        finish(InputStatus::LINE, script[next++], handler);
+    });
+    if (timeoutMs > 0) {
+        timeoutTimer = loop.addTimer(timeoutMs, [this, handler]() {
+            timeoutTimer = EventLoop::INVALID_TIMER;
+            finish(InputStatus::TIMEOUT, "", handler);
+        });
+    }
+}
+
+void ScriptedInput::cancel() {
+    loop.cancelTimer(replyTimer);
+    loop.cancelTimer(timeoutTimer);
+    replyTimer = timeoutTimer = EventLoop::INVALID_TIMER;
+}
+
+void ScriptedInput::finish(InputStatus status, const string& line, Handler handler) {
+    cancel();
+    handler(status, line);
+}
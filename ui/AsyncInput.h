@@ -0,0 +1,73 @@
+#pragma once
+#include "../utils/EventLoop.h"
+#include <functional>
+#include <string>
+#include <vector>
+#include <deque>
+
+enum class InputStatus {
+    LINE,
+    TIMEOUT,
+    CLOSED
+};
+
+// Non-blocking counterpart of ConsoleUI::getInput: a request returns at
+// once and its handler runs later on the EventLoop, with the line, a
+// timeout or end of input. One request may be outstanding at a time.
+class InputSource {
+public:
+    using Handler = std::function<void(InputStatus status, const std::string& line)>;
+
+    virtual ~InputSource() = default;
+
+    // timeoutMs <= 0 waits indefinitely
+    virtual void requestLine(const std::string& prompt, int64_t timeoutMs, Handler handler) = 0;
+    virtual void cancel() = 0;
+};
+
+// Lines typed on a file descriptor (stdin by default). Extra lines read
+// along with the requested one are kept for the next request.
+class ConsoleInput : public InputSource {
+public:
+    explicit ConsoleInput(EventLoop& loop, int fd = 0);
+    ~ConsoleInput() override;
+
+    void requestLine(const std::string& prompt, int64_t timeoutMs, Handler handler) override;
+    void cancel() override;
+
+private:
+    EventLoop& loop;
+    int fd;
+    bool blocking;
+    bool watching;
+    bool closed;
+    std::string partial;
+    std::deque<std::string> lines;
+    Handler pending;
+    EventLoop::TimerId timer;
+
+    void onReadable();
+    void deliver();
+    void complete(InputStatus status, const std::string& line);
+};
+
+// Replays canned lines, each after a fixed delay - for headless games and
+// for running many games against one loop
+class ScriptedInput : public InputSource {
+public:
+    ScriptedInput(EventLoop& loop, std::vector<std::string> script, int64_t delayMs = 0);
+    ~ScriptedInput() override;
+
+    void requestLine(const std::string& prompt, int64_t timeoutMs, Handler handler) override;
+    void cancel() override;
+
+private:
+    EventLoop& loop;
+    std::vector<std::string> script;
+    size_t next;
+    int64_t delayMs;
+    EventLoop::TimerId replyTimer;
+    EventLoop::TimerId timeoutTimer;
+
+    void finish(InputStatus status, const std::string& line, Handler handler);
+};
@@ -1,8 +1,9 @@
 #include "ConsoleUI.h"
+#include "TerminalRenderer.h"
+#include "TextAnimator.h"
+#include "../utils/Trace.h"
 #include <iostream>
 #include <iomanip>
-#include <thread>
-#include <chrono>
 #include <limits>
 
 using namespace std;
@@ -10,14 +11,18 @@ using namespace std;
 bool ConsoleUI::colorsEnabled = true;
 
 void ConsoleUI::clearScreen() {
+    TRACE_SCOPE("ConsoleUI::clearScreen");
 #ifdef _WIN32
     system("cls");
 #else
-    system("clear");
+    // The renderer diffs the next frame against this one; when stdout isn't
+    // a terminal there is nothing to clear
+    TerminalRenderer::newFrame();
 #endif
 }
 
 void ConsoleUI::showTitle(const std::string& title) {
+    TRACE_SCOPE("ConsoleUI::showTitle");
     cout << "\n" << string(60, '=') << "\n";
     showCentered(title);
     cout << string(60, '=') << "\n\n";
@@ -34,6 +39,7 @@ void ConsoleUI::showCentered(const std::string& text) {
 }
 
 void ConsoleUI::showGrid(const std::string& gridDisplay) {
+    TRACE_SCOPE("ConsoleUI::showGrid");
     cout << "\n";
     stringstream ss(gridDisplay);
     string line;
@@ -45,24 +51,19 @@ void ConsoleUI::showGrid(const std::string& gridDisplay) {
 }
 
 void ConsoleUI::showMessage(const std::string& role, const std::string& message) {
+    TRACE_SCOPE("ConsoleUI::showMessage");
     string formattedRole = role + ":";
     cout << left << setw(12) << formattedRole << " " << message << "\n";
 }
 
 void ConsoleUI::slowPrint(const std::string& text, int delayMs) {
-    for (char c : text) {
-        cout << c << flush;
-        this_thread::sleep_for(chrono::milliseconds(delayMs));
-    }
+    TextAnimator::play(text, delayMs);
     cout << endl;
 }
 
 void ConsoleUI::typewriterEffect(const std::string& text, int delayMs) {
     cout << "> ";
-    for (char c : text) {
-        cout << c << flush;
-        this_thread::sleep_for(chrono::milliseconds(delayMs));
-    }
+    TextAnimator::play(text, delayMs);
     cout << "\n\n";
 }
 
@@ -83,6 +84,7 @@ std::string ConsoleUI::getInput(const std::string& prompt) {
     string input;
     cout << prompt;
     getline(cin, input);
+    TerminalRenderer::noteEcho(input + "\n");
     return input;
 }
 
@@ -112,6 +114,7 @@ bool ConsoleUI::getConfirmation(const std::string& prompt) {
 }
 
 void ConsoleUI::showStats(const std::vector<std::pair<std::string, std::string>>& stats) {
+    TRACE_SCOPE("ConsoleUI::showStats");
     cout << "\n" << string(40, '-') << "\n";
     cout << "STATISTICS:\n";
     cout << string(40, '-') << "\n";
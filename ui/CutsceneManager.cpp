@@ -1,138 +1,150 @@
 #include "CutsceneManager.h"
 #include "ConsoleUI.h"
-#include "../utils/Utilities.h"
+#include "TextAnimator.h"
+#include "../data/ContentPack.h"
 #include <iostream>
-#include <thread>
 
 using namespace std;
 
 void CutsceneManager::playEpisode1Intro() {
     ConsoleUI::clearScreen();
-    
-    Cutscene intro;
-    intro.title = "EPISODE 1 - THE FIRST JOB";
-    intro.lineDelayMs = 60;
-    intro.lines = {
-        "🌆 INTRO CUTSCENE (TEXT)",
-        "",
-        "You arrive at Clearline Dispatch, a small logistics office",
-        "with flickering lights, humming servers, and stacks of",
-        "half-finished paperwork.",
-        "",
-        "A tired supervisor looks up from her desk.",
-        "",
-        "Supervisor Mara: \"You must be the new Dispatcher.",
-        "We're short-staffed, so you're starting right now.",
-        "Your first task is simple: guide our warehouse team",
-        "through a basic layout job.\"",
-        "",
-        "She hands you a clipboard with a 4×4 layout pattern",
-        "printed on faded paper.",
-        "",
-        "Mara: \"You'll give instructions to the Messenger.",
-        "The Messenger will relay it to the Builder.",
-        "The Builder will recreate the pattern.",
-        "None of you can see each other's info.",
-        "If the reconstruction is correct, you pass your first day.\"",
-        "",
-        "She leans back:",
-        "",
-        "Mara: \"Welcome to dispatch.\"",
-        "",
-        "Fade to black..."
-    };
-    
-    playCutscene(intro);
+    play("episode1_intro");
 }
 
 void CutsceneManager::playEpisode1Outro(bool success) {
     ConsoleUI::clearScreen();
+    play(success ? "episode1_outro_success" : "episode1_outro_failure");
+}
+
+void CutsceneManager::playGameOver() {
+    ConsoleUI::clearScreen();
+    play("game_over");
+}
+
+void CutsceneManager::playVictory() {
+    ConsoleUI::clearScreen();
+    play("victory");
+}
+
+vector<string> CutsceneManager::getBuiltInKeys() {
+    return {"episode1_intro", "episode1_outro_success", "episode1_outro_failure", "game_over", "victory"};
+}
+
+bool CutsceneManager::getBuiltIn(const string& key, Cutscene& out) {
+    if (key == "episode1_intro") {
+        out.title = "EPISODE 1 - THE FIRST JOB";
+        out.lineDelayMs = 60;
+        out.lines = {
+            "🌆 INTRO CUTSCENE (TEXT)",
+            "",
+            "You arrive at Clearline Dispatch, a small logistics office",
+            "with flickering lights, humming servers, and stacks of",
+            "half-finished paperwork.",
+            "",
+            "A tired supervisor looks up from her desk.",
+            "",
+            "Supervisor Mara: \"You must be the new Dispatcher.",
+            "We're short-staffed, so you're starting right now.",
+            "Your first task is simple: guide our warehouse team",
+            "through a basic layout job.\"",
+            "",
+            "She hands you a clipboard with a 4×4 layout pattern",
+            "printed on faded paper.",
+            "",
+            "Mara: \"You'll give instructions to the Messenger.",
+            "The Messenger will relay it to the Builder.",
+            "The Builder will recreate the pattern.",
+            "None of you can see each other's info.",
+            "If the reconstruction is correct, you pass your first day.\"",
+            "",
+            "She leans back:",
+            "",
+            "Mara: \"Welcome to dispatch.\"",
+            "",
+            "Fade to black..."
+        };
+        return true;
+    }
     
-    Cutscene outro;
-    outro.title = "MISSION COMPLETE";
-    outro.lineDelayMs = 50;
+    if (key == "episode1_outro_success" || key == "episode1_outro_failure") {
+        out.title = "MISSION COMPLETE";
+        out.lineDelayMs = 50;
+        
+        if (key == "episode1_outro_success") {
+            out.lines = {
+                "Supervisor Mara reviews the final layout...",
+                "",
+                "Mara: \"Not bad, Dispatcher.",
+                "You handled your first transmission cleanly.",
+                "The team built the layout perfectly.",
+                "Let's see if you survive the next shift.\"",
+                "",
+                "✅ EPISODE COMPLETE",
+                "",
+                "You've passed your first day at Clearline Dispatch."
+            };
+        } else {
+            out.lines = {
+                "Supervisor Mara reviews the final layout...",
+                "",
+                "Mara: \"Close, but not enough.",
+                "Breakdown was either in your instructions or",
+                "the Messenger's relay.",
+                "Review your communication.",
+                "Precision saves time — and money.\"",
+                "",
+                "❌ PATTERN MISMATCH",
+                "",
+                "The team will need to try again tomorrow."
+            };
+        }
+        return true;
+    }
     
-    if (success) {
-        outro.lines = {
-            "Supervisor Mara reviews the final layout...",
+    if (key == "game_over") {
+        out.title = "TRANSMISSION FAILED";
+        out.lineDelayMs = 70;
+        out.lines = {
+            "The communication channel has degraded beyond recovery.",
             "",
-            "Mara: \"Not bad, Dispatcher.",
-            "You handled your first transmission cleanly.",
-            "The team built the layout perfectly.",
-            "Let's see if you survive the next shift.\"",
+            "Static fills your headset...",
             "",
-            "✅ EPISODE COMPLETE",
+            "Mara: \"We're losing them! The connection is—\"",
             "",
-            "You've passed your first day at Clearline Dispatch."
+            "[SIGNAL LOST]",
+            "",
+            "The dispatch terminal goes dark.",
+            "",
+            "Your first assignment ends in failure.",
+            "Better luck next time, Dispatcher."
         };
-    } else {
-        outro.lines = {
-            "Supervisor Mara reviews the final layout...",
+        return true;
+    }
+    
+    if (key == "victory") {
+        out.title = "MISSION ACCOMPLISHED";
+        out.lineDelayMs = 40;
+        out.lines = {
+            "🎉 TRANSMISSION SUCCESSFUL!",
+            "",
+            "The pattern matches perfectly.",
+            "Warehouse reports layout construction complete.",
             "",
-            "Mara: \"Close, but not enough.",
-            "Breakdown was either in your instructions or",
-            "the Messenger's relay.",
-            "Review your communication.",
-            "Precision saves time — and money.\"",
+            "Mara: \"Outstanding work, Dispatcher!",
+            "Your clear communication under pressure",
+            "saved this operation.",
             "",
-            "❌ PATTERN MISMATCH",
+            "The company is promoting you to Senior Dispatcher.",
+            "You'll be handling more complex patterns",
+            "and higher-stakes missions from now on.\"",
             "",
-            "The team will need to try again tomorrow."
+            "Congratulations! You've mastered the art of",
+            "clear communication under constraints."
         };
+        return true;
     }
     
-    playCutscene(outro);
-}
-
-void CutsceneManager::playGameOver() {
-    ConsoleUI::clearScreen();
-    
-    Cutscene gameOver;
-    gameOver.title = "TRANSMISSION FAILED";
-    gameOver.lineDelayMs = 70;
-    gameOver.lines = {
-        "The communication channel has degraded beyond recovery.",
-        "",
-        "Static fills your headset...",
-        "",
-        "Mara: \"We're losing them! The connection is—\"",
-        "",
-        "[SIGNAL LOST]",
-        "",
-        "The dispatch terminal goes dark.",
-        "",
-        "Your first assignment ends in failure.",
-        "Better luck next time, Dispatcher."
-    };
-    
-    playCutscene(gameOver);
-}
-
-void CutsceneManager::playVictory() {
-    ConsoleUI::clearScreen();
-    
-    Cutscene victory;
-    victory.title = "MISSION ACCOMPLISHED";
-    victory.lineDelayMs = 40;
-    victory.lines = {
-        "🎉 TRANSMISSION SUCCESSFUL!",
-        "",
-        "The pattern matches perfectly.",
-        "Warehouse reports layout construction complete.",
-        "",
-        "Mara: \"Outstanding work, Dispatcher!",
-        "Your clear communication under pressure",
-        "saved this operation.",
-        "",
-        "The company is promoting you to Senior Dispatcher.",
-        "You'll be handling more complex patterns",
-        "and higher-stakes missions from now on.\"",
-        "",
-        "Congratulations! You've mastered the art of",
-        "clear communication under constraints."
-    };
-    
-    playCutscene(victory);
+    return false;
 }
 
 void CutsceneManager::showSupervisorMessage(const string& message, bool isUrgent) {
@@ -144,23 +156,27 @@ void CutsceneManager::showSupervisorMessage(const string& message, bool isUrgent
         ConsoleUI::showTitle("📞 SUPERVISOR UPDATE");
     }
     
+    TextAnimator::beginSequence();
     ConsoleUI::typewriterEffect("Mara: \"" + message + "\"", 40);
     
-    Utilities::sleep(2000);
+    pause(2000);
+    TextAnimator::endSequence();
 }
 
 void CutsceneManager::showTransmissionEffect() {
     cout << "\n";
+    TextAnimator::beginSequence();
     ConsoleUI::slowPrint("📡 ESTABLISHING TRANSMISSION...", 30);
     
     for (int i = 0; i < 3; i++) {
         cout << "🔊 " << string(20 + i * 5, '.') << " CONNECTED" << endl;
-        Utilities::sleep(500);
+        pause(500);
     }
     
     cout << "\n";
     ConsoleUI::slowPrint("✅ CHANNEL SECURE - BEGIN TRANSMISSION", 20);
     cout << "\n";
+    TextAnimator::endSequence();
 }
 
 void CutsceneManager::showLoadingScreen(const string& operation) {
@@ -171,27 +187,60 @@ void CutsceneManager::showLoadingScreen(const string& operation) {
     
     for (int i = 0; i <= 10; i++) {
         ConsoleUI::progressBar(i, 10, 30);
-        Utilities::sleep(100);
+        pause(100);
     }
     
     cout << "\n\n";
 }
 
+void CutsceneManager::play(const string& key) {
+    if (playFromPack(key)) return;
+    
+    Cutscene cutscene;
+    if (getBuiltIn(key, cutscene)) {
+        playCutscene(cutscene);
+    }
+}
+
+bool CutsceneManager::playFromPack(const string& key) {
+    PackedCutscene packed;
+    if (!ContentPack::getDefault().findCutscene(key, packed)) {
+        return false;
+    }
+    
+    Cutscene cutscene;
+    cutscene.title = string(packed.title);
+    cutscene.lineDelayMs = packed.lineDelayMs;
+    size_t start = 0;
+    while (start <= packed.lines.size()) {
+        size_t end = packed.lines.find('\n', start);
+        if (end == string_view::npos) end = packed.lines.size();
+        cutscene.lines.emplace_back(packed.lines.substr(start, end - start));
+        start = end + 1;
+    }
+    
+    playCutscene(cutscene);
+    return true;
+}
+
 void CutsceneManager::playCutscene(const Cutscene& cutscene) {
     ConsoleUI::clearScreen();
     ConsoleUI::showTitle(cutscene.title);
     
+    // Any key skips to the end of the cutscene
+    TextAnimator::beginSequence();
     for (const auto& line : cutscene.lines) {
         if (line.empty()) {
             cout << "\n";
-            Utilities::sleep(cutscene.lineDelayMs * 3);
+            pause(cutscene.lineDelayMs * 3);
         } else {
             typewriterWithEffects(line, cutscene.lineDelayMs);
         }
     }
     
     cout << "\n";
-    Utilities::sleep(2000);
+    pause(2000);
+    TextAnimator::endSequence();
 }
 
 void CutsceneManager::typewriterWithEffects(const string& text, int delayMs) {
@@ -205,5 +254,5 @@ void CutsceneManager::typewriterWithEffects(const string& text, int delayMs) {
 }
 
 void CutsceneManager::pause(int milliseconds) {
-    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+    TextAnimator::wait(milliseconds);
 }
\ No newline at end of file
@@ -19,7 +19,13 @@ public:
     static void showTransmissionEffect();
     static void showLoadingScreen(const std::string& operation);
     
+    // Text compiled into the game, used when the content pack lacks a key
+    static std::vector<std::string> getBuiltInKeys();
+    static bool getBuiltIn(const std::string& key, Cutscene& out);
+    
 private:
+    static void play(const std::string& key);
+    static bool playFromPack(const std::string& key); // False if the pack has no such cutscene
     static void playCutscene(const Cutscene& cutscene);
     static void typewriterWithEffects(const std::string& text, int delayMs = 50);
     static void pause(int milliseconds);
@@ -0,0 +1,258 @@
+#include "TerminalRenderer.h"
+#include "../utils/Trace.h"
+#include <iostream>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
+using namespace std;
+
+TerminalRenderer* TerminalRenderer::active = nullptr;
+
+TerminalRenderer::TerminalRenderer(streambuf* original)
+    : original(original), frame(1), cursorCol(0), anchored(false), needsClear(false) {}
+
+bool TerminalRenderer::install() {
+#ifdef _WIN32
+    return false;
+#else
+    if (active || !isatty(STDOUT_FILENO)) return false;
+
+    cout.flush();
+    active = new TerminalRenderer(cout.rdbuf());
+    cout.rdbuf(active);
+    atexit(uninstall);
+    return true;
+#endif
+}
+
+void TerminalRenderer::uninstall() {
+    if (!active) return;
+
+    present();
+    cout.rdbuf(active->original);
+    delete active;
+    active = nullptr;
+}
+
+void TerminalRenderer::newFrame() {
+    if (!active) return;
+
+    active->frame.assign(1, string());
+    active->cursorCol = 0;
+    active->pendingRaw.clear();
+    if (!active->anchored) {
+        // Coming from scrolled output; the screen no longer matches any frame
+        active->needsClear = true;
+        active->displayed.clear();
+        active->anchored = true;
+    }
+}
+
+void TerminalRenderer::present() {
+    if (!active) return;
+    active->presentFrame();
+}
+
+void TerminalRenderer::noteEcho(const string& text) {
+#ifndef _WIN32
+    if (!active || !isatty(STDIN_FILENO)) return;
+#else
+    if (!active) return;
+#endif
+
+    for (char c : text) {
+        active->putChar(c);
+    }
+    active->pendingRaw.clear();
+    if (active->anchored) {
+        active->displayed = active->frame;
+    }
+}
+
+TerminalRenderer::int_type TerminalRenderer::overflow(int_type ch) {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        putChar(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+}
+
+streamsize TerminalRenderer::xsputn(const char* s, streamsize count) {
+    for (streamsize i = 0; i < count; i++) {
+        putChar(s[i]);
+    }
+    return count;
+}
+
+int TerminalRenderer::sync() {
+    presentFrame();
+    return 0;
+}
+
+void TerminalRenderer::putChar(char c) {
+    pendingRaw += c;
+
+    if (c == '\n') {
+        frame.emplace_back();
+        cursorCol = 0;
+    } else if (c == '\r') {
+        cursorCol = 0;
+    } else {
+        string& line = frame.back();
+        if (cursorCol < line.size()) {
+            line[cursorCol] = c;
+        } else {
+            line += c;
+        }
+        cursorCol++;
+    }
+}
+
+void TerminalRenderer::presentFrame() {
+    TRACE_SCOPE("TerminalRenderer::present");
+    if (pendingRaw.empty() && !needsClear) return;
+
+    string out;
+
+    int columns = terminalColumns();
+    int frameRows = 0;
+    for (const string& line : frame) {
+        frameRows += screenRows(line, columns);
+    }
+
+    if (anchored && frameRows > terminalRows()) {
+        // Taller than the screen: redraw once, then stream until the next frame
+        out = "\033[H\033[2J";
+        for (size_t i = 0; i < frame.size(); i++) {
+            if (i > 0) out += "\r\n";
+            out += frame[i];
+        }
+        anchored = false;
+        needsClear = false;
+        displayed.clear();
+    } else if (!anchored) {
+        out = pendingRaw;
+    } else {
+        if (needsClear) {
+            out = "\033[H\033[2J";
+            needsClear = false;
+        }
+
+        // Lines wider than the terminal wrap onto several screen rows. Once a
+        // line's wrapped height changes, every row below it has moved, so the
+        // rest of the frame is rewritten rather than diffed
+        size_t lastRow = frame.size() - 1;
+        int screenRow = 0;
+        int displayedRows = 0;
+        bool shifted = false;
+        for (size_t row = 0; row < frame.size(); row++) {
+            const string& line = frame[row];
+            int height = screenRows(line, columns);
+            int top = screenRow;
+            screenRow += height;
+
+            bool known = !shifted && row < displayed.size();
+            if (known) {
+                int oldHeight = screenRows(displayed[row], columns);
+                displayedRows += oldHeight;
+                shifted = oldHeight != height;
+            }
+            if (known && displayed[row] == line && row != lastRow) continue;
+
+            // Rewrite from the first differing column when the shared prefix
+            // is plain ASCII and on the line's first screen row
+            size_t from = known ? min(asciiPrefix(displayed[row], line), static_cast<size_t>(columns - 1)) : 0;
+            out += "\033[" + to_string(top + 1) + ";" + to_string(from + 1) + "H";
+            out.append(line, from, string::npos);
+            // A line ending exactly at the right margin leaves the cursor on its
+            // last cell, where erasing would take that character with it
+            int width = displayWidth(line);
+            if (width == 0 || width % columns != 0) out += "\033[K";
+
+            if (row == lastRow && cursorCol < line.size()) {
+                int col = displayWidth(line.substr(0, cursorCol));
+                out += "\033[" + to_string(top + col / columns + 1) + ";" + to_string(col % columns + 1) + "H";
+            }
+        }
+        for (size_t row = frame.size(); !shifted && row < displayed.size(); row++) {
+            displayedRows += screenRows(displayed[row], columns);
+        }
+
+        if (shifted || displayedRows > screenRow) {
+            // Clear leftovers below the frame, then put the cursor back
+            out += "\0337\033[" + to_string(screenRow + 1) + ";1H\033[J\0338";
+        }
+        displayed = frame;
+    }
+
+    pendingRaw.clear();
+    writeAll(out);
+}
+
+int TerminalRenderer::terminalRows() const {
+#ifndef _WIN32
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0) {
+        return size.ws_row;
+    }
+#endif
+    return 24;
+}
+
+int TerminalRenderer::terminalColumns() const {
+#ifndef _WIN32
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+#endif
+    return 80;
+}
+
+int TerminalRenderer::displayWidth(const string& line) {
+    int width = 0;
+    for (size_t i = 0; i < line.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(line[i]);
+        if (c == '\033' && i + 1 < line.size() && line[i + 1] == '[') {
+            // Skip CSI sequences (colors) up to their final byte
+            i += 2;
+            while (i < line.size() && (line[i] < 0x40 || line[i] > 0x7E)) i++;
+        } else if (c >= 0xF0) {
+            width += 2; // Four-byte sequences are emoji, drawn two columns wide
+        } else if (c >= 0x20 && (c & 0xC0) != 0x80) {
+            width++;
+        }
+    }
+    return width;
+}
+
+int TerminalRenderer::screenRows(const string& line, int columns) {
+    int width = displayWidth(line);
+    return width == 0 ? 1 : (width + columns - 1) / columns;
+}
+
+size_t TerminalRenderer::asciiPrefix(const string& a, const string& b) {
+    size_t limit = min(a.size(), b.size());
+    size_t i = 0;
+    while (i < limit && a[i] == b[i] && a[i] >= 0x20 && a[i] < 0x7F) {
+        i++;
+    }
+    return i;
+}
+
+void TerminalRenderer::writeAll(const string& data) {
+#ifndef _WIN32
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(STDOUT_FILENO, data.data() + written, data.size() - written);
+        if (n <= 0) break;
+        written += static_cast<size_t>(n);
+    }
+#else
+    fwrite(data.data(), 1, data.size(), stdout);
+    fflush(stdout);
+#endif
+}
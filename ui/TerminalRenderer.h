@@ -0,0 +1,52 @@
+#pragma once
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Double-buffered renderer behind std::cout. Everything printed between two
+// clearScreen() calls is composed into an in-memory frame; on flush the frame
+// is diffed row by row against what the terminal already shows and only the
+// changed rows (or row tails) go out, as ANSI sequences in a single write().
+// Lines wider than the terminal are tracked by the screen rows they wrap onto.
+// Only installed when stdout is a terminal; otherwise cout is left alone.
+class TerminalRenderer : public std::streambuf {
+public:
+    static bool install();
+    static void uninstall();
+    static bool isActive() { return active != nullptr; }
+
+    // Start composing a new frame from the top-left corner
+    static void newFrame();
+    // Emit the difference between the composed frame and the screen
+    static void present();
+    // Record text the terminal has already echoed (typed input); no-op if
+    // stdin isn't a terminal, since nothing was echoed
+    static void noteEcho(const std::string& text);
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* s, std::streamsize count) override;
+    int sync() override;
+
+private:
+    TerminalRenderer(std::streambuf* original);
+
+    static TerminalRenderer* active;
+
+    std::streambuf* original;
+    std::vector<std::string> frame;     // Being composed
+    std::vector<std::string> displayed; // What the terminal shows
+    size_t cursorCol;                   // Byte offset into frame.back()
+    std::string pendingRaw;             // Bytes since the last present, for stream mode
+    bool anchored;                      // Frame starts at row 1 and fits on screen
+    bool needsClear;
+
+    void putChar(char c);
+    void presentFrame();
+    int terminalRows() const;
+    int terminalColumns() const;
+    static int displayWidth(const std::string& line);
+    static int screenRows(const std::string& line, int columns); // Rows after wrapping
+    static size_t asciiPrefix(const std::string& a, const std::string& b);
+    static void writeAll(const std::string& data);
+};
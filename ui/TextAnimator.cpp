@@ -0,0 +1,164 @@
+#include "TextAnimator.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#endif
+
+using namespace std;
+using namespace chrono;
+
+const int TextAnimator::FRAME_MS = 16;
+int TextAnimator::instantMode = -1;
+int TextAnimator::sequenceDepth = 0;
+bool TextAnimator::skipping = false;
+
+namespace {
+
+// Puts a terminal stdin into non-canonical, no-echo mode so single
+// keypresses can be read during an animation, and restores it afterwards
+class RawInputGuard {
+public:
+    RawInputGuard() : active(false) {
+#ifndef _WIN32
+        if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0) {
+            termios raw = saved;
+            raw.c_lflag &= ~(ICANON | ECHO);
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            active = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+        }
+#endif
+    }
+
+    ~RawInputGuard() {
+#ifndef _WIN32
+        if (active) tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+#endif
+    }
+
+    bool isActive() const { return active; }
+
+private:
+    bool active;
+#ifndef _WIN32
+    termios saved;
+#endif
+};
+
+}
+
+void TextAnimator::setInstant(bool instant) {
+    instantMode = instant ? 1 : 0;
+}
+
+bool TextAnimator::isInstant() {
+    if (instantMode < 0) {
+        const char* env = getenv("DISPATCH_INSTANT_TEXT");
+        bool instant = env && *env && strcmp(env, "0") != 0;
+#ifndef _WIN32
+        instant = instant || !isatty(STDOUT_FILENO);
+#endif
+        instantMode = instant ? 1 : 0;
+    }
+    return instantMode == 1;
+}
+
+bool TextAnimator::play(const string& text, int msPerChar) {
+    if (isInstant() || skipping || msPerChar <= 0) {
+        cout << text << flush;
+        return !skipping;
+    }
+
+    RawInputGuard guard;
+    auto start = steady_clock::now();
+    size_t shownBytes = 0;
+    size_t shownChars = 0;
+
+    while (shownBytes < text.size()) {
+        // Reveal every character that is due by now in one write
+        long long elapsed = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        size_t dueChars = static_cast<size_t>(elapsed / msPerChar) + 1;
+        if (dueChars > shownChars) {
+            size_t end = advanceChars(text, shownBytes, dueChars - shownChars);
+            cout.write(text.data() + shownBytes, end - shownBytes);
+            cout.flush();
+            shownChars = dueChars;
+            shownBytes = end;
+        }
+
+        if (shownBytes < text.size() && guard.isActive() && keyPressedWithin(FRAME_MS)) {
+            cout.write(text.data() + shownBytes, text.size() - shownBytes);
+            cout.flush();
+            return skip();
+        } else if (!guard.isActive()) {
+            this_thread::sleep_for(milliseconds(FRAME_MS));
+        }
+    }
+
+    return true;
+}
+
+bool TextAnimator::wait(int milliseconds) {
+    if (isInstant() || skipping || milliseconds <= 0) return !skipping;
+
+    RawInputGuard guard;
+    if (!guard.isActive()) {
+        this_thread::sleep_for(chrono::milliseconds(milliseconds));
+        return true;
+    }
+
+    return keyPressedWithin(milliseconds) ? skip() : true;
+}
+
+void TextAnimator::beginSequence() {
+    sequenceDepth++;
+}
+
+void TextAnimator::endSequence() {
+    if (sequenceDepth > 0 && --sequenceDepth == 0) {
+        skipping = false;
+    }
+}
+
+bool TextAnimator::keyPressedWithin(int milliseconds) {
+#ifndef _WIN32
+    pollfd input{STDIN_FILENO, POLLIN, 0};
+    if (poll(&input, 1, milliseconds) <= 0 || !(input.revents & POLLIN)) {
+        return false;
+    }
+
+    // Swallow the keypress(es) so they don't leak into the next prompt
+    char buffer[64];
+    while (read(STDIN_FILENO, buffer, sizeof(buffer)) > 0) {}
+    return true;
+#else
+    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+    return false;
+#endif
+}
+
+bool TextAnimator::skip() {
+    if (sequenceDepth > 0) {
+        skipping = true;
+    }
+    return false;
+}
+
+size_t TextAnimator::advanceChars(const string& text, size_t pos, size_t count) {
+    // Step over whole UTF-8 sequences so emoji are never split across writes
+    while (count > 0 && pos < text.size()) {
+        pos++;
+        while (pos < text.size() && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80) {
+            pos++;
+        }
+        count--;
+    }
+    return pos;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+
+// Frame-paced text animation. Instead of one sleep and flush per character,
+// text is revealed in batches at FRAME_MS intervals, and stdin is polled
+// between frames so any keypress finishes the animation at once.
+// Instant mode (DISPATCH_INSTANT_TEXT=1, or stdout not a terminal) prints
+// everything immediately for automated runs.
+class TextAnimator {
+public:
+    static void setInstant(bool instant);
+    static bool isInstant();
+
+    // Both return false if the user skipped
+    static bool play(const std::string& text, int msPerChar);
+    static bool wait(int milliseconds);
+
+    // A keypress inside a sequence also skips the rest of it (e.g. a cutscene)
+    static void beginSequence();
+    static void endSequence();
+    static bool isSkipping() { return skipping; }
+
+private:
+    static const int FRAME_MS;
+    static int instantMode; // -1 until resolved from the environment
+    static int sequenceDepth;
+    static bool skipping;
+
+    static bool keyPressedWithin(int milliseconds);
+    static bool skip();
+    static size_t advanceChars(const std::string& text, size_t pos, size_t count);
+};
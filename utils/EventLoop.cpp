@@ -0,0 +1,134 @@
+#include "EventLoop.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+const EventLoop::TimerId EventLoop::INVALID_TIMER = 0;
+
+EventLoop::EventLoop() : nextTimer(1), stopping(false) {}
+
+int64_t EventLoop::nowMs() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+EventLoop::TimerId EventLoop::addTimer(int64_t delayMs, Callback callback) {
+    TimerId id = nextTimer++;
+    timers[id] = move(callback);
+    deadlines.push_back({nowMs() + max<int64_t>(delayMs, 0), id});
+    push_heap(deadlines.begin(), deadlines.end(), greater<Deadline>());
+    return id;
+}
+
+bool EventLoop::cancelTimer(TimerId id) {
+    return timers.erase(id) > 0;
+}
+
+bool EventLoop::watchReadable(int fd, Callback callback) {
+#ifndef _WIN32
+    watches[fd] = move(callback);
+    return true;
+#else
+    (void)fd;
+    (void)callback;
+    return false;
+#endif
+}
+
+void EventLoop::unwatch(int fd) {
+    watches.erase(fd);
+}
+
+void EventLoop::post(Callback callback) {
+    posted.push_back(move(callback));
+}
+
+void EventLoop::runPosted() {
+    // Only what was queued before this pass; tasks posting tasks wait a turn
+    size_t count = posted.size();
+    for (size_t i = 0; i < count && !posted.empty(); i++) {
+        Callback task = move(posted.front());
+        posted.pop_front();
+        task();
+    }
+}
+
+void EventLoop::runExpiredTimers() {
+    int64_t now = nowMs();
+    while (!deadlines.empty() && deadlines.front().when <= now) {
+        TimerId id = deadlines.front().id;
+        pop_heap(deadlines.begin(), deadlines.end(), greater<Deadline>());
+        deadlines.pop_back();
+
+        auto it = timers.find(id);
+        if (it == timers.end()) continue; // Cancelled
+        Callback callback = move(it->second);
+        timers.erase(it);
+        callback();
+    }
+}
+
+int64_t EventLoop::nextTimeout(int64_t maxWaitMs) {
+    if (!posted.empty()) return 0;
+
+    // Drop cancelled timers from the top so they don't cut the wait short
+    while (!deadlines.empty() && !timers.count(deadlines.front().id)) {
+        pop_heap(deadlines.begin(), deadlines.end(), greater<Deadline>());
+        deadlines.pop_back();
+    }
+    if (deadlines.empty()) return maxWaitMs;
+
+    int64_t untilTimer = max<int64_t>(deadlines.front().when - nowMs(), 0);
+    return maxWaitMs < 0 ? untilTimer : min(untilTimer, maxWaitMs);
+}
+
+void EventLoop::pollWatches(int64_t timeoutMs) {
+#ifndef _WIN32
+    vector<pollfd> fds;
+    fds.reserve(watches.size());
+    for (const auto& watch : watches) {
+        fds.push_back({watch.first, POLLIN, 0});
+    }
+
+    int ready = poll(fds.data(), fds.size(), timeoutMs < 0 ? -1 : static_cast<int>(min<int64_t>(timeoutMs, INT32_MAX)));
+    if (ready <= 0) return; // Timeout, or EINTR - the caller loops either way
+
+    for (const pollfd& fd : fds) {
+        if (!(fd.revents & (POLLIN | POLLHUP | POLLERR))) continue;
+        // A previous callback may have unwatched or replaced this fd
+        auto it = watches.find(fd.fd);
+        if (it == watches.end()) continue;
+        Callback callback = it->second;
+        callback();
+    }
+#else
+    if (timeoutMs > 0) this_thread::sleep_for(chrono::milliseconds(timeoutMs));
+#endif
+}
+
+bool EventLoop::runOnce(int64_t maxWaitMs) {
+    runPosted();
+    runExpiredTimers();
+
+    int64_t timeout = nextTimeout(maxWaitMs);
+    if (watches.empty()) {
+        if (timeout < 0) return !posted.empty() || !timers.empty(); // Nothing could ever fire
+        if (timeout > 0) this_thread::sleep_for(chrono::milliseconds(timeout));
+    } else {
+        pollWatches(timeout);
+    }
+
+    runExpiredTimers();
+    return !posted.empty() || !timers.empty() || !watches.empty();
+}
+
+void EventLoop::run() {
+    stopping = false;
+    while (!stopping && runOnce()) {}
+}
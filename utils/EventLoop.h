@@ -0,0 +1,60 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+
+// Single-threaded reactor: timers, posted tasks and readable file
+// descriptors, all dispatched from run() on the calling thread. Callbacks
+// may add or cancel timers and watches freely, including their own.
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+    static const TimerId INVALID_TIMER;
+
+    EventLoop();
+
+    TimerId addTimer(int64_t delayMs, Callback callback);
+    bool cancelTimer(TimerId id);
+
+    // Level-triggered; one callback per fd. Not available on Windows.
+    bool watchReadable(int fd, Callback callback);
+    void unwatch(int fd);
+
+    // Runs on the next iteration, before timers and I/O
+    void post(Callback callback);
+
+    // One iteration; waits at most maxWaitMs (-1 = until the next timer).
+    // Returns false once there is nothing left to wait for.
+    bool runOnce(int64_t maxWaitMs = -1);
+    // Until stop() or nothing is pending
+    void run();
+    void stop() { stopping = true; }
+
+    size_t pendingTimers() const { return timers.size(); }
+    static int64_t nowMs();
+
+private:
+    struct Deadline {
+        int64_t when;
+        TimerId id;
+        bool operator>(const Deadline& other) const {
+            return when != other.when ? when > other.when : id > other.id;
+        }
+    };
+
+    std::vector<Deadline> deadlines; // Min-heap; cancelled ids are skipped lazily
+    std::unordered_map<TimerId, Callback> timers;
+    std::map<int, Callback> watches;
+    std::deque<Callback> posted;
+    TimerId nextTimer;
+    bool stopping;
+
+    void runPosted();
+    void runExpiredTimers();
+    int64_t nextTimeout(int64_t maxWaitMs);
+    void pollWatches(int64_t timeoutMs);
+};
@@ -0,0 +1,35 @@
+#include "MessageLog.h"
+
+using namespace std;
+
+void MessageLog::reserve(size_t messages, size_t bytes) {
+    ends.reserve(messages);
+    text.reserve(bytes);
+}
+
+void MessageLog::append(string_view message) {
+    text.append(message);
+    ends.push_back(text.size());
+}
+
+void MessageLog::assign(const vector<string>& messages) {
+    clear();
+    for (const string& message : messages) append(message);
+}
+
+void MessageLog::clear() {
+    text.clear();
+    ends.clear();
+}
+
+string_view MessageLog::operator[](size_t index) const {
+    size_t begin = index == 0 ? 0 : ends[index - 1];
+    return string_view(text).substr(begin, ends[index] - begin);
+}
+
+vector<string> MessageLog::toVector() const {
+    vector<string> messages;
+    messages.reserve(size());
+    for (size_t i = 0; i < size(); i++) messages.emplace_back((*this)[i]);
+    return messages;
+}
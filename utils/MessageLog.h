@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// Messages kept back to back in one buffer, for histories that only grow.
+// Appending copies the text in, so once reserve() has room for an episode a
+// turn's append never touches the heap; a vector<string> would allocate for
+// every message past the small-string size.
+class MessageLog {
+public:
+    void reserve(size_t messages, size_t bytes);
+    void append(std::string_view message);
+    void assign(const std::vector<std::string>& messages);
+    void clear();
+
+    size_t size() const { return ends.size(); }
+    bool empty() const { return ends.empty(); }
+    std::string_view operator[](size_t index) const; // Valid until the next append
+    std::vector<std::string> toVector() const;
+
+private:
+    std::string text;
+    std::vector<size_t> ends; // One past each message's last byte
+};
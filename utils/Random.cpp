@@ -25,4 +25,37 @@ double Random::getDouble(double min, double max) {
 bool Random::getBool(double probability) {
     std::bernoulli_distribution dist(probability);
     return dist(getLocalGenerator());
+}
+
+RandomStream::RandomStream(uint64_t seedValue) {
+    seed(seedValue);
+}
+
+void RandomStream::seed(uint64_t seedValue) {
+    // SplitMix64 scrambles the seed so nearby seeds give unrelated streams
+    uint64_t z = seedValue + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    setState(z ^ (z >> 31));
+}
+
+uint64_t RandomStream::next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+int RandomStream::getInt(int min, int max) {
+    if (max <= min) return min;
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>(next() % range));
+}
+
+double RandomStream::getDouble(double min, double max) {
+    return min + (next() >> 11) * (1.0 / 9007199254740992.0) * (max - min);
+}
+
+bool RandomStream::getBool(double probability) {
+    return getDouble(0.0, 1.0) < probability;
 }
\ No newline at end of file
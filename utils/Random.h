@@ -1,6 +1,7 @@
 #pragma once
 #include <random>
 #include <chrono>
+#include <cstdint>
 
 class Random {
 private:
@@ -12,4 +13,30 @@ public:
     static int getInt(int min, int max);
     static double getDouble(double min, double max);
     static bool getBool(double probability = 0.5);
+};
+
+// Small, copyable generator (xorshift64*) for code that needs its own
+// reproducible stream - per-game or per-thread - instead of the shared one.
+// Satisfies UniformRandomBitGenerator, so it also works with <algorithm>.
+class RandomStream {
+public:
+    using result_type = uint64_t;
+    
+    explicit RandomStream(uint64_t seed = 0x9E3779B97F4A7C15ULL);
+    
+    void seed(uint64_t seed);
+    uint64_t getState() const { return state; }
+    void setState(uint64_t newState) { state = newState ? newState : 1; }
+    
+    uint64_t next();
+    int getInt(int min, int max);
+    double getDouble(double min, double max);
+    bool getBool(double probability = 0.5);
+    
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+    result_type operator()() { return next(); }
+    
+private:
+    uint64_t state;
 };
\ No newline at end of file
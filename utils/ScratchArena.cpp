@@ -0,0 +1,25 @@
+#include "ScratchArena.h"
+
+using namespace std;
+
+const size_t ScratchArena::DEFAULT_CAPACITY = 64 * 1024;
+
+ScratchArena::ScratchArena(size_t capacity)
+    : capacity(capacity), buffer(new byte[capacity]),
+      bump(buffer.get(), capacity, pmr::new_delete_resource()), depth(0) {}
+
+ScratchArena& ScratchArena::local() {
+    thread_local ScratchArena arena(DEFAULT_CAPACITY);
+    return arena;
+}
+
+ScratchArena::Scope::Scope() : arena(local()) {
+    arena.depth++;
+}
+
+ScratchArena::Scope::~Scope() {
+    if (--arena.depth == 0) {
+        // Back to the start of the buffer; heap overflow chunks are freed
+        arena.bump.release();
+    }
+}
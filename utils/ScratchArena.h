@@ -0,0 +1,52 @@
+#pragma once
+#include <memory_resource>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstddef>
+
+template <typename T>
+using ScratchVector = std::pmr::vector<T>;
+using ScratchString = std::pmr::string;
+
+// Per-thread bump allocator for a turn's temporaries - tokens, split words,
+// sentence lists. Allocating is a pointer bump into a buffer kept for the
+// thread's lifetime; nothing is freed until the outermost Scope closes and
+// the arena rewinds. A turn that outgrows the buffer spills to the heap
+// (released on rewind), so it still works, just not allocation-free.
+//
+// Open a Scope around any use. Turn loops open one per turn so the whole
+// turn shares one rewind; a function called outside any turn rewinds on
+// its own. Scratch containers must not outlive the Scope they were made in.
+class ScratchArena {
+public:
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        std::pmr::memory_resource* resource() const { return arena.resource(); }
+
+    private:
+        ScratchArena& arena;
+    };
+
+    static ScratchArena& local();
+
+    std::pmr::memory_resource* resource() { return &bump; }
+    size_t getCapacity() const { return capacity; }
+
+    static const size_t DEFAULT_CAPACITY;
+
+private:
+    explicit ScratchArena(size_t capacity);
+
+    size_t capacity;
+    std::unique_ptr<std::byte[]> buffer;
+    std::pmr::monotonic_buffer_resource bump;
+    int depth;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Each side caches the other's index so the common case touches
+// only its own cache line. Capacity is rounded up to a power of two.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : head(0), cachedTail(0), tail(0), cachedHead(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded <<= 1;
+        slots.resize(rounded);
+        mask = rounded - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool tryPush(T&& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead > mask) return false;
+        }
+        slots[position & mask] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T value) {
+        while (!tryPush(std::move(value))) std::this_thread::yield();
+    }
+
+    // Consumer side
+    bool tryPop(T& out) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position == cachedTail) return false;
+        }
+        out = std::move(slots[position & mask]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    void pop(T& out) {
+        while (!tryPop(out)) std::this_thread::yield();
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head; // Next slot to read
+    size_t cachedTail;                    // Consumer's last view of tail
+    alignas(64) std::atomic<size_t> tail; // Next slot to write
+    size_t cachedHead;                    // Producer's last view of head
+};
@@ -0,0 +1,148 @@
+#include "Trace.h"
+#include "../data/StreamingStats.h"
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+
+using namespace std;
+
+const size_t Trace::RING_CAPACITY = 1 << 16;
+
+namespace {
+
+struct Ring {
+    vector<Trace::Event> events; // Allocated on the thread's first span
+    uint64_t written = 0;
+    uint32_t thread = 0;
+};
+
+// Rings outlive their threads so a worker's spans can be exported after it joins
+mutex registryMutex;
+vector<shared_ptr<Ring>> registry;
+
+Ring& localRing() {
+    thread_local shared_ptr<Ring> ring;
+    if (!ring) {
+        ring = make_shared<Ring>();
+        ring->events.resize(Trace::RING_CAPACITY);
+        lock_guard<mutex> lock(registryMutex);
+        ring->thread = static_cast<uint32_t>(registry.size() + 1);
+        registry.push_back(ring);
+    }
+    return *ring;
+}
+
+string escapeJson(const char* text) {
+    string escaped;
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(*c) < 0x20) continue;
+        escaped += *c;
+    }
+    return escaped;
+}
+
+}
+
+bool Trace::isCompiledIn() {
+#ifdef DISPATCH_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t Trace::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* name, uint64_t startNs, uint64_t durationNs) {
+    Ring& ring = localRing();
+    Event& event = ring.events[ring.written % RING_CAPACITY];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.thread = ring.thread;
+    ring.written++;
+}
+
+vector<Trace::Event> Trace::snapshot() {
+    vector<Event> events;
+    lock_guard<mutex> lock(registryMutex);
+    for (const auto& ring : registry) {
+        size_t kept = static_cast<size_t>(min<uint64_t>(ring->written, RING_CAPACITY));
+        events.insert(events.end(), ring->events.begin(), ring->events.begin() + kept);
+    }
+    sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.startNs < b.startNs; });
+    return events;
+}
+
+void Trace::clear() {
+    lock_guard<mutex> lock(registryMutex);
+    for (auto& ring : registry) ring->written = 0;
+}
+
+bool Trace::writeChromeJson(const string& path) {
+    vector<Event> events = snapshot();
+    uint64_t origin = events.empty() ? 0 : events.front().startNs;
+
+    ofstream out(path);
+    if (!out) return false;
+
+    // Complete ("X") events; timestamps are microseconds from the first span
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char numbers[64];
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& event = events[i];
+        snprintf(numbers, sizeof(numbers), "%.3f,\"dur\":%.3f",
+                 (event.startNs - origin) / 1000.0, event.durationNs / 1000.0);
+        out << (i ? ",\n" : "\n") << "{\"name\":\"" << escapeJson(event.name)
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << numbers << "}";
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+vector<Trace::SpanSummary> Trace::summarize() {
+    map<string, MetricStats> byName;
+    for (const Event& event : snapshot()) {
+        byName[event.name].add(event.durationNs / 1000.0);
+    }
+
+    vector<SpanSummary> summaries;
+    for (const auto& entry : byName) {
+        const MetricStats& stats = entry.second;
+        SpanSummary summary;
+        summary.name = entry.first;
+        summary.count = stats.summary.getCount();
+        summary.totalUs = stats.summary.getMean() * summary.count;
+        summary.meanUs = stats.summary.getMean();
+        summary.p50Us = stats.distribution.percentile(50);
+        summary.p99Us = stats.distribution.percentile(99);
+        summary.maxUs = stats.summary.getMax();
+        summaries.push_back(summary);
+    }
+    sort(summaries.begin(), summaries.end(),
+         [](const SpanSummary& a, const SpanSummary& b) { return a.totalUs > b.totalUs; });
+    return summaries;
+}
+
+string Trace::formatSummary() {
+    ostringstream out;
+    out << left << setw(40) << "span" << right << setw(10) << "count" << setw(12) << "total ms"
+        << setw(10) << "mean us" << setw(10) << "p50 us" << setw(10) << "p99 us" << setw(10) << "max us" << "\n";
+    out << fixed;
+    for (const SpanSummary& summary : summarize()) {
+        out << left << setw(40) << summary.name << right << setw(10) << summary.count
+            << setw(12) << setprecision(2) << summary.totalUs / 1000.0
+            << setw(10) << setprecision(1) << summary.meanUs << setw(10) << summary.p50Us
+            << setw(10) << summary.p99Us << setw(10) << summary.maxUs << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Scoped timing spans for the turn's hot path. Compiled in only with
+// -DDISPATCH_TRACE (make TRACE=1); otherwise TRACE_SCOPE expands to nothing.
+// Each thread records into its own fixed-size ring, overwriting its oldest
+// spans, so recording takes no locks. Span names must be string literals.
+//
+// snapshot(), the exports and clear() read every thread's ring: call them
+// once traced work has stopped (after joining workers, at exit).
+class Trace {
+public:
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+        uint32_t thread;
+    };
+
+    struct SpanSummary {
+        std::string name;
+        uint64_t count;
+        double totalUs;
+        double meanUs;
+        double p50Us;
+        double p99Us;
+        double maxUs;
+    };
+
+    class Span {
+    public:
+        explicit Span(const char* name) : name(name), start(now()) {}
+        ~Span() { record(name, start, now() - start); }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name;
+        uint64_t start;
+    };
+
+    static bool isCompiledIn();
+    static uint64_t now(); // Steady clock, nanoseconds
+    static void record(const char* name, uint64_t startNs, uint64_t durationNs);
+
+    static std::vector<Event> snapshot(); // Retained spans of all threads, by start time
+    static void clear();
+
+    // chrome://tracing / Perfetto "traceEvents" format
+    static bool writeChromeJson(const std::string& path);
+    // Per span name, slowest total first
+    static std::vector<SpanSummary> summarize();
+    static std::string formatSummary();
+
+    static const size_t RING_CAPACITY; // Spans kept per thread
+};
+
+#ifdef DISPATCH_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Span TRACE_CONCAT(traceSpan, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
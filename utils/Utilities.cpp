@@ -4,6 +4,7 @@
 #include <thread>
 #include <iostream>
 #include <chrono>
+#include <charconv>
 
 using namespace std;
 
@@ -21,6 +22,41 @@ vector<string> Utilities::split(const string& str, char delimiter) {
     return tokens;
 }
 
+void Utilities::splitInto(string_view str, char delimiter, ScratchVector<string_view>& tokens) {
+    size_t start = 0;
+    while (start <= str.size()) {
+        size_t end = str.find(delimiter, start);
+        if (end == string_view::npos) end = str.size();
+        if (end > start) tokens.push_back(str.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+void Utilities::splitWordsInto(string_view str, ScratchVector<string_view>& words) {
+    size_t pos = 0;
+    while (pos < str.size()) {
+        while (pos < str.size() && isspace(static_cast<unsigned char>(str[pos]))) pos++;
+        size_t start = pos;
+        while (pos < str.size() && !isspace(static_cast<unsigned char>(str[pos]))) pos++;
+        if (pos > start) words.push_back(str.substr(start, pos - start));
+    }
+}
+
+string_view Utilities::trimView(string_view str) {
+    size_t start = str.find_first_not_of(" \t\n\r");
+    if (start == string_view::npos) return string_view();
+    size_t end = str.find_last_not_of(" \t\n\r");
+    return str.substr(start, end - start + 1);
+}
+
+bool Utilities::parseInt(string_view str, int& value) {
+    size_t pos = 0;
+    while (pos < str.size() && isspace(static_cast<unsigned char>(str[pos]))) pos++;
+    if (pos < str.size() && str[pos] == '+') pos++;
+    auto result = from_chars(str.data() + pos, str.data() + str.size(), value);
+    return result.ec == errc();
+}
+
 string Utilities::join(const vector<string>& tokens, const string& delimiter) {
     string result;
     for (size_t i = 0; i < tokens.size(); i++) {
@@ -1,17 +1,33 @@
 #pragma once
+#include "ScratchArena.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 
 class Utilities {
 public:
     static std::vector<std::string> split(const std::string& str, char delimiter);
+    // Allocation-free forms for per-turn code: the pieces are views into str
+    static void splitInto(std::string_view str, char delimiter, ScratchVector<std::string_view>& tokens);
+    static void splitWordsInto(std::string_view str, ScratchVector<std::string_view>& words); // Any whitespace
+    static std::string_view trimView(std::string_view str);
+    static bool parseInt(std::string_view str, int& value); // Leading integer, as stoi reads it, without throwing
     static std::string join(const std::vector<std::string>& tokens, const std::string& delimiter);
     static std::string trim(const std::string& str);
     static std::string toUpper(const std::string& str);
     static std::string toLower(const std::string& str);
     static bool contains(const std::string& str, const std::string& substring);
     static std::string replaceAll(std::string str, const std::string& from, const std::string& to);
+    template<typename String>
+    static void replaceAllInPlace(String& str, std::string_view from, std::string_view to) {
+        if (from.empty()) return;
+        size_t pos = 0;
+        while ((pos = str.find(from.data(), pos, from.size())) != String::npos) {
+            str.replace(pos, from.size(), to.data(), to.size());
+            pos += to.size();
+        }
+    }
     static bool startsWith(const std::string& str, const std::string& prefix);
     static bool endsWith(const std::string& str, const std::string& suffix);
     
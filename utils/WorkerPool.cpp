@@ -0,0 +1,86 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+using namespace std;
+
+WorkerPool::WorkerPool(int threads)
+    : job(nullptr), jobTotal(0), jobChunk(0), generation(0), remaining(0), stopping(false) {
+    resize(threads);
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::resize(int threads) {
+    threads = max(1, threads);
+    if (threads == getThreadCount()) return;
+
+    stop();
+    stopping = false;
+    for (int index = 1; index < threads; index++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this, index, generation);
+    }
+}
+
+void WorkerPool::run(int total, int maxThreads, const RangeFn& fn) {
+    if (total <= 0) return;
+
+    int threads = max(1, min(maxThreads, getThreadCount()));
+    if (threads == 1) {
+        fn(0, total);
+        return;
+    }
+
+    int chunk = (total + threads - 1) / threads;
+    {
+        lock_guard<mutex> lock(stateMutex);
+        job = &fn;
+        jobTotal = total;
+        jobChunk = chunk;
+        remaining = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    fn(0, min(total, chunk));
+
+    unique_lock<mutex> lock(stateMutex);
+    done.wait(lock, [this]() { return remaining == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::workerLoop(int index, uint64_t seen) {
+    // seen is the generation at creation, so a loop started before this
+    // thread first takes the lock is still picked up
+    unique_lock<mutex> lock(stateMutex);
+
+    while (true) {
+        wake.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+
+        // Workers past the loop's thread count get an empty range
+        const RangeFn* fn = job;
+        int begin = min(jobTotal, index * jobChunk);
+        int end = min(jobTotal, begin + jobChunk);
+
+        lock.unlock();
+        if (begin < end) (*fn)(begin, end);
+        lock.lock();
+
+        if (--remaining == 0) done.notify_one();
+    }
+}
+
+void WorkerPool::stop() {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
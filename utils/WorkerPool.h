@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+// Threads started once and reused for every parallel loop, so a caller that
+// steps thousands of times pays for thread creation only on resize. The
+// calling thread takes the first chunk itself; run() returns when all are done.
+class WorkerPool {
+public:
+    using RangeFn = std::function<void(int begin, int end)>;
+
+    explicit WorkerPool(int threads = 1); // Counts the calling thread
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void resize(int threads);
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Splits [0, total) into at most maxThreads contiguous chunks
+    void run(int total, int maxThreads, const RangeFn& fn);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const RangeFn* job;
+    int jobTotal;
+    int jobChunk;
+    uint64_t generation;
+    int remaining;
+    bool stopping;
+
+    void workerLoop(int index, uint64_t seen);
+    void stop();
+};